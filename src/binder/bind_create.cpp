@@ -21,6 +21,7 @@
 // THE SOFTWARE.
 //===----------------------------------------------------------------------===//
 
+#include <cstring>
 #include <iterator>
 #include <memory>
 #include <string>
@@ -130,7 +131,37 @@ auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<
     }
   }
 
-  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols));
+  auto index = std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols));
+  index->unique_ = stmt->unique;
+  if (stmt->options != nullptr) {
+    for (auto cell = stmt->options->head; cell != nullptr; cell = cell->next) {
+      auto option = reinterpret_cast<duckdb_libpgquery::PGDefElem *>(cell->data.ptr_value);
+      bool *flag;
+      if (strcmp(option->defname, "compression") == 0) {
+        flag = &index->compressed_;
+      } else if (strcmp(option->defname, "b_link") == 0) {
+        flag = &index->b_link_;
+      } else {
+        throw NotImplementedException(fmt::format("index option {} is not supported", option->defname));
+      }
+      // WITH (option), or option = true / false.
+      std::string value = "true";
+      if (option->arg != nullptr) {
+        if (option->arg->type != duckdb_libpgquery::T_PGString) {
+          throw bustub::Exception(fmt::format("index option {} takes true or false", option->defname));
+        }
+        value = reinterpret_cast<duckdb_libpgquery::PGValue *>(option->arg)->val.str;
+      }
+      if (value != "true" && value != "false") {
+        throw bustub::Exception(fmt::format("index option {} takes true or false", option->defname));
+      }
+      *flag = value == "true";
+    }
+  }
+  if (index->compressed_ && !index->b_link_) {
+    throw bustub::Exception("a compressed index is always a B-link tree");
+  }
+  return index;
 }
 
 }  // namespace bustub
@@ -721,6 +721,20 @@ auto Binder::BindAExpr(duckdb_libpgquery::PGAExpr *root) -> std::unique_ptr<Boun
   BUSTUB_ASSERT(root, "nullptr");
   auto name = std::string((reinterpret_cast<duckdb_libpgquery::PGValue *>(root->name->head->data.ptr_value))->val.str);
 
+  if (root->kind == duckdb_libpgquery::PG_AEXPR_BETWEEN || root->kind == duckdb_libpgquery::PG_AEXPR_NOT_BETWEEN) {
+    // x BETWEEN a AND b is (x >= a) AND (x <= b), x NOT BETWEEN a AND b is (x < a) OR (x > b).
+    auto bounds = reinterpret_cast<duckdb_libpgquery::PGList *>(root->rexpr);
+    BUSTUB_ASSERT(bounds != nullptr && bounds->length == 2, "BETWEEN takes two bounds");
+    auto lower = reinterpret_cast<duckdb_libpgquery::PGNode *>(bounds->head->data.ptr_value);
+    auto upper = reinterpret_cast<duckdb_libpgquery::PGNode *>(bounds->head->next->data.ptr_value);
+    const bool between = root->kind == duckdb_libpgquery::PG_AEXPR_BETWEEN;
+    auto lower_cmp = std::make_unique<BoundBinaryOp>(between ? ">=" : "<", BindExpression(root->lexpr),
+                                                     BindExpression(lower));
+    auto upper_cmp = std::make_unique<BoundBinaryOp>(between ? "<=" : ">", BindExpression(root->lexpr),
+                                                     BindExpression(upper));
+    return std::make_unique<BoundBinaryOp>(between ? "and" : "or", std::move(lower_cmp), std::move(upper_cmp));
+  }
+
   if (root->kind != duckdb_libpgquery::PG_AEXPR_OP) {
     throw bustub::Exception("unsupported op in AExpr");
   }
@@ -0,0 +1,163 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.cpp
+//
+// Identification: src/buffer/arc_replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/arc_replacer.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+void ARCReplacer::GhostList::PushFront(page_id_t page_id) {
+  Erase(page_id);
+  pages_.push_front(page_id);
+  index_[page_id] = pages_.begin();
+}
+
+void ARCReplacer::GhostList::PopBack() {
+  index_.erase(pages_.back());
+  pages_.pop_back();
+}
+
+auto ARCReplacer::GhostList::Erase(page_id_t page_id) -> bool {
+  auto it = index_.find(page_id);
+  if (it == index_.end()) {
+    return false;
+  }
+  pages_.erase(it->second);
+  index_.erase(it);
+  return true;
+}
+
+ARCReplacer::ARCReplacer(size_t num_frames) : replacer_size_(num_frames), frames_(num_frames) {}
+
+auto ARCReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock lock(latch_);
+  if (size_ == 0) {
+    return false;
+  }
+  auto from_recent = !t1_.empty() && t1_.size() > target_recent_size_;
+  auto victim = FindVictim(from_recent ? t1_ : t2_);
+  if (victim < 0) {
+    from_recent = !from_recent;
+    victim = FindVictim(from_recent ? t1_ : t2_);
+  }
+  BUSTUB_ASSERT(victim >= 0, "size_ counts an evictable frame that is in neither list");
+  auto page_id = frames_[victim].page_id_;
+  Untrack(victim);
+  if (page_id != INVALID_PAGE_ID) {
+    (from_recent ? b1_ : b2_).PushFront(page_id);
+    TrimGhosts();
+  }
+  *frame_id = victim;
+  return true;
+}
+
+void ARCReplacer::RecordAccess(frame_id_t frame_id, page_id_t page_id) {
+  CheckAndHandleFrameID(frame_id);
+  std::scoped_lock lock(latch_);
+  auto &frame = frames_[frame_id];
+  if (frame.list_ != ListType::NONE) {
+    // Hit: the frame is now frequently used.
+    (frame.list_ == ListType::RECENT ? t1_ : t2_).erase(frame.pos_);
+    t2_.push_front(frame_id);
+    frame.list_ = ListType::FREQUENT;
+    frame.pos_ = t2_.begin();
+    return;
+  }
+  // Miss: a page was loaded into the frame. A ghost hit adapts the target
+  // towards the list that should have kept the page.
+  auto list = ListType::RECENT;
+  if (page_id != INVALID_PAGE_ID && b1_.index_.count(page_id) > 0) {
+    auto delta = std::max<size_t>(b2_.Size() / b1_.Size(), 1);
+    target_recent_size_ = std::min(target_recent_size_ + delta, replacer_size_);
+    b1_.Erase(page_id);
+    list = ListType::FREQUENT;
+  } else if (page_id != INVALID_PAGE_ID && b2_.index_.count(page_id) > 0) {
+    auto delta = std::max<size_t>(b1_.Size() / b2_.Size(), 1);
+    target_recent_size_ = target_recent_size_ > delta ? target_recent_size_ - delta : 0;
+    b2_.Erase(page_id);
+    list = ListType::FREQUENT;
+  }
+  auto &target = list == ListType::RECENT ? t1_ : t2_;
+  target.push_front(frame_id);
+  // A new entry starts out evictable.
+  frame = FrameEntry{list, true, page_id, target.begin()};
+  ++size_;
+  TrimGhosts();
+}
+
+void ARCReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  CheckAndHandleFrameID(frame_id);
+  std::scoped_lock lock(latch_);
+  auto &frame = frames_[frame_id];
+  if (frame.list_ == ListType::NONE || frame.evictable_ == set_evictable) {
+    return;
+  }
+  frame.evictable_ = set_evictable;
+  if (set_evictable) {
+    ++size_;
+  } else {
+    --size_;
+  }
+}
+
+void ARCReplacer::Remove(frame_id_t frame_id) {
+  CheckAndHandleFrameID(frame_id);
+  std::scoped_lock lock(latch_);
+  if (frames_[frame_id].list_ == ListType::NONE) {
+    return;
+  }
+  if (!frames_[frame_id].evictable_) {
+    throw std::runtime_error("try to remove an inevitable frame.");
+  }
+  Untrack(frame_id);
+}
+
+auto ARCReplacer::Size() const -> size_t {
+  std::scoped_lock lock(latch_);
+  return size_;
+}
+
+auto ARCReplacer::GetTargetRecentSize() const -> size_t {
+  std::scoped_lock lock(latch_);
+  return target_recent_size_;
+}
+
+auto ARCReplacer::FindVictim(const std::list<frame_id_t> &list) const -> frame_id_t {
+  // Pinned frames were accessed when they were pinned, so they sit near the front.
+  for (auto it = list.rbegin(); it != list.rend(); ++it) {
+    if (frames_[*it].evictable_) {
+      return *it;
+    }
+  }
+  return -1;
+}
+
+void ARCReplacer::Untrack(frame_id_t frame_id) {
+  auto &frame = frames_[frame_id];
+  (frame.list_ == ListType::RECENT ? t1_ : t2_).erase(frame.pos_);
+  if (frame.evictable_) {
+    --size_;
+  }
+  frame = FrameEntry{};
+}
+
+void ARCReplacer::TrimGhosts() {
+  while (b1_.Size() > 0 && t1_.size() + b1_.Size() > replacer_size_) {
+    b1_.PopBack();
+  }
+  while (b2_.Size() > 0 && t1_.size() + t2_.size() + b1_.Size() + b2_.Size() > 2 * replacer_size_) {
+    b2_.PopBack();
+  }
+}
+
+}  // namespace bustub
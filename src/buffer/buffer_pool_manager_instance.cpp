@@ -12,6 +12,9 @@
 
 #include "buffer/buffer_pool_manager_instance.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "common/exception.h"
 #include "common/logger.h"
 #include "common/macros.h"
@@ -21,12 +24,29 @@ namespace bustub {
 // FIXME : Diskmanager log debug
 
 BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, size_t replacer_k,
-                                                     LogManager *log_manager)
-    : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager) {
+                                                     LogManager *log_manager, ReplacerPolicy policy)
+    : BufferPoolManagerInstance(pool_size, 1, 0, disk_manager, replacer_k, log_manager, policy) {}
+
+BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                                                     DiskManager *disk_manager, size_t replacer_k,
+                                                     LogManager *log_manager, ReplacerPolicy policy)
+    : pool_size_(pool_size),
+      num_instances_(num_instances),
+      instance_index_(instance_index),
+      next_page_id_(static_cast<page_id_t>(instance_index)),
+      disk_manager_(disk_manager),
+      disk_scheduler_(std::make_unique<DiskScheduler>(disk_manager)),
+      log_manager_(log_manager),
+      replacer_(MakeFrameReplacer(policy, pool_size, replacer_k)) {
+  BUSTUB_ASSERT(num_instances > 0, "If BPI is not part of a pool, then the pool size should just be 1");
+  BUSTUB_ASSERT(
+      instance_index < num_instances,
+      "BPI index cannot be greater than the number of BPIs in the pool. In non-parallel case, index should just be 1.");
   // we allocate a consecutive memory space for the buffer pool
   pages_ = new Page[pool_size_];
-  page_table_ = new ExtendibleHashTable<page_id_t, frame_id_t>(bucket_size_);
-  replacer_ = new LRUKReplacer(pool_size, replacer_k);
+  page_table_ = new PageTable(pool_size_);
+  frame_io_in_flight_ = std::make_unique<bool[]>(pool_size_);
+  frame_latches_ = std::make_unique<std::mutex[]>(pool_size_);
 
   // Initially, every page is in the free list.
   for (size_t i = 0; i < pool_size_; ++i) {
@@ -35,87 +55,128 @@ BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManag
 }
 
 BufferPoolManagerInstance::~BufferPoolManagerInstance() {
+  StopPageCleaner();
+  // Outstanding read-ahead still writes into the frames.
+  for (auto &[frame_id, future] : prefetching_) {
+    future.wait();
+  }
   delete[] pages_;
   delete page_table_;
-  delete replacer_;
 }
 
 auto BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) -> Page * {
-  std::scoped_lock lock(latch_);
+  return NewPgWithStrategyImp(page_id, nullptr);
+}
+
+auto BufferPoolManagerInstance::NewPgWithStrategyImp(page_id_t *page_id, BufferAccessStrategy *strategy) -> Page * {
+  std::unique_lock lock(latch_);
   auto frame_id = static_cast<frame_id_t>(0);
+  auto evicted_page_id = static_cast<page_id_t>(INVALID_PAGE_ID);
   auto page = static_cast<Page *>(nullptr);
   auto next_page_id = static_cast<page_id_t>(0);
-  if (free_list_.empty()) {
-    if (!replacer_->Evict(&frame_id)) {
-      return nullptr;
-    }
-  } else {
-    frame_id = free_list_.front();
-    free_list_.pop_front();
+  if (!AcquireFrame(&frame_id, &evicted_page_id, strategy)) {
+    return nullptr;
   }
   page = &pages_[frame_id];
-  page_table_->Remove(page->page_id_);
   next_page_id = AllocatePage();
-  replacer_->RecordAccess(frame_id);
+  AddToRing(strategy, frame_id, next_page_id);
+  replacer_->RecordAccess(frame_id, next_page_id);
   replacer_->SetEvictable(frame_id, false);
-  page_table_->Insert(next_page_id, frame_id);
-
-  if (page->is_dirty_) {
-    disk_manager_->WritePage(page->page_id_, page->data_);
+  {
+    std::scoped_lock frame_lock(frame_latches_[frame_id]);
+    page->pin_count_ = 1;
   }
+
+  // The new page is only published in the page table once the old content has
+  // left the frame, so nobody can observe it half written back.
+  DoFrameIO(lock, frame_id, evicted_page_id, INVALID_PAGE_ID);
   page->ResetMemory();
-  page->page_id_ = next_page_id;
-  page->pin_count_ = 1;
-  page->is_dirty_ = false;
+  {
+    std::scoped_lock frame_lock(frame_latches_[frame_id]);
+    page->page_id_ = next_page_id;
+    page->is_dirty_ = false;
+  }
+  page_table_->Insert(next_page_id, frame_id);
   *page_id = next_page_id;
   return page;
 }
 
 auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) -> Page * {
-  std::scoped_lock lock(latch_);
-  auto found_frame = false;
+  return FetchPgWithStrategyImp(page_id, nullptr);
+}
+
+auto BufferPoolManagerInstance::FetchPgWithStrategyImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * {
+  auto page = TryPinResident(page_id, strategy);
+  if (page != nullptr) {
+    return page;
+  }
+  std::unique_lock lock(latch_);
   auto frame_id = static_cast<frame_id_t>(0);
-  auto page = static_cast<Page *>(nullptr);
+  auto evicted_page_id = static_cast<page_id_t>(INVALID_PAGE_ID);
 
-  found_frame = page_table_->Find(page_id, frame_id);
-  if (!found_frame) {
-    if (free_list_.empty()) {
-      found_frame = false;
-    } else {
-      frame_id = free_list_.front();
-      free_list_.pop_front();
-      found_frame = true;
-    }
-  } else {
+  // A just evicted copy of the page may still be on its way to the disk. So
+  // may the page cleaner's copy of a page that was evicted clean.
+  io_done_cv_.wait(lock, [this, page_id, &frame_id] {
+    return pages_writing_back_.count(page_id) == 0 &&
+           (pages_cleaning_.count(page_id) == 0 || page_table_->Find(page_id, frame_id));
+  });
+  if (page_table_->Find(page_id, frame_id)) {
     page = &pages_[frame_id];
-    page->pin_count_++;
-    replacer_->SetEvictable(frame_id, false);
-    replacer_->RecordAccess(frame_id);
+    {
+      std::scoped_lock frame_lock(frame_latches_[frame_id]);
+      page->pin_count_++;
+      replacer_->SetEvictable(frame_id, false);
+      // A bulk operation touching a page does not make it any hotter.
+      if (strategy == nullptr || !strategy->IsActive()) {
+        replacer_->RecordAccess(frame_id, page_id);
+      }
+    }
+    // Another fetcher may still be reading the page in.
+    WaitFrameIO(lock, frame_id);
     return page;
   }
-  if (!found_frame) {
-    if (!replacer_->Evict(&frame_id)) {
-      return nullptr;
-    }
-    page_table_->Remove(pages_[frame_id].page_id_);
-    if (pages_[frame_id].is_dirty_) {
-      disk_manager_->WritePage(pages_[frame_id].page_id_, pages_[frame_id].data_);
-    }
+  if (!AcquireFrame(&frame_id, &evicted_page_id, strategy)) {
+    return nullptr;
   }
   page = &pages_[frame_id];
-  replacer_->RecordAccess(frame_id);
+  AddToRing(strategy, frame_id, page_id);
+  replacer_->RecordAccess(frame_id, page_id);
   replacer_->SetEvictable(frame_id, false);
+  {
+    // Marked in flight before it is published, so a hit waits for the read.
+    std::scoped_lock frame_lock(frame_latches_[frame_id]);
+    page->page_id_ = page_id;
+    page->is_dirty_ = false;
+    page->pin_count_ = 1;
+    frame_io_in_flight_[frame_id] = true;
+  }
   page_table_->Insert(page_id, frame_id);
 
-  disk_manager_->ReadPage(page_id, page->data_);
-  page->page_id_ = page_id;
-  page->is_dirty_ = false;
-  page->pin_count_ = 1;
+  DoFrameIO(lock, frame_id, evicted_page_id, page_id);
+  return page;
+}
+
+auto BufferPoolManagerInstance::TryPinResident(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * {
+  auto frame_id = static_cast<frame_id_t>(0);
+  if (!page_table_->Find(page_id, frame_id)) {
+    return nullptr;
+  }
+  auto page = &pages_[frame_id];
+  std::scoped_lock frame_lock(frame_latches_[frame_id]);
+  // The frame may have been given to another page since the lookup, or may still be waiting for its data.
+  if (page->page_id_ != page_id || frame_io_in_flight_[frame_id]) {
+    return nullptr;
+  }
+  page->pin_count_++;
+  // AcquireFrame() may have just evicted the frame, then it sees the pin and tracks the frame again.
+  if (strategy == nullptr || !strategy->IsActive()) {
+    replacer_->RecordAccess(frame_id, page_id);
+  }
+  replacer_->SetEvictable(frame_id, false);
   return page;
 }
 
 auto BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool {
-  std::scoped_lock lock(latch_);
   auto page = static_cast<Page *>(nullptr);
   auto frame_id = static_cast<frame_id_t>(0);
   if (page_table_->Find(page_id, frame_id)) {
@@ -123,8 +184,10 @@ auto BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) ->
   } else {
     return false;
   }
+  // A pinned page stays in its frame, so the frame latch is enough.
+  std::scoped_lock frame_lock(frame_latches_[frame_id]);
   auto res = false;
-  if (page->pin_count_ > 0) {
+  if (page->page_id_ == page_id && page->pin_count_ > 0) {
     page->pin_count_--;
     if (is_dirty) {
       page->is_dirty_ = true;
@@ -138,7 +201,7 @@ auto BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) ->
 }
 
 auto BufferPoolManagerInstance::FlushPgImp(page_id_t page_id) -> bool {
-  std::scoped_lock lock(latch_);
+  std::unique_lock lock(latch_);
   if (page_id == INVALID_PAGE_ID) {
     return false;
   }
@@ -146,34 +209,67 @@ auto BufferPoolManagerInstance::FlushPgImp(page_id_t page_id) -> bool {
   auto found_page = false;
   auto page = static_cast<Page *>(nullptr);
   found_page = page_table_->Find(page_id, frame_id);
+  // The write must not be overtaken by an older copy the page cleaner is still writing.
+  while (found_page && (frame_io_in_flight_[frame_id] || pages_cleaning_.count(page_id) > 0)) {
+    WaitFrameIO(lock, frame_id);
+    io_done_cv_.wait(lock, [this, page_id] { return pages_cleaning_.count(page_id) == 0; });
+    found_page = page_table_->Find(page_id, frame_id);
+  }
   if (!found_page) {
     return false;
   }
   page = &pages_[frame_id];
-  disk_manager_->WritePage(page->page_id_, page->data_);
+  // An unpin marking the page dirty again has to wait for the write.
+  std::scoped_lock frame_lock(frame_latches_[frame_id]);
+  SchedulePageIO(true, page->page_id_, page->data_).get();
   page->is_dirty_ = false;
   return true;
 }
 
 void BufferPoolManagerInstance::FlushAllPgsImp() {
-  std::scoped_lock lock(latch_);
+  std::unique_lock lock(latch_);
+  io_done_cv_.wait(lock, [this] { return pages_cleaning_.empty(); });
+  for (frame_id_t frame_id = 0; static_cast<size_t>(frame_id) < pool_size_; ++frame_id) {
+    WaitFrameIO(lock, frame_id);
+  }
+  // Issue every write as one batch so they are all in flight at once.
+  std::vector<DiskRequest> requests;
+  std::vector<std::future<bool>> futures;
+  requests.reserve(pool_size_);
+  futures.reserve(pool_size_);
   for (frame_id_t frame_id = 0; static_cast<size_t>(frame_id) < pool_size_; ++frame_id) {
     auto page = &pages_[frame_id];
-    disk_manager_->WritePage(page->page_id_, page->data_);
+    if (page->page_id_ == INVALID_PAGE_ID) {
+      continue;
+    }
+    auto promise = disk_scheduler_->CreatePromise();
+    futures.emplace_back(promise.get_future());
+    requests.push_back({true, page->data_, page->page_id_, std::move(promise)});
+    std::scoped_lock frame_lock(frame_latches_[frame_id]);
     page->is_dirty_ = false;
   }
+  disk_scheduler_->Schedule(std::move(requests));
+  for (auto &future : futures) {
+    future.get();
+  }
 }
 
 auto BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) -> bool {
-  std::scoped_lock lock(latch_);
+  std::unique_lock lock(latch_);
   auto frame_id = static_cast<frame_id_t>(0);
   auto found_page = false;
   auto page = static_cast<Page *>(nullptr);
   found_page = page_table_->Find(page_id, frame_id);
+  // An unpinned page may still be read ahead into its frame.
+  while (found_page && frame_io_in_flight_[frame_id]) {
+    WaitFrameIO(lock, frame_id);
+    found_page = page_table_->Find(page_id, frame_id);
+  }
   if (!found_page) {
     return true;
   }
   page = &pages_[frame_id];
+  std::scoped_lock frame_lock(frame_latches_[frame_id]);
   if (page->pin_count_ > 0) {
     return false;
   }
@@ -182,9 +278,318 @@ auto BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) -> bool {
   replacer_->Remove(frame_id);
   free_list_.push_front(frame_id);
   page->ResetMemory();
+  // FlushAllPgsImp() must not write the stale frame over the page later on.
+  page->page_id_ = INVALID_PAGE_ID;
+  page->is_dirty_ = false;
   return true;
 }
 
-auto BufferPoolManagerInstance::AllocatePage() -> page_id_t { return next_page_id_++; }
+void BufferPoolManagerInstance::PrefetchPgsImp(const std::vector<page_id_t> &page_ids,
+                                               BufferAccessStrategy *strategy) {
+  std::unique_lock lock(latch_);
+  std::vector<DiskRequest> requests;
+  requests.reserve(page_ids.size());
+  for (auto page_id : page_ids) {
+    auto frame_id = static_cast<frame_id_t>(0);
+    auto evicted_page_id = static_cast<page_id_t>(INVALID_PAGE_ID);
+    if (page_id == INVALID_PAGE_ID || page_table_->Find(page_id, frame_id) || pages_writing_back_.count(page_id) > 0 ||
+        pages_cleaning_.count(page_id) > 0) {
+      continue;
+    }
+    if (!AcquireFrame(&frame_id, &evicted_page_id, strategy)) {
+      break;
+    }
+    if (evicted_page_id != INVALID_PAGE_ID) {
+      // Like NewPgImp(), the page is only published once the dirty victim has left the frame.
+      DoFrameIO(lock, frame_id, evicted_page_id, INVALID_PAGE_ID);
+      auto existing_frame_id = static_cast<frame_id_t>(0);
+      if (page_table_->Find(page_id, existing_frame_id) || pages_writing_back_.count(page_id) > 0) {
+        // Somebody fetched the page while the latch was released.
+        free_list_.push_back(frame_id);
+        continue;
+      }
+    }
+    auto page = &pages_[frame_id];
+    AddToRing(strategy, frame_id, page_id);
+    replacer_->RecordAccess(frame_id, page_id);
+    replacer_->SetEvictable(frame_id, false);
+    {
+      std::scoped_lock frame_lock(frame_latches_[frame_id]);
+      page->page_id_ = page_id;
+      page->is_dirty_ = false;
+      page->pin_count_ = 0;
+      frame_io_in_flight_[frame_id] = true;
+    }
+    page_table_->Insert(page_id, frame_id);
+    auto promise = disk_scheduler_->CreatePromise();
+    prefetching_.emplace(frame_id, promise.get_future());
+    requests.push_back({false, page->data_, page_id, std::move(promise)});
+  }
+  disk_scheduler_->Schedule(std::move(requests));
+}
+
+void BufferPoolManagerInstance::CompletePrefetch(std::unique_lock<std::mutex> &lock, frame_id_t frame_id) {
+  auto it = prefetching_.find(frame_id);
+  if (it == prefetching_.end()) {
+    return;
+  }
+  // Everybody else arriving meanwhile waits on io_done_cv_ for the flag.
+  auto future = std::move(it->second);
+  prefetching_.erase(it);
+  lock.unlock();
+  future.wait();
+  lock.lock();
+  FinishPrefetch(frame_id);
+}
+
+void BufferPoolManagerInstance::ReapPrefetches() {
+  for (auto it = prefetching_.begin(); it != prefetching_.end();) {
+    if (it->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+      ++it;
+      continue;
+    }
+    auto frame_id = it->first;
+    it = prefetching_.erase(it);
+    FinishPrefetch(frame_id);
+  }
+}
+
+void BufferPoolManagerInstance::FinishPrefetch(frame_id_t frame_id) {
+  {
+    std::scoped_lock frame_lock(frame_latches_[frame_id]);
+    frame_io_in_flight_[frame_id] = false;
+    if (pages_[frame_id].pin_count_ == 0) {
+      replacer_->SetEvictable(frame_id, true);
+    }
+  }
+  io_done_cv_.notify_all();
+}
+
+auto BufferPoolManagerInstance::AcquireFrame(frame_id_t *frame_id, page_id_t *evicted_page_id,
+                                             BufferAccessStrategy *strategy) -> bool {
+  *evicted_page_id = INVALID_PAGE_ID;
+  if (strategy != nullptr) {
+    strategy->num_misses_++;
+  }
+  if (strategy != nullptr && strategy->IsActive()) {
+    // Recycle the oldest frame of the ring, unless it has been pinned or
+    // replaced by somebody else since the operation loaded it.
+    const auto &slot = strategy->ring_[strategy->next_slot_];
+    auto page = &pages_[slot.frame_id_];
+    if (slot.owner_ == this) {
+      std::scoped_lock frame_lock(frame_latches_[slot.frame_id_]);
+      if (page->page_id_ == slot.page_id_ && page->pin_count_ == 0 && !frame_io_in_flight_[slot.frame_id_] &&
+          prefetching_.count(slot.frame_id_) == 0) {
+        *frame_id = slot.frame_id_;
+        replacer_->Remove(*frame_id);
+        ReleaseFrame(*frame_id, evicted_page_id);
+        return true;
+      }
+    }
+  }
+  if (!free_list_.empty()) {
+    *frame_id = free_list_.front();
+    free_list_.pop_front();
+    return true;
+  }
+  // Read-ahead that has landed in the meantime becomes evictable.
+  ReapPrefetches();
+  while (true) {
+    if (!replacer_->Evict(frame_id)) {
+      return false;
+    }
+    auto page = &pages_[*frame_id];
+    std::scoped_lock frame_lock(frame_latches_[*frame_id]);
+    if (page->pin_count_ > 0) {
+      // A hit pinned the page after the replacer picked it. Track it again and look for another victim.
+      replacer_->RecordAccess(*frame_id, page->page_id_);
+      replacer_->SetEvictable(*frame_id, false);
+      continue;
+    }
+    ReleaseFrame(*frame_id, evicted_page_id);
+    // This miss pays for a write the page cleaner should have done.
+    if (*evicted_page_id != INVALID_PAGE_ID && cleaner_running_) {
+      cleaner_wakeup_ = true;
+      cleaner_cv_.notify_one();
+    }
+    return true;
+  }
+}
+
+void BufferPoolManagerInstance::ReleaseFrame(frame_id_t frame_id, page_id_t *evicted_page_id) {
+  auto page = &pages_[frame_id];
+  page_table_->Remove(page->page_id_);
+  if (page->is_dirty_) {
+    *evicted_page_id = page->page_id_;
+    pages_writing_back_.insert(page->page_id_);
+    page->is_dirty_ = false;
+  }
+  // Hits that found the frame through the page table before the removal see that it moved on.
+  page->page_id_ = INVALID_PAGE_ID;
+}
+
+void BufferPoolManagerInstance::AddToRing(BufferAccessStrategy *strategy, frame_id_t frame_id, page_id_t page_id) {
+  if (strategy == nullptr || !strategy->IsActive()) {
+    return;
+  }
+  strategy->ring_[strategy->next_slot_] = {this, frame_id, page_id};
+  strategy->next_slot_ = (strategy->next_slot_ + 1) % strategy->ring_.size();
+}
+
+void BufferPoolManagerInstance::DoFrameIO(std::unique_lock<std::mutex> &lock, frame_id_t frame_id,
+                                          page_id_t evicted_page_id, page_id_t read_page_id) {
+  auto page = &pages_[frame_id];
+  {
+    std::scoped_lock frame_lock(frame_latches_[frame_id]);
+    frame_io_in_flight_[frame_id] = true;
+  }
+  if (evicted_page_id != INVALID_PAGE_ID) {
+    // An older copy written by the page cleaner must not land after this one.
+    io_done_cv_.wait(lock, [this, evicted_page_id] { return pages_cleaning_.count(evicted_page_id) == 0; });
+  }
+  lock.unlock();
+  // The read reuses the buffer of the write-back, so it may only be issued once the write has completed.
+  if (evicted_page_id != INVALID_PAGE_ID) {
+    SchedulePageIO(true, evicted_page_id, page->data_).get();
+  }
+  if (read_page_id != INVALID_PAGE_ID) {
+    SchedulePageIO(false, read_page_id, page->data_).get();
+  }
+  lock.lock();
+  {
+    std::scoped_lock frame_lock(frame_latches_[frame_id]);
+    frame_io_in_flight_[frame_id] = false;
+  }
+  if (evicted_page_id != INVALID_PAGE_ID) {
+    pages_writing_back_.erase(evicted_page_id);
+  }
+  io_done_cv_.notify_all();
+}
+
+void BufferPoolManagerInstance::RunPageCleaner(double clean_fraction) {
+  std::scoped_lock lock(latch_);
+  if (cleaner_running_) {
+    return;
+  }
+  clean_fraction_ = clean_fraction;
+  cleaner_running_ = true;
+  cleaner_buffers_.resize(PAGE_CLEANER_BATCH_PAGES);
+  cleaner_thread_ = std::thread(&BufferPoolManagerInstance::RunCleaner, this);
+}
+
+void BufferPoolManagerInstance::StopPageCleaner() {
+  {
+    std::scoped_lock lock(latch_);
+    if (!cleaner_running_) {
+      return;
+    }
+    cleaner_running_ = false;
+    cleaner_cv_.notify_one();
+  }
+  cleaner_thread_.join();
+}
+
+auto BufferPoolManagerInstance::GetNumCleanFrames() -> size_t {
+  std::scoped_lock lock(latch_);
+  return CountCleanFrames();
+}
+
+void BufferPoolManagerInstance::RunCleaner() {
+  while (true) {
+    {
+      std::unique_lock lock(latch_);
+      cleaner_cv_.wait_for(lock, PAGE_CLEANER_INTERVAL, [this] { return !cleaner_running_ || cleaner_wakeup_; });
+      if (!cleaner_running_) {
+        return;
+      }
+      cleaner_wakeup_ = false;
+    }
+    // A full batch means there may be more to do.
+    while (CleanPages() == cleaner_buffers_.size()) {
+    }
+  }
+}
+
+auto BufferPoolManagerInstance::CleanPages() -> size_t {
+  std::unique_lock lock(latch_);
+  auto target = static_cast<size_t>(clean_fraction_ * static_cast<double>(pool_size_));
+  auto num_clean = CountCleanFrames();
+  if (!cleaner_running_ || num_clean >= target) {
+    return 0;
+  }
+  std::vector<std::pair<page_id_t, frame_id_t>> dirty_frames;
+  for (frame_id_t frame_id = 0; static_cast<size_t>(frame_id) < pool_size_; ++frame_id) {
+    auto page = &pages_[frame_id];
+    std::scoped_lock frame_lock(frame_latches_[frame_id]);
+    if (page->page_id_ != INVALID_PAGE_ID && page->pin_count_ == 0 && page->is_dirty_ &&
+        !frame_io_in_flight_[frame_id] && pages_cleaning_.count(page->page_id_) == 0) {
+      dirty_frames.emplace_back(page->page_id_, frame_id);
+    }
+  }
+  // Neighbouring pages go out together, which is what the disk likes best.
+  std::sort(dirty_frames.begin(), dirty_frames.end());
+  dirty_frames.resize(std::min({dirty_frames.size(), target - num_clean, cleaner_buffers_.size()}));
+
+  // Nobody can modify an unpinned page without pinning it under its frame
+  // latch, so the copies are consistent. A page pinned since it was picked is
+  // skipped, and a page dirtied again meanwhile just stays dirty.
+  std::vector<DiskRequest> requests;
+  std::vector<std::future<bool>> futures;
+  requests.reserve(dirty_frames.size());
+  futures.reserve(dirty_frames.size());
+  size_t num_copied = 0;
+  for (const auto &[page_id, frame_id] : dirty_frames) {
+    auto page = &pages_[frame_id];
+    std::scoped_lock frame_lock(frame_latches_[frame_id]);
+    if (page->pin_count_ > 0) {
+      continue;
+    }
+    auto *buffer = cleaner_buffers_[num_copied].data_;
+    memcpy(buffer, page->data_, BUSTUB_PAGE_SIZE);
+    page->is_dirty_ = false;
+    pages_cleaning_.insert(page_id);
+    dirty_frames[num_copied++] = {page_id, frame_id};
+    auto promise = disk_scheduler_->CreatePromise();
+    futures.emplace_back(promise.get_future());
+    requests.push_back({true, buffer, page_id, std::move(promise)});
+  }
+  dirty_frames.resize(num_copied);
+  lock.unlock();
+  disk_scheduler_->Schedule(std::move(requests));
+  for (auto &future : futures) {
+    future.get();
+  }
+  lock.lock();
+  for (const auto &[page_id, frame_id] : dirty_frames) {
+    pages_cleaning_.erase(page_id);
+  }
+  io_done_cv_.notify_all();
+  return dirty_frames.size();
+}
+
+auto BufferPoolManagerInstance::CountCleanFrames() -> size_t {
+  auto num_clean = free_list_.size();
+  for (frame_id_t frame_id = 0; static_cast<size_t>(frame_id) < pool_size_; ++frame_id) {
+    auto page = &pages_[frame_id];
+    std::scoped_lock frame_lock(frame_latches_[frame_id]);
+    if (page->page_id_ != INVALID_PAGE_ID && page->pin_count_ == 0 && !page->is_dirty_ &&
+        !frame_io_in_flight_[frame_id]) {
+      num_clean++;
+    }
+  }
+  return num_clean;
+}
+
+auto BufferPoolManagerInstance::AllocatePage() -> page_id_t {
+  const page_id_t next_page_id = next_page_id_.fetch_add(static_cast<page_id_t>(num_instances_));
+  ValidatePageId(next_page_id);
+  return next_page_id;
+}
+
+void BufferPoolManagerInstance::ValidatePageId(const page_id_t page_id) const {
+  // allocated pages mod back to this BPI
+  BUSTUB_ASSERT(static_cast<uint32_t>(page_id) % num_instances_ == instance_index_,
+                "page id does not belong to this buffer pool instance");
+}
 
 }  // namespace bustub
@@ -0,0 +1,264 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// clock_pro_replacer.cpp
+//
+// Identification: src/buffer/clock_pro_replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/clock_pro_replacer.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+ClockProReplacer::ClockProReplacer(size_t num_frames)
+    : replacer_size_(num_frames),
+      hand_hot_(clock_.end()),
+      hand_cold_(clock_.end()),
+      hand_test_(clock_.end()),
+      frames_(num_frames) {}
+
+auto ClockProReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock lock(latch_);
+  if (size_ == 0) {
+    return false;
+  }
+  // Every sweep clears reference bits, so an evictable cold page shows up
+  // within two revolutions. If all evictable pages are hot, HAND_hot has to
+  // turn them cold first, one per revolution of HAND_cold.
+  size_t steps = 0;
+  while (true) {
+    auto victim = RunHandCold();
+    if (victim >= 0) {
+      *frame_id = victim;
+      return true;
+    }
+    if (++steps % (2 * clock_.size()) == 0) {
+      RunHandHot();
+    }
+  }
+}
+
+void ClockProReplacer::RecordAccess(frame_id_t frame_id, page_id_t page_id) {
+  CheckAndHandleFrameID(frame_id);
+  std::scoped_lock lock(latch_);
+  auto &frame = frames_[frame_id];
+  if (frame.tracked_) {
+    frame.pos_->referenced_ = true;
+    return;
+  }
+  auto it = page_id == INVALID_PAGE_ID ? non_resident_.end() : non_resident_.find(page_id);
+  if (it != non_resident_.end()) {
+    // Reused within its test period: the page is hot, and cold pages deserve more room.
+    cold_target_ = std::min(cold_target_ + 1, std::max<size_t>(replacer_size_, 1));
+    auto pos = it->second;
+    non_resident_.erase(it);
+    Erase(pos);
+    --num_non_resident_;
+    frame.pos_ = InsertAtHead({page_id, frame_id, PageStatus::HOT});
+    ++num_hot_;
+    while (num_hot_ > replacer_size_ - std::min(cold_target_, replacer_size_)) {
+      RunHandHot();
+    }
+  } else {
+    frame.pos_ = InsertAtHead({page_id, frame_id, PageStatus::COLD, false, true});
+  }
+  while (num_non_resident_ > replacer_size_) {
+    RunHandTest();
+  }
+  // A new entry starts out evictable.
+  frame.tracked_ = true;
+  frame.evictable_ = true;
+  ++size_;
+}
+
+void ClockProReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  CheckAndHandleFrameID(frame_id);
+  std::scoped_lock lock(latch_);
+  auto &frame = frames_[frame_id];
+  if (!frame.tracked_ || frame.evictable_ == set_evictable) {
+    return;
+  }
+  frame.evictable_ = set_evictable;
+  if (set_evictable) {
+    ++size_;
+  } else {
+    --size_;
+  }
+}
+
+void ClockProReplacer::Remove(frame_id_t frame_id) {
+  CheckAndHandleFrameID(frame_id);
+  std::scoped_lock lock(latch_);
+  auto &frame = frames_[frame_id];
+  if (!frame.tracked_) {
+    return;
+  }
+  if (!frame.evictable_) {
+    throw std::runtime_error("try to remove an inevitable frame.");
+  }
+  auto pos = frame.pos_;
+  Untrack(frame_id);
+  Erase(pos);
+}
+
+auto ClockProReplacer::Size() const -> size_t {
+  std::scoped_lock lock(latch_);
+  return size_;
+}
+
+auto ClockProReplacer::GetColdTarget() const -> size_t {
+  std::scoped_lock lock(latch_);
+  return cold_target_;
+}
+
+auto ClockProReplacer::Next(Hand pos) -> Hand {
+  ++pos;
+  return pos == clock_.end() ? clock_.begin() : pos;
+}
+
+auto ClockProReplacer::InsertAtHead(const ClockEntry &entry) -> Hand {
+  auto pos = clock_.insert(hand_hot_, entry);
+  if (clock_.size() == 1) {
+    hand_hot_ = hand_cold_ = hand_test_ = pos;
+  }
+  return pos;
+}
+
+void ClockProReplacer::MoveToHead(Hand pos) {
+  if (clock_.size() == 1) {
+    return;
+  }
+  auto next = Next(pos);
+  for (auto *hand : {&hand_hot_, &hand_cold_, &hand_test_}) {
+    if (*hand == pos) {
+      *hand = next;
+    }
+  }
+  clock_.splice(hand_hot_, clock_, pos);
+}
+
+void ClockProReplacer::Erase(Hand pos) {
+  auto next = clock_.size() == 1 ? clock_.end() : Next(pos);
+  for (auto *hand : {&hand_hot_, &hand_cold_, &hand_test_}) {
+    if (*hand == pos) {
+      *hand = next;
+    }
+  }
+  clock_.erase(pos);
+}
+
+void ClockProReplacer::RunHandHot() {
+  for (size_t steps = clock_.size(); steps > 0 && !clock_.empty(); --steps) {
+    auto pos = hand_hot_;
+    switch (pos->status_) {
+      case PageStatus::HOT:
+        hand_hot_ = Next(pos);
+        if (pos->referenced_) {
+          pos->referenced_ = false;
+          break;
+        }
+        pos->status_ = PageStatus::COLD;
+        --num_hot_;
+        return;
+      case PageStatus::COLD:
+        if (pos->in_test_) {
+          pos->in_test_ = false;
+          DecreaseColdTarget();
+        }
+        hand_hot_ = Next(pos);
+        break;
+      case PageStatus::NON_RESIDENT:
+        non_resident_.erase(pos->page_id_);
+        Erase(pos);
+        --num_non_resident_;
+        DecreaseColdTarget();
+        break;
+    }
+  }
+}
+
+void ClockProReplacer::RunHandTest() {
+  for (size_t steps = clock_.size(); steps > 0 && !clock_.empty(); --steps) {
+    auto pos = hand_test_;
+    if (pos->status_ == PageStatus::NON_RESIDENT) {
+      non_resident_.erase(pos->page_id_);
+      Erase(pos);
+      --num_non_resident_;
+      DecreaseColdTarget();
+      return;
+    }
+    if (pos->status_ == PageStatus::COLD && pos->in_test_) {
+      pos->in_test_ = false;
+      DecreaseColdTarget();
+    }
+    hand_test_ = Next(pos);
+  }
+}
+
+auto ClockProReplacer::RunHandCold() -> frame_id_t {
+  auto pos = hand_cold_;
+  if (pos->status_ != PageStatus::COLD) {
+    hand_cold_ = Next(pos);
+    return -1;
+  }
+  if (pos->referenced_) {
+    pos->referenced_ = false;
+    if (pos->in_test_) {
+      // Reused within its test period.
+      pos->status_ = PageStatus::HOT;
+      pos->in_test_ = false;
+      ++num_hot_;
+      MoveToHead(pos);
+      while (num_hot_ > replacer_size_ - std::min(cold_target_, replacer_size_)) {
+        RunHandHot();
+      }
+    } else {
+      pos->in_test_ = true;
+      MoveToHead(pos);
+    }
+    return -1;
+  }
+  auto frame_id = pos->frame_id_;
+  if (!frames_[frame_id].evictable_) {
+    hand_cold_ = Next(pos);
+    return -1;
+  }
+  Untrack(frame_id);
+  if (pos->in_test_ && pos->page_id_ != INVALID_PAGE_ID) {
+    // Keep the page on the clock so a quick reuse can be told apart.
+    pos->status_ = PageStatus::NON_RESIDENT;
+    pos->frame_id_ = -1;
+    non_resident_[pos->page_id_] = pos;
+    ++num_non_resident_;
+    hand_cold_ = Next(pos);
+    // The page replacing the victim is only looked up after this eviction, so
+    // one entry of slack keeps HAND_test from dropping it in between.
+    while (num_non_resident_ > replacer_size_ + 1) {
+      RunHandTest();
+    }
+  } else {
+    Erase(pos);
+  }
+  return frame_id;
+}
+
+void ClockProReplacer::DecreaseColdTarget() { cold_target_ = std::max<size_t>(cold_target_ - 1, 1); }
+
+void ClockProReplacer::Untrack(frame_id_t frame_id) {
+  auto &frame = frames_[frame_id];
+  if (frame.pos_->status_ == PageStatus::HOT) {
+    --num_hot_;
+  }
+  if (frame.evictable_) {
+    --size_;
+  }
+  frame = FrameState{};
+}
+
+}  // namespace bustub
@@ -0,0 +1,51 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_replacer.cpp
+//
+// Identification: src/buffer/frame_replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/frame_replacer.h"
+
+#include "buffer/arc_replacer.h"
+#include "buffer/clock_pro_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/two_queue_replacer.h"
+#include "common/exception.h"
+
+namespace bustub {
+
+auto MakeFrameReplacer(ReplacerPolicy policy, size_t num_frames, size_t k) -> std::unique_ptr<FrameReplacer> {
+  switch (policy) {
+    case ReplacerPolicy::LRU_K:
+      return std::make_unique<LRUKReplacer>(num_frames, k);
+    case ReplacerPolicy::TWO_Q:
+      return std::make_unique<TwoQueueReplacer>(num_frames);
+    case ReplacerPolicy::ARC:
+      return std::make_unique<ARCReplacer>(num_frames);
+    case ReplacerPolicy::CLOCK_PRO:
+      return std::make_unique<ClockProReplacer>(num_frames);
+  }
+  throw Exception(ExceptionType::INVALID, "unknown replacer policy");
+}
+
+auto ReplacerPolicyToString(ReplacerPolicy policy) -> std::string {
+  switch (policy) {
+    case ReplacerPolicy::LRU_K:
+      return "lru-k";
+    case ReplacerPolicy::TWO_Q:
+      return "2q";
+    case ReplacerPolicy::ARC:
+      return "arc";
+    case ReplacerPolicy::CLOCK_PRO:
+      return "clock-pro";
+  }
+  return "unknown";
+}
+
+}  // namespace bustub
@@ -12,111 +12,169 @@
 
 #include "buffer/lru_k_replacer.h"
 
+#include <algorithm>
+#include <functional>
 #include <mutex>  // NOLINT
+#include <thread>  // NOLINT
 
 #include "common/logger.h"
 
 namespace bustub {
 
-LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : size_{0}, replacer_size_{num_frames}, k_{k} {
-  temp_pool_ = new TempPool;
-  cache_pool_ = new CachePool;
-  timer_ = new Timer;
+LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k)
+    : replacer_size_{num_frames},
+      k_{k},
+      history_(num_frames * k),
+      frames_(num_frames),
+      tracked_(new std::atomic<bool>[num_frames]) {
+  BUSTUB_ASSERT(k > 0, "LRU-K needs k >= 1");
+  for (size_t i = 0; i < num_frames; ++i) {
+    tracked_[i].store(false, std::memory_order_relaxed);
+  }
+  for (auto &shard : access_shards_) {
+    shard.accesses_.reserve(ACCESS_BATCH_SIZE);
+  }
 }
 
-LRUKReplacer::~LRUKReplacer() {
-  delete temp_pool_;
-  delete cache_pool_;
-  delete timer_;
-}
+LRUKReplacer::~LRUKReplacer() = default;
 
 auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool {
-  auto result_id = -1;
-  auto evicted = false;
-  std::unique_lock lock(latch_);
-  if (size_ == 0) {
+  std::scoped_lock lock(latch_);
+  DrainAccesses();
+  if (evictable_frames_.empty()) {
     LOG_DEBUG("empty replacer, not evict-able.");
     return false;
   }
-  if (!temp_pool_->IsEmpty()) {
-    evicted = temp_pool_->EvictableFront(result_id);
-  }
-  if (!evicted && !cache_pool_->IsEmpty()) {
-    evicted = cache_pool_->PopEvictedFront(result_id);
-  }
-  if (!evicted) {
-    LOG_DEBUG("no proper pool, not evict-able.");
-    return false;
-  }
-  size_--;
-  *frame_id = result_id;
+  *frame_id = std::get<2>(*evictable_frames_.begin());
+  Untrack(*frame_id);
   return true;
 }
 
 auto LRUKReplacer::RecordAccess(frame_id_t frame_id) -> void {
   CheckAndHandleFrameID(frame_id);
-  std::unique_lock lock(latch_);
-  if (!temp_pool_->Contain(frame_id) && !cache_pool_->Contain(frame_id)) {
-    temp_pool_->Insert(frame_id, std::make_shared<Entry>(k_, frame_id, timer_));
-    size_++;
-  }
-  auto entry = temp_pool_->Contain(frame_id) ? temp_pool_->Get(frame_id) : cache_pool_->Get(frame_id);
-  entry->RecordAccess();
-  if (entry->GetSize() == k_) {
-    if (temp_pool_->Contain(entry->GetID())) {
-      auto new_entry = temp_pool_->Remove(frame_id);
-      cache_pool_->Insert(frame_id, std::move(new_entry));
-    } else {
-      cache_pool_->Adjust(frame_id);
+  if (tracked_[frame_id].load(std::memory_order_acquire)) {
+    // Fast path: the frame has a history, the access only needs to be ordered.
+    auto &shard = access_shards_[ShardIndex()];
+    auto batch_full = false;
+    {
+      std::scoped_lock shard_lock(shard.latch_);
+      shard.accesses_.emplace_back(current_timestamp_.fetch_add(1) + 1, frame_id);
+      batch_full = shard.accesses_.size() >= ACCESS_BATCH_SIZE;
+    }
+    if (batch_full) {
+      std::scoped_lock lock(latch_);
+      DrainAccesses();
     }
+    return;
   }
+  std::scoped_lock lock(latch_);
+  DrainAccesses();
+  ApplyAccess(frame_id, current_timestamp_.fetch_add(1) + 1);
 }
 
 auto LRUKReplacer::Remove(frame_id_t frame_id) -> void {
   CheckAndHandleFrameID(frame_id);
-  std::unique_lock lock(latch_);
-  if (temp_pool_->Contain(frame_id)) {
-    auto entry = temp_pool_->Get(frame_id);
-    if (entry->IsEvictable()) {
-      size_--;
-    } else {
-      throw std::runtime_error("try to remove an inevitable frame.");
-    }
-    temp_pool_->Remove(frame_id);
-  } else if (cache_pool_->Contain(frame_id)) {
-    auto entry = cache_pool_->Get(frame_id);
-    if (entry->IsEvictable()) {
-      size_--;
-    } else {
-      throw std::runtime_error("try to remove an inevitable frame.");
-    }
-    cache_pool_->Remove(frame_id);
-  } else {
+  std::scoped_lock lock(latch_);
+  if (!tracked_[frame_id].load(std::memory_order_relaxed)) {
     return;
   }
+  if (!frames_[frame_id].evictable_) {
+    throw std::runtime_error("try to remove an inevitable frame.");
+  }
+  Untrack(frame_id);
 }
 
 auto LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) -> void {
   CheckAndHandleFrameID(frame_id);
-  std::unique_lock lock(latch_);
-  std::shared_ptr<Entry> entry;
-  if (temp_pool_->Contain(frame_id)) {
-    entry = temp_pool_->Get(frame_id);
-  } else if (cache_pool_->Contain(frame_id)) {
-    entry = cache_pool_->Get(frame_id);
-  } else {
+  std::scoped_lock lock(latch_);
+  auto &frame = frames_[frame_id];
+  if (!tracked_[frame_id].load(std::memory_order_relaxed) || frame.evictable_ == set_evictable) {
     return;
   }
-  if (!entry->IsEvictable() && set_evictable) {
+  // Buffered accesses need not be drained: the key is always derived from the
+  // applied history, and DrainAccesses() repositions the frame when it applies them.
+  if (set_evictable) {
+    evictable_frames_.insert(GetEvictionKey(frame_id));
     ++size_;
-  } else if (entry->IsEvictable() && !set_evictable) {
+  } else {
+    evictable_frames_.erase(GetEvictionKey(frame_id));
     --size_;
   }
-  entry->SetEvictable(set_evictable);
+  frame.evictable_ = set_evictable;
 }
 
 auto LRUKReplacer::Size() const -> size_t {
-  std::shared_lock lock(latch_);
+  std::scoped_lock lock(latch_);
   return size_;
 }
+
+auto LRUKReplacer::ShardIndex() -> size_t {
+  thread_local const size_t shard_index = std::hash<std::thread::id>{}(std::this_thread::get_id()) % NUM_ACCESS_SHARDS;
+  return shard_index;
+}
+
+auto LRUKReplacer::GetEvictionKey(frame_id_t frame_id) const -> EvictionKey {
+  const auto &frame = frames_[frame_id];
+  return {frame.history_size_ == k_, history_[frame_id * k_ + frame.history_head_], frame_id};
+}
+
+void LRUKReplacer::ApplyAccess(frame_id_t frame_id, size_t timestamp) {
+  auto &frame = frames_[frame_id];
+  if (!tracked_[frame_id].load(std::memory_order_relaxed)) {
+    // A new entry starts out evictable.
+    frame = FrameState{};
+    frame.tracked_since_ = timestamp;
+    history_[frame_id * k_] = timestamp;
+    frame.history_size_ = 1;
+    frame.evictable_ = true;
+    evictable_frames_.insert(GetEvictionKey(frame_id));
+    ++size_;
+    tracked_[frame_id].store(true, std::memory_order_release);
+    return;
+  }
+  if (timestamp < frame.tracked_since_) {
+    // Recorded for a previous occupant of the frame.
+    return;
+  }
+  if (frame.evictable_) {
+    evictable_frames_.erase(GetEvictionKey(frame_id));
+  }
+  if (frame.history_size_ == k_) {
+    history_[frame_id * k_ + frame.history_head_] = timestamp;
+    frame.history_head_ = (frame.history_head_ + 1) % k_;
+  } else {
+    history_[frame_id * k_ + (frame.history_head_ + frame.history_size_) % k_] = timestamp;
+    frame.history_size_++;
+  }
+  if (frame.evictable_) {
+    evictable_frames_.insert(GetEvictionKey(frame_id));
+  }
+}
+
+void LRUKReplacer::DrainAccesses() {
+  std::vector<std::pair<size_t, frame_id_t>> accesses;
+  for (auto &shard : access_shards_) {
+    std::scoped_lock shard_lock(shard.latch_);
+    accesses.insert(accesses.end(), shard.accesses_.begin(), shard.accesses_.end());
+    shard.accesses_.clear();
+  }
+  if (accesses.empty()) {
+    return;
+  }
+  std::sort(accesses.begin(), accesses.end());
+  for (const auto &[timestamp, frame_id] : accesses) {
+    // Accesses to frames evicted meanwhile are dropped.
+    if (tracked_[frame_id].load(std::memory_order_relaxed)) {
+      ApplyAccess(frame_id, timestamp);
+    }
+  }
+}
+
+void LRUKReplacer::Untrack(frame_id_t frame_id) {
+  evictable_frames_.erase(GetEvictionKey(frame_id));
+  --size_;
+  frames_[frame_id] = FrameState{};
+  tracked_[frame_id].store(false, std::memory_order_release);
+}
+
 }  // namespace bustub
@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_read_ahead.cpp
+//
+// Identification: src/buffer/page_read_ahead.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/page_read_ahead.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace bustub {
+
+PageReadAhead::PageReadAhead(BufferPoolManager *bpm, NextPageIdFn next_page_id, size_t window,
+                             BufferAccessStrategy *strategy)
+    : bpm_(bpm), next_page_id_(std::move(next_page_id)), window_(window), strategy_(strategy) {
+  if (bpm_ != nullptr) {
+    window_ = std::min(window_, bpm_->GetPoolSize() / 4);
+  }
+}
+
+void PageReadAhead::Advance(page_id_t page_id) {
+  if (bpm_ == nullptr || window_ == 0 || page_id == INVALID_PAGE_ID || page_id == current_page_id_) {
+    return;
+  }
+  current_page_id_ = page_id;
+  while (!ahead_.empty() && ahead_.front() != page_id) {
+    ahead_.pop_front();
+  }
+  if (ahead_.empty()) {
+    // First call, or the scan left the chain we predicted: start over from here.
+    end_of_chain_ = false;
+  } else {
+    ahead_.pop_front();
+  }
+
+  while (!end_of_chain_ && ahead_.size() < window_) {
+    auto tail_page_id = ahead_.empty() ? current_page_id_ : ahead_.back();
+    auto tail = bpm_->FetchPage(tail_page_id, strategy_);
+    if (tail == nullptr) {
+      // Every frame is pinned, try again on the next page.
+      return;
+    }
+    auto next_page_id = next_page_id_(tail);
+    bpm_->UnpinPage(tail_page_id, false);
+    if (next_page_id == INVALID_PAGE_ID) {
+      end_of_chain_ = true;
+      return;
+    }
+    bpm_->PrefetchPages({next_page_id}, strategy_);
+    ahead_.push_back(next_page_id);
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,134 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer.cpp
+//
+// Identification: src/buffer/two_queue_replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/two_queue_replacer.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+TwoQueueReplacer::TwoQueueReplacer(size_t num_frames)
+    : replacer_size_(num_frames),
+      max_in_size_(std::max<size_t>(num_frames / 4, 1)),
+      max_out_size_(std::max<size_t>(num_frames / 2, 1)),
+      frames_(num_frames) {}
+
+auto TwoQueueReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock lock(latch_);
+  if (size_ == 0) {
+    return false;
+  }
+  auto from_in = a1_in_.size() > max_in_size_ || am_.empty();
+  auto victim = FindVictim(from_in ? a1_in_ : am_);
+  if (victim < 0) {
+    from_in = !from_in;
+    victim = FindVictim(from_in ? a1_in_ : am_);
+  }
+  BUSTUB_ASSERT(victim >= 0, "size_ counts an evictable frame that is in neither queue");
+  auto page_id = frames_[victim].page_id_;
+  Untrack(victim);
+  if (from_in && page_id != INVALID_PAGE_ID && a1_out_index_.count(page_id) == 0) {
+    // The page replacing the victim is only looked up in A1out after this
+    // eviction, so A1out may exceed Kout by one until then.
+    TrimOut();
+    a1_out_.push_front(page_id);
+    a1_out_index_[page_id] = a1_out_.begin();
+  }
+  *frame_id = victim;
+  return true;
+}
+
+void TwoQueueReplacer::RecordAccess(frame_id_t frame_id, page_id_t page_id) {
+  CheckAndHandleFrameID(frame_id);
+  std::scoped_lock lock(latch_);
+  auto &frame = frames_[frame_id];
+  if (frame.queue_ == QueueType::MAIN) {
+    am_.splice(am_.begin(), am_, frame.pos_);
+    return;
+  }
+  if (frame.queue_ == QueueType::IN) {
+    // Correlated reference, A1in stays in load order.
+    return;
+  }
+  auto queue = QueueType::IN;
+  auto it = page_id == INVALID_PAGE_ID ? a1_out_index_.end() : a1_out_index_.find(page_id);
+  if (it != a1_out_index_.end()) {
+    a1_out_.erase(it->second);
+    a1_out_index_.erase(it);
+    queue = QueueType::MAIN;
+  }
+  TrimOut();
+  auto &target = queue == QueueType::IN ? a1_in_ : am_;
+  target.push_front(frame_id);
+  // A new entry starts out evictable.
+  frame = FrameEntry{queue, true, page_id, target.begin()};
+  ++size_;
+}
+
+void TwoQueueReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  CheckAndHandleFrameID(frame_id);
+  std::scoped_lock lock(latch_);
+  auto &frame = frames_[frame_id];
+  if (frame.queue_ == QueueType::NONE || frame.evictable_ == set_evictable) {
+    return;
+  }
+  frame.evictable_ = set_evictable;
+  if (set_evictable) {
+    ++size_;
+  } else {
+    --size_;
+  }
+}
+
+void TwoQueueReplacer::Remove(frame_id_t frame_id) {
+  CheckAndHandleFrameID(frame_id);
+  std::scoped_lock lock(latch_);
+  if (frames_[frame_id].queue_ == QueueType::NONE) {
+    return;
+  }
+  if (!frames_[frame_id].evictable_) {
+    throw std::runtime_error("try to remove an inevitable frame.");
+  }
+  Untrack(frame_id);
+}
+
+auto TwoQueueReplacer::Size() const -> size_t {
+  std::scoped_lock lock(latch_);
+  return size_;
+}
+
+auto TwoQueueReplacer::FindVictim(const std::list<frame_id_t> &queue) const -> frame_id_t {
+  for (auto it = queue.rbegin(); it != queue.rend(); ++it) {
+    if (frames_[*it].evictable_) {
+      return *it;
+    }
+  }
+  return -1;
+}
+
+void TwoQueueReplacer::TrimOut() {
+  while (a1_out_.size() > max_out_size_) {
+    a1_out_index_.erase(a1_out_.back());
+    a1_out_.pop_back();
+  }
+}
+
+void TwoQueueReplacer::Untrack(frame_id_t frame_id) {
+  auto &frame = frames_[frame_id];
+  (frame.queue_ == QueueType::IN ? a1_in_ : am_).erase(frame.pos_);
+  if (frame.evictable_) {
+    --size_;
+  }
+  frame = FrameEntry{};
+}
+
+}  // namespace bustub
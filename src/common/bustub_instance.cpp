@@ -12,6 +12,7 @@
 #include "binder/statement/select_statement.h"
 #include "binder/statement/set_show_statement.h"
 #include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
 #include "catalog/schema.h"
 #include "catalog/table_generator.h"
 #include "common/bustub_instance.h"
@@ -37,11 +38,54 @@
 
 namespace bustub {
 
+auto BustubInstance::CreateBPlusTreeIndex(Transaction *txn, const IndexStatement &index_stmt, const Schema &key_schema,
+                                          const std::vector<uint32_t> &col_ids) -> IndexInfo * {
+  // A key is its columns serialized as a tuple: the fixed-size part, then
+  // each varchar as a length prefix and its characters, including the '\0'.
+  size_t max_key_size = key_schema.GetLength();
+  for (auto idx : key_schema.GetUnlinedColumns()) {
+    max_key_size += sizeof(uint32_t) + key_schema.GetColumn(idx).GetVariableLength() + 1;
+  }
+  // Keys of a non-unique index end with the RID, as a BIGINT.
+  if (!index_stmt.unique_) {
+    max_key_size += sizeof(int64_t);
+  }
+  const auto create = [&](auto key) {
+    using KeyType = decltype(key);
+    constexpr auto key_size = sizeof(KeyType);
+    using KeyComparator = GenericComparator<key_size>;
+    return catalog_->CreateIndex<KeyType, RID, KeyComparator>(txn, index_stmt.index_name_, index_stmt.table_->table_,
+                                                               index_stmt.table_->schema_, key_schema, col_ids,
+                                                               key_size, HashFunction<KeyType>{},
+                                                               index_stmt.compressed_ ? IndexKeyFormat::COMPRESSED
+                                                                                      : IndexKeyFormat::PLAIN,
+                                                               index_stmt.unique_, index_stmt.b_link_);
+  };
+  if (max_key_size <= 4) {
+    return create(GenericKey<4>{});
+  }
+  if (max_key_size <= 8) {
+    return create(GenericKey<8>{});
+  }
+  if (max_key_size <= 16) {
+    return create(GenericKey<16>{});
+  }
+  if (max_key_size <= 32) {
+    return create(GenericKey<32>{});
+  }
+  if (max_key_size <= 64) {
+    return create(GenericKey<64>{});
+  }
+  throw NotImplementedException(fmt::format("index keys are at most 64 bytes, the key of {} takes up to {}",
+                                            index_stmt.index_name_, max_key_size));
+}
+
 auto BustubInstance::MakeExecutorContext(Transaction *txn) -> std::unique_ptr<ExecutorContext> {
-  return std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_);
+  return std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_,
+                                           GetExecutionThreads(), GetHashJoinMemoryLimit());
 }
 
-BustubInstance::BustubInstance(const std::string &db_file_name) {
+BustubInstance::BustubInstance(const std::string &db_file_name, size_t bpm_num_instances) {
   enable_logging = false;
 
   // Storage related.
@@ -51,9 +95,17 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
   log_manager_ = new LogManager(disk_manager_);
 
   // We need more frames for GenerateTestTable to work. Therefore, we use 128
-  // instead of the default buffer pool size specified in `config.h`.
+  // instead of the default buffer pool size specified in `config.h`. Every
+  // shard of a parallel buffer pool gets its own 128 frames.
   try {
-    buffer_pool_manager_ = new BufferPoolManagerInstance(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    if (bpm_num_instances > 1) {
+      buffer_pool_manager_ =
+          new ParallelBufferPoolManager(bpm_num_instances, 128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    } else {
+      buffer_pool_manager_ = new BufferPoolManagerInstance(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    }
+    // Writes to the database file are worth taking off the query path.
+    buffer_pool_manager_->RunPageCleaner();
   } catch (NotImplementedException &e) {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are "
                  "supported."
@@ -75,7 +127,7 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
   execution_engine_ = new ExecutionEngine(buffer_pool_manager_, txn_manager_, catalog_);
 }
 
-BustubInstance::BustubInstance() {
+BustubInstance::BustubInstance(size_t bpm_num_instances) {
   enable_logging = false;
 
   // Storage related.
@@ -85,9 +137,15 @@ BustubInstance::BustubInstance() {
   log_manager_ = new LogManager(disk_manager_);
 
   // We need more frames for GenerateTestTable to work. Therefore, we use 128
-  // instead of the default buffer pool size specified in `config.h`.
+  // instead of the default buffer pool size specified in `config.h`. Every
+  // shard of a parallel buffer pool gets its own 128 frames.
   try {
-    buffer_pool_manager_ = new BufferPoolManagerInstance(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    if (bpm_num_instances > 1) {
+      buffer_pool_manager_ =
+          new ParallelBufferPoolManager(bpm_num_instances, 128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    } else {
+      buffer_pool_manager_ = new BufferPoolManagerInstance(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    }
   } catch (NotImplementedException &e) {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are "
                  "supported."
@@ -242,19 +300,11 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
         for (const auto &col : index_stmt.cols_) {
           auto idx = index_stmt.table_->schema_.GetColIdx(col->col_name_.back());
           col_ids.push_back(idx);
-          if (index_stmt.table_->schema_.GetColumn(idx).GetType() != TypeId::INTEGER) {
-            throw NotImplementedException("only support creating index on integer column");
-          }
-        }
-        if (col_ids.size() != 1) {
-          throw NotImplementedException("only support creating index with exactly one column");
         }
         auto key_schema = Schema::CopySchema(&index_stmt.table_->schema_, col_ids);
 
         std::unique_lock<std::shared_mutex> l(catalog_lock_);
-        auto info = catalog_->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
-            txn, index_stmt.index_name_, index_stmt.table_->table_, index_stmt.table_->schema_, key_schema, col_ids,
-            INTEGER_SIZE, IntegerHashFunctionType{});
+        auto info = CreateBPlusTreeIndex(txn, index_stmt, key_schema, col_ids);
         l.unlock();
 
         if (info == nullptr) {
@@ -0,0 +1,116 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table.cpp
+//
+// Identification: src/container/hash/page_table.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "container/hash/page_table.h"
+
+namespace bustub {
+
+PageTable::PageTable(size_t num_frames) : max_size_(num_frames) {
+  // Load factor at most 1/2 keeps probe sequences short and always leaves an empty slot to stop at.
+  size_t capacity = 2;
+  shift_ = 63;
+  while (capacity < 2 * num_frames) {
+    capacity <<= 1;
+    --shift_;
+  }
+  mask_ = capacity - 1;
+  slots_ = std::make_unique<std::atomic<uint64_t>[]>(capacity);
+  for (size_t i = 0; i < capacity; ++i) {
+    slots_[i].store(EMPTY_SLOT, std::memory_order_relaxed);
+  }
+}
+
+auto PageTable::Find(const page_id_t &page_id, frame_id_t &frame_id) -> bool {
+  while (true) {
+    auto version = version_.load(std::memory_order_acquire);
+    if ((version & 1) != 0) {
+      continue;
+    }
+    auto found = false;
+    frame_id_t frame = -1;
+    auto i = HomeOf(page_id);
+    // A racing Remove() can make the probe miss its stop, so bound it by the capacity.
+    for (size_t n = 0; n <= mask_; ++n, i = (i + 1) & mask_) {
+      auto slot = slots_[i].load(std::memory_order_acquire);
+      if (slot == EMPTY_SLOT) {
+        break;
+      }
+      if (PageOf(slot) == page_id) {
+        found = true;
+        frame = FrameOf(slot);
+        break;
+      }
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (version_.load(std::memory_order_relaxed) == version) {
+      if (found) {
+        frame_id = frame;
+      }
+      return found;
+    }
+  }
+}
+
+auto PageTable::Remove(const page_id_t &page_id) -> bool {
+  std::scoped_lock lock(write_latch_);
+  auto hole = Probe(page_id);
+  if (slots_[hole].load(std::memory_order_relaxed) == EMPTY_SLOT) {
+    return false;
+  }
+  auto version = version_.load(std::memory_order_relaxed);
+  version_.store(version + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  // Move every following entry of the cluster whose home is not between the
+  // hole and itself into the hole, so that no probe sequence runs into it.
+  for (auto i = (hole + 1) & mask_;; i = (i + 1) & mask_) {
+    auto slot = slots_[i].load(std::memory_order_relaxed);
+    if (slot == EMPTY_SLOT) {
+      break;
+    }
+    auto home = HomeOf(PageOf(slot));
+    if (((i - home) & mask_) >= ((i - hole) & mask_)) {
+      slots_[hole].store(slot, std::memory_order_relaxed);
+      hole = i;
+    }
+  }
+  slots_[hole].store(EMPTY_SLOT, std::memory_order_relaxed);
+  version_.store(version + 2, std::memory_order_release);
+  size_.fetch_sub(1, std::memory_order_relaxed);
+  return true;
+}
+
+void PageTable::Insert(const page_id_t &page_id, const frame_id_t &frame_id) {
+  BUSTUB_ASSERT(page_id != INVALID_PAGE_ID, "cannot insert an invalid page id");
+  std::scoped_lock lock(write_latch_);
+  auto i = Probe(page_id);
+  if (slots_[i].load(std::memory_order_relaxed) == EMPTY_SLOT) {
+    BUSTUB_ASSERT(size_.load(std::memory_order_relaxed) < max_size_, "page table is full");
+    size_.fetch_add(1, std::memory_order_relaxed);
+  }
+  // A single store, readers see either the old or the new slot.
+  slots_[i].store(Pack(page_id, frame_id), std::memory_order_release);
+}
+
+auto PageTable::Size() const -> size_t { return size_.load(std::memory_order_relaxed); }
+
+auto PageTable::Probe(page_id_t page_id) const -> size_t {
+  auto i = HomeOf(page_id);
+  while (true) {
+    auto slot = slots_[i].load(std::memory_order_relaxed);
+    if (slot == EMPTY_SLOT || PageOf(slot) == page_id) {
+      return i;
+    }
+    i = (i + 1) & mask_;
+  }
+}
+
+}  // namespace bustub
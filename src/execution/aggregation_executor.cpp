@@ -9,10 +9,17 @@
 // Copyright (c) 2015-2021, Carnegie Mellon University Database Group
 //
 //===----------------------------------------------------------------------===//
+#include <exception>
 #include <memory>
+#include <optional>
+#include <thread>  // NOLINT
 #include <vector>
 
 #include "execution/executors/aggregation_executor.h"
+#include "execution/expressions/expression_program.h"
+#include "execution/morsel_queue.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/seq_scan_plan.h"
 
 namespace bustub {
 
@@ -31,11 +38,12 @@ void AggregationExecutor::Init() {
     return;
   }
   if (!initialized_) {
-    child_->Init();
-    Tuple tuple;
-    RID rid;
-    while (child_->Next(&tuple, &rid)) {
-      aht_.InsertCombine(MakeAggregateKey(&tuple), MakeAggregateValue(&tuple));
+    if (!AggregateInParallel()) {
+      child_->Init();
+      TupleBatch batch{&child_->GetOutputSchema()};
+      while (child_->NextBatch(&batch)) {
+        AggregateBatch(batch, &aht_);
+      }
     }
     initialized_ = true;
   }
@@ -44,11 +52,127 @@ void AggregationExecutor::Init() {
     empty_status_ = EmptyStatus::kNotEmpty;
   }
 }
+auto AggregationExecutor::AggregateInParallel() -> bool {
+  const auto threads = exec_ctx_->GetExecutionThreads();
+  if (threads <= 1) {
+    return false;
+  }
+  // Only scan -> filter -> aggregate pipelines run in parallel.
+  const AbstractExpression *predicate = nullptr;
+  auto child_plan = plan_->GetChildPlan();
+  if (child_plan->GetType() == PlanType::Filter) {
+    const auto &filter_plan = dynamic_cast<const FilterPlanNode &>(*child_plan);
+    predicate = filter_plan.GetPredicate().get();
+    child_plan = filter_plan.GetChildPlan();
+  }
+  if (child_plan->GetType() != PlanType::SeqScan) {
+    return false;
+  }
+  const auto &scan_plan = dynamic_cast<const SeqScanPlanNode &>(*child_plan);
+  const auto oid = scan_plan.GetTableOid();
+
+  // The workers read whole pages without locking rows, so the table has to be locked in shared mode instead.
+  auto txn = exec_ctx_->GetTransaction();
+  bool unlock_table = false;
+  if (txn->GetIsolationLevel() != IsolationLevel::READ_UNCOMMITTED && !txn->IsTableSharedLocked(oid) &&
+      !txn->IsTableSharedIntentionExclusiveLocked(oid) && !txn->IsTableExclusiveLocked(oid)) {
+    if (txn->IsTableIntentionExclusiveLocked(oid)) {
+      // IX cannot be upgraded to S, scan row by row instead.
+      return false;
+    }
+    unlock_table =
+        txn->GetIsolationLevel() == IsolationLevel::READ_COMMITTED && !txn->IsTableIntentionSharedLocked(oid);
+    try {
+      if (!exec_ctx_->GetLockManager()->LockTable(txn, LockManager::LockMode::SHARED, oid)) {
+        throw ExecutionException("AggregationExecutor fails to lock table");
+      }
+    } catch (TransactionAbortException &e) {
+      throw ExecutionException(e.GetInfo());
+    }
+  }
+
+  auto bpm = exec_ctx_->GetBufferPoolManager();
+  MorselQueue queue{bpm, exec_ctx_->GetCatalog()->GetTable(oid)->table_->GetFirstPageId()};
+  std::vector<SimpleAggregationHashTable> partials;
+  partials.reserve(threads);
+  std::vector<std::exception_ptr> errors(threads);
+  std::vector<std::thread> workers;
+  workers.reserve(threads);
+  for (size_t i = 0; i < threads; i++) {
+    try {
+      partials.emplace_back(plan_->GetAggregates(), plan_->GetAggregateTypes());
+      workers.emplace_back([&, i] {
+        try {
+          // Every worker runs its own copy of the pipeline.
+          MorselScanner scanner{&queue, bpm, txn, &scan_plan.OutputSchema()};
+          std::optional<ExpressionProgram> filter;
+          if (predicate != nullptr) {
+            filter.emplace(*predicate);
+          }
+          TupleBatch batch{&scan_plan.OutputSchema()};
+          while (scanner.NextBatch(&batch)) {
+            if (filter.has_value()) {
+              batch.SetSelection(filter->Select(batch));
+            }
+            AggregateBatch(batch, &partials[i]);
+          }
+        } catch (...) {
+          errors[i] = std::current_exception();
+          queue.Close();
+        }
+      });
+    } catch (...) {
+      // The threads already started are joined below, and the error is thrown once the table is unlocked.
+      errors[i] = std::current_exception();
+      queue.Close();
+      break;
+    }
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  if (unlock_table && !exec_ctx_->GetLockManager()->UnlockTable(txn, oid)) {
+    txn->LockTxn();
+    txn->SetState(TransactionState::ABORTED);
+    txn->UnlockTxn();
+  }
+  for (const auto &error : errors) {
+    if (error != nullptr) {
+      std::rethrow_exception(error);
+    }
+  }
+  for (auto &partial : partials) {
+    for (auto iter = partial.Begin(); iter != partial.End(); ++iter) {
+      aht_.InsertMerge(iter.Key(), iter.Val());
+    }
+  }
+  return true;
+}
+
 /**
  *  output format: [group_bys_] , [aggregates_]
  */
 auto AggregationExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   // TODO(Hoo): Problem might be cause by rid, but I do not know the use of rid.
+  std::vector<Value> values;
+  if (!NextValues(&values)) {
+    return false;
+  }
+  *tuple = Tuple(values, plan_->output_schema_.get());
+  return true;
+}
+
+auto AggregationExecutor::NextBatch(TupleBatch *batch) -> bool {
+  batch->Reset(plan_->output_schema_.get());
+  std::vector<Value> values;
+  while (!batch->IsFull() && NextValues(&values)) {
+    batch->Append(std::move(values), RID{});
+  }
+  return !batch->IsEmpty();
+}
+
+auto AggregationExecutor::NextValues(std::vector<Value> *values) -> bool {
   if (empty_status_ == EmptyStatus::kEmpty) {
     empty_status_ = EmptyStatus::kReturnedForEmpty;
     auto agg_values = aht_.GenerateInitialAggregateValue().aggregates_;
@@ -56,20 +180,19 @@ auto AggregationExecutor::Next(Tuple *tuple, RID *rid) -> bool {
     if (delta_size > 0) {
       return false;
     }
-    *tuple = Tuple{agg_values, plan_->output_schema_.get()};
+    *values = std::move(agg_values);
     return true;
   }
   if (aht_iterator_ == aht_.End()) {
     return false;
   }
-  std::vector<Value> values;
+  values->clear();
   for (const auto &key : aht_iterator_.Key().group_bys_) {
-    values.emplace_back(key);
+    values->emplace_back(key);
   }
   for (const auto &value : aht_iterator_.Val().aggregates_) {
-    values.emplace_back(value);
+    values->emplace_back(value);
   }
-  *tuple = Tuple(values, plan_->output_schema_.get());
   ++aht_iterator_;
   return true;
 }
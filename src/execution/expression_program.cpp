@@ -0,0 +1,400 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// expression_program.cpp
+//
+// Identification: src/execution/expression_program.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/expressions/expression_program.h"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+auto IsInteger(TypeId type) -> bool {
+  return type == TypeId::TINYINT || type == TypeId::SMALLINT || type == TypeId::INTEGER || type == TypeId::BIGINT;
+}
+
+/** @return the integer value widened to 64 bits, which must not be NULL */
+auto ToLane(const Value &value) -> int64_t {
+  switch (value.GetTypeId()) {
+    case TypeId::TINYINT:
+      return value.GetAs<int8_t>();
+    case TypeId::SMALLINT:
+      return value.GetAs<int16_t>();
+    case TypeId::INTEGER:
+      return value.GetAs<int32_t>();
+    case TypeId::BIGINT:
+      return value.GetAs<int64_t>();
+    default:
+      UNREACHABLE("not an integer value");
+  }
+}
+
+/** @return the lane narrowed back to a value of type */
+auto FromLane(TypeId type, int64_t lane) -> Value {
+  switch (type) {
+    case TypeId::TINYINT:
+      return ValueFactory::GetTinyIntValue(static_cast<int8_t>(lane));
+    case TypeId::SMALLINT:
+      return ValueFactory::GetSmallIntValue(static_cast<int16_t>(lane));
+    case TypeId::INTEGER:
+      return ValueFactory::GetIntegerValue(static_cast<int32_t>(lane));
+    case TypeId::BIGINT:
+      return ValueFactory::GetBigIntValue(lane);
+    default:
+      UNREACHABLE("not an integer type");
+  }
+}
+
+/** dst[i] = op(lhs[i], rhs[i]) over plain arrays, so that the compiler can vectorize the loop. */
+template <typename Op>
+void ApplyLanes(const int64_t *lhs, const int64_t *rhs, int64_t *dst, size_t row_count, Op op) {
+  for (size_t i = 0; i < row_count; i++) {
+    dst[i] = op(lhs[i], rhs[i]);
+  }
+}
+
+/** A NULL operand makes the result NULL. */
+void MergeNulls(const uint8_t *lhs, const uint8_t *rhs, uint8_t *dst, size_t row_count) {
+  for (size_t i = 0; i < row_count; i++) {
+    dst[i] = lhs[i] | rhs[i];
+  }
+}
+
+auto CompareValues(const Value &lhs, const Value &rhs, ComparisonType comparison) -> CmpBool {
+  switch (comparison) {
+    case ComparisonType::Equal:
+      return lhs.CompareEquals(rhs);
+    case ComparisonType::NotEqual:
+      return lhs.CompareNotEquals(rhs);
+    case ComparisonType::LessThan:
+      return lhs.CompareLessThan(rhs);
+    case ComparisonType::LessThanOrEqual:
+      return lhs.CompareLessThanEquals(rhs);
+    case ComparisonType::GreaterThan:
+      return lhs.CompareGreaterThan(rhs);
+    case ComparisonType::GreaterThanOrEqual:
+      return lhs.CompareGreaterThanEquals(rhs);
+    default:
+      UNREACHABLE("Unsupported comparison type.");
+  }
+}
+
+}  // namespace
+
+ExpressionProgram::ExpressionProgram(const AbstractExpression &expr) { result_ = Compile(expr); }
+
+auto ExpressionProgram::Emit(Instruction instruction, RegisterKind kind, TypeId type) -> uint32_t {
+  instruction.dst_ = static_cast<uint32_t>(registers_.size());
+  registers_.push_back(Register{kind, type, {}, {}, {}});
+  instructions_.push_back(instruction);
+  return instruction.dst_;
+}
+
+auto ExpressionProgram::Compile(const AbstractExpression &expr) -> uint32_t {
+  if (const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(&expr); column_expr != nullptr) {
+    // A column read by several parts of the expression is loaded once.
+    if (auto iter = column_registers_.find(column_expr->GetColIdx()); iter != column_registers_.end()) {
+      return iter->second;
+    }
+    Instruction load{OpCode::LoadColumn, 0};
+    load.column_ = column_expr->GetColIdx();
+    const auto reg = Emit(load, RegisterKind::Value, expr.GetReturnType());
+    column_registers_.emplace(column_expr->GetColIdx(), reg);
+    return reg;
+  }
+  if (const auto *constant_expr = dynamic_cast<const ConstantValueExpression *>(&expr); constant_expr != nullptr) {
+    const auto type = constant_expr->val_.GetTypeId();
+    auto kind = RegisterKind::Value;
+    if (IsInteger(type)) {
+      kind = RegisterKind::Integer;
+    } else if (type == TypeId::BOOLEAN) {
+      kind = RegisterKind::Boolean;
+    }
+    Instruction load{OpCode::LoadConstant, 0};
+    load.expr_ = &expr;
+    return Emit(load, kind, type);
+  }
+  if (const auto *cmp_expr = dynamic_cast<const ComparisonExpression *>(&expr); cmp_expr != nullptr) {
+    auto lhs = Compile(*cmp_expr->GetChildAt(0));
+    auto rhs = Compile(*cmp_expr->GetChildAt(1));
+    Instruction compare{OpCode::CompareIntegers, 0};
+    if (IsInteger(registers_[lhs].type_) && IsInteger(registers_[rhs].type_)) {
+      compare.lhs_ = Convert(lhs, RegisterKind::Integer);
+      compare.rhs_ = Convert(rhs, RegisterKind::Integer);
+    } else {
+      compare.op_ = OpCode::CompareValues;
+      compare.lhs_ = Convert(lhs, RegisterKind::Value);
+      compare.rhs_ = Convert(rhs, RegisterKind::Value);
+    }
+    compare.comparison_ = cmp_expr->comp_type_;
+    return Emit(compare, RegisterKind::Boolean, TypeId::BOOLEAN);
+  }
+  if (const auto *arith_expr = dynamic_cast<const ArithmeticExpression *>(&expr); arith_expr != nullptr) {
+    // Both operands are integers, the expression refuses anything else.
+    Instruction compute{OpCode::Arithmetic, 0};
+    compute.lhs_ = Convert(Compile(*arith_expr->GetChildAt(0)), RegisterKind::Integer);
+    compute.rhs_ = Convert(Compile(*arith_expr->GetChildAt(1)), RegisterKind::Integer);
+    compute.arithmetic_ = arith_expr->compute_type_;
+    return Emit(compute, RegisterKind::Integer, TypeId::INTEGER);
+  }
+  if (const auto *logic_expr = dynamic_cast<const LogicExpression *>(&expr); logic_expr != nullptr) {
+    Instruction compute{OpCode::Logic, 0};
+    compute.lhs_ = Convert(Compile(*logic_expr->GetChildAt(0)), RegisterKind::Boolean);
+    compute.rhs_ = Convert(Compile(*logic_expr->GetChildAt(1)), RegisterKind::Boolean);
+    compute.logic_ = logic_expr->logic_type_;
+    return Emit(compute, RegisterKind::Boolean, TypeId::BOOLEAN);
+  }
+  Instruction evaluate{OpCode::EvaluateTree, 0};
+  evaluate.expr_ = &expr;
+  return Emit(evaluate, RegisterKind::Value, expr.GetReturnType());
+}
+
+auto ExpressionProgram::Convert(uint32_t src, RegisterKind kind) -> uint32_t {
+  if (registers_[src].kind_ == kind) {
+    return src;
+  }
+  if (auto iter = conversions_.find({src, kind}); iter != conversions_.end()) {
+    return iter->second;
+  }
+  Instruction convert{OpCode::ToValue, 0};
+  convert.lhs_ = src;
+  if (kind == RegisterKind::Integer) {
+    BUSTUB_ASSERT(IsInteger(registers_[src].type_), "only integer values are stored in integer registers");
+    convert.op_ = OpCode::ToInteger;
+  } else if (kind == RegisterKind::Boolean) {
+    BUSTUB_ASSERT(registers_[src].type_ == TypeId::BOOLEAN, "only boolean values are stored in boolean registers");
+    convert.op_ = OpCode::ToBoolean;
+  }
+  const auto reg = Emit(convert, kind, registers_[src].type_);
+  conversions_.emplace(std::make_pair(src, kind), reg);
+  return reg;
+}
+
+auto ExpressionProgram::GetValue(const Register &reg, size_t row) -> Value {
+  switch (reg.kind_) {
+    case RegisterKind::Integer:
+      return reg.nulls_[row] != 0 ? ValueFactory::GetNullValueByType(reg.type_) : FromLane(reg.type_, reg.lanes_[row]);
+    case RegisterKind::Boolean:
+      return reg.nulls_[row] != 0 ? ValueFactory::GetNullValueByType(TypeId::BOOLEAN)
+                                  : ValueFactory::GetBooleanValue(reg.lanes_[row] != 0);
+    case RegisterKind::Value:
+      return reg.values_[row];
+  }
+  UNREACHABLE("Unsupported register kind.");
+}
+
+auto ExpressionProgram::Evaluate(const Tuple *tuple, const Schema &schema) -> Value {
+  Run({nullptr, tuple, &schema});
+  return GetValue(registers_[result_], 0);
+}
+
+auto ExpressionProgram::EvaluateBatch(const TupleBatch &batch) -> std::vector<Value> {
+  Run({&batch, nullptr, &batch.GetSchema()});
+  auto &result = registers_[result_];
+  if (result.kind_ == RegisterKind::Value) {
+    return std::move(result.values_);
+  }
+  std::vector<Value> values;
+  values.reserve(batch.GetSelection().size());
+  for (size_t i = 0; i < batch.GetSelection().size(); i++) {
+    values.emplace_back(GetValue(result, i));
+  }
+  return values;
+}
+
+auto ExpressionProgram::IsTrue(const Tuple *tuple, const Schema &schema) -> bool {
+  const auto value = Evaluate(tuple, schema);
+  return !value.IsNull() && value.GetAs<bool>();
+}
+
+auto ExpressionProgram::Select(const TupleBatch &batch) -> std::vector<uint32_t> {
+  Run({&batch, nullptr, &batch.GetSchema()});
+  const auto &result = registers_[result_];
+  const auto &rows = batch.GetSelection();
+  std::vector<uint32_t> selection;
+  selection.reserve(rows.size());
+  if (result.kind_ == RegisterKind::Boolean) {
+    for (size_t i = 0; i < rows.size(); i++) {
+      if (result.nulls_[i] == 0 && result.lanes_[i] != 0) {
+        selection.emplace_back(rows[i]);
+      }
+    }
+    return selection;
+  }
+  for (size_t i = 0; i < rows.size(); i++) {
+    const auto value = GetValue(result, i);
+    if (!value.IsNull() && value.GetAs<bool>()) {
+      selection.emplace_back(rows[i]);
+    }
+  }
+  return selection;
+}
+
+void ExpressionProgram::Run(const Input &input) {
+  const auto row_count = input.RowCount();
+  for (const auto &instruction : instructions_) {
+    auto &dst = registers_[instruction.dst_];
+    if (dst.kind_ == RegisterKind::Value) {
+      dst.values_.resize(row_count);
+    } else {
+      dst.lanes_.resize(row_count);
+      dst.nulls_.resize(row_count);
+    }
+    Execute(instruction, input, row_count);
+  }
+}
+
+void ExpressionProgram::Execute(const Instruction &instruction, const Input &input, size_t row_count) {
+  auto &dst = registers_[instruction.dst_];
+  const auto &lhs = registers_[instruction.lhs_];
+  const auto &rhs = registers_[instruction.rhs_];
+  switch (instruction.op_) {
+    case OpCode::LoadColumn:
+      if (input.batch_ == nullptr) {
+        dst.values_[0] = input.tuple_->GetValue(input.schema_, instruction.column_);
+        return;
+      }
+      {
+        const auto &column = input.batch_->GetColumn(instruction.column_);
+        const auto &rows = input.batch_->GetSelection();
+        for (size_t i = 0; i < row_count; i++) {
+          dst.values_[i] = column[rows[i]];
+        }
+      }
+      return;
+    case OpCode::LoadConstant: {
+      const auto &value = dynamic_cast<const ConstantValueExpression *>(instruction.expr_)->val_;
+      if (dst.kind_ == RegisterKind::Value) {
+        std::fill(dst.values_.begin(), dst.values_.end(), value);
+        return;
+      }
+      int64_t lane = 0;
+      if (!value.IsNull()) {
+        lane = dst.kind_ == RegisterKind::Integer ? ToLane(value) : value.GetAs<int8_t>();
+      }
+      std::fill(dst.lanes_.begin(), dst.lanes_.end(), lane);
+      std::fill(dst.nulls_.begin(), dst.nulls_.end(), value.IsNull() ? 1 : 0);
+      return;
+    }
+    case OpCode::EvaluateTree:
+      if (input.batch_ == nullptr) {
+        dst.values_[0] = instruction.expr_->Evaluate(input.tuple_, *input.schema_);
+      } else {
+        dst.values_ = instruction.expr_->EvaluateBatch(*input.batch_);
+      }
+      return;
+    case OpCode::ToInteger:
+    case OpCode::ToBoolean:
+      for (size_t i = 0; i < row_count; i++) {
+        const auto &value = lhs.values_[i];
+        dst.nulls_[i] = value.IsNull() ? 1 : 0;
+        if (value.IsNull()) {
+          dst.lanes_[i] = 0;
+        } else {
+          dst.lanes_[i] = instruction.op_ == OpCode::ToInteger ? ToLane(value) : value.GetAs<int8_t>() != 0;
+        }
+      }
+      return;
+    case OpCode::ToValue:
+      for (size_t i = 0; i < row_count; i++) {
+        dst.values_[i] = GetValue(lhs, i);
+      }
+      return;
+    case OpCode::CompareIntegers: {
+      const auto *l = lhs.lanes_.data();
+      const auto *r = rhs.lanes_.data();
+      auto *d = dst.lanes_.data();
+      switch (instruction.comparison_) {
+        case ComparisonType::Equal:
+          ApplyLanes(l, r, d, row_count, std::equal_to<>{});
+          break;
+        case ComparisonType::NotEqual:
+          ApplyLanes(l, r, d, row_count, std::not_equal_to<>{});
+          break;
+        case ComparisonType::LessThan:
+          ApplyLanes(l, r, d, row_count, std::less<>{});
+          break;
+        case ComparisonType::LessThanOrEqual:
+          ApplyLanes(l, r, d, row_count, std::less_equal<>{});
+          break;
+        case ComparisonType::GreaterThan:
+          ApplyLanes(l, r, d, row_count, std::greater<>{});
+          break;
+        case ComparisonType::GreaterThanOrEqual:
+          ApplyLanes(l, r, d, row_count, std::greater_equal<>{});
+          break;
+      }
+      MergeNulls(lhs.nulls_.data(), rhs.nulls_.data(), dst.nulls_.data(), row_count);
+      return;
+    }
+    case OpCode::CompareValues:
+      for (size_t i = 0; i < row_count; i++) {
+        const auto result = CompareValues(lhs.values_[i], rhs.values_[i], instruction.comparison_);
+        dst.lanes_[i] = result == CmpBool::CmpTrue ? 1 : 0;
+        dst.nulls_[i] = result == CmpBool::CmpNull ? 1 : 0;
+      }
+      return;
+    case OpCode::Arithmetic: {
+      // The lanes hold 32-bit integers, which wrap around as the expression does.
+      const auto *l = lhs.lanes_.data();
+      const auto *r = rhs.lanes_.data();
+      auto *d = dst.lanes_.data();
+      switch (instruction.arithmetic_) {
+        case ArithmeticType::Plus:
+          ApplyLanes(l, r, d, row_count, [](int64_t a, int64_t b) { return static_cast<int32_t>(a + b); });
+          break;
+        case ArithmeticType::Minus:
+          ApplyLanes(l, r, d, row_count, [](int64_t a, int64_t b) { return static_cast<int32_t>(a - b); });
+          break;
+      }
+      MergeNulls(lhs.nulls_.data(), rhs.nulls_.data(), dst.nulls_.data(), row_count);
+      return;
+    }
+    case OpCode::Logic: {
+      // Three-valued logic: a known operand can decide the result even if the other is NULL.
+      const auto *l = lhs.lanes_.data();
+      const auto *r = rhs.lanes_.data();
+      const auto *ln = lhs.nulls_.data();
+      const auto *rn = rhs.nulls_.data();
+      auto *d = dst.lanes_.data();
+      auto *dn = dst.nulls_.data();
+      if (instruction.logic_ == LogicType::And) {
+        for (size_t i = 0; i < row_count; i++) {
+          const auto l_true = ln[i] == 0 && l[i] != 0;
+          const auto r_true = rn[i] == 0 && r[i] != 0;
+          const auto any_false = (ln[i] == 0 && l[i] == 0) || (rn[i] == 0 && r[i] == 0);
+          d[i] = l_true && r_true;
+          dn[i] = !any_false && !(l_true && r_true);
+        }
+      } else {
+        for (size_t i = 0; i < row_count; i++) {
+          const auto any_true = (ln[i] == 0 && l[i] != 0) || (rn[i] == 0 && r[i] != 0);
+          const auto l_false = ln[i] == 0 && l[i] == 0;
+          const auto r_false = rn[i] == 0 && r[i] == 0;
+          d[i] = any_true;
+          dn[i] = !any_true && !(l_false && r_false);
+        }
+      }
+      return;
+    }
+  }
+}
+
+}  // namespace bustub
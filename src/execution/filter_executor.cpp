@@ -6,7 +6,10 @@ namespace bustub {
 
 FilterExecutor::FilterExecutor(ExecutorContext *exec_ctx, const FilterPlanNode *plan,
                                std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_executor_(std::move(child_executor)),
+      predicate_(*plan_->GetPredicate()) {}
 
 void FilterExecutor::Init() {
   // Initialize the child executor
@@ -14,8 +17,6 @@ void FilterExecutor::Init() {
 }
 
 auto FilterExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  auto filter_expr = plan_->GetPredicate();
-
   while (true) {
     // Get the next tuple
     const auto status = child_executor_->Next(tuple, rid);
@@ -24,11 +25,22 @@ auto FilterExecutor::Next(Tuple *tuple, RID *rid) -> bool {
       return false;
     }
 
-    auto value = filter_expr->Evaluate(tuple, child_executor_->GetOutputSchema());
-    if (!value.IsNull() && value.GetAs<bool>()) {
+    if (predicate_.IsTrue(tuple, child_executor_->GetOutputSchema())) {
+      return true;
+    }
+  }
+}
+
+auto FilterExecutor::NextBatch(TupleBatch *batch) -> bool {
+  while (child_executor_->NextBatch(batch)) {
+    // Keep the rows the predicate holds for selected, no value is moved
+    batch->SetSelection(predicate_.Select(*batch));
+
+    if (!batch->IsEmpty()) {
       return true;
     }
   }
+  return false;
 }
 
 }  // namespace bustub
@@ -10,6 +10,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <thread>  // NOLINT
+
 #include "execution/executors/hash_join_executor.h"
 #include "type/value_factory.h"
 
@@ -18,6 +24,41 @@
 // tests.
 
 namespace bustub {
+
+namespace {
+
+/** Run work(worker) on threads workers and wait for all of them, rethrowing the first exception thrown. */
+void RunWorkers(size_t threads, const std::function<void(size_t)> &work) {
+  std::vector<std::exception_ptr> errors(threads);
+  std::vector<std::thread> workers;
+  workers.reserve(threads);
+  for (size_t i = 0; i < threads; i++) {
+    try {
+      workers.emplace_back([&, i] {
+        try {
+          work(i);
+        } catch (...) {
+          errors[i] = std::current_exception();
+        }
+      });
+    } catch (...) {
+      // No thread for this worker: wait for the ones already running, then throw.
+      errors[i] = std::current_exception();
+      break;
+    }
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  for (const auto &error : errors) {
+    if (error != nullptr) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+}  // namespace
+
 auto operator==(const bustub::Value &x, const bustub::Value &y) -> bool {
   return x.CompareEquals(y) == bustub::CmpBool::CmpTrue;
 }
@@ -30,7 +71,23 @@ HashJoinExecutor::HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlan
       result_generated_(false),
       plan_(plan),
       left_child_(std::move(left_child)),
-      right_child_(std::move(right_child)) {
+      right_child_(std::move(right_child)),
+      memory_limit_(exec_ctx->GetHashJoinMemoryLimit()),
+      level_(0),
+      memory_used_(0),
+      spilled_(false),
+      current_{nullptr, nullptr, 0},
+      left_batch_(&left_child_->GetOutputSchema()),
+      left_pos_(0),
+      matches_(nullptr),
+      match_pos_(0),
+      threads_(exec_ctx->GetExecutionThreads()),
+      partitioned_(false),
+      left_done_(false),
+      radix_bits_(0),
+      probe_partition_(0),
+      result_partition_(0),
+      result_pos_(0) {
   if (plan->GetJoinType() != JoinType::LEFT && plan->GetJoinType() != JoinType::INNER) {
     // Note for 2022 Fall: You ONLY need to implement left join and inner join.
     throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
@@ -38,61 +95,371 @@ HashJoinExecutor::HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlan
 }
 
 void HashJoinExecutor::Init() {
-  if (!result_generated_) {
+  if (!result_generated_ || spilled_) {
     result_generated_ = true;
-    left_child_->Init();
     right_child_->Init();
-    Build();
-    done_ = !left_child_->Next(&current_left_tuple_, &current_left_rid_);
+    std::vector<TupleBatch> batches;
+    partitioned_ = threads_ > 1 && Materialize(right_child_.get(), memory_limit_, &batches);
+    if (partitioned_) {
+      BuildPartitioned(std::move(batches));
+    } else {
+      // Whatever was materialized already is built first, then the rest of the right child.
+      size_t next_batch = 0;
+      Build(
+          [&](TupleBatch *batch) {
+            if (next_batch < batches.size()) {
+              *batch = std::move(batches[next_batch++]);
+              return true;
+            }
+            return right_child_->NextBatch(batch);
+          },
+          0);
+      spilled_ = std::any_of(right_spills_.cbegin(), right_spills_.cend(),
+                             [](const auto &spill) { return spill != nullptr; });
+    }
   }
+  // Without spilling the hash table is kept, only the left side is probed again.
+  left_child_->Init();
+  left_source_ = [this](TupleBatch *batch) { return left_child_->NextBatch(batch); };
+  pending_.clear();
+  current_ = {nullptr, nullptr, 0};
+  done_ = false;
+  left_keys_.clear();
+  left_pos_ = 0;
+  matches_ = nullptr;
+  match_pos_ = 0;
+  left_done_ = false;
+  left_chunk_ = PartitionedInput{};
+  probe_partition_ = partitions_.size();
+  results_.clear();
+  result_partition_ = 0;
+  result_pos_ = 0;
 }
 
 auto HashJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-START:
-  if (done_) {
+  std::vector<Value> values;
+  if (!NextValues(&values)) {
+    return false;
+  }
+  *tuple = Tuple(std::move(values), &GetOutputSchema());
+  return true;
+}
+
+auto HashJoinExecutor::NextBatch(TupleBatch *batch) -> bool {
+  batch->Reset(&GetOutputSchema());
+  std::vector<Value> values;
+  while (!batch->IsFull() && NextValues(&values)) {
+    batch->Append(std::move(values), RID{});
+  }
+  return !batch->IsEmpty();
+}
+
+auto HashJoinExecutor::NextValues(std::vector<Value> *values) -> bool {
+  while (partitioned_) {
+    // The partitioned join probes a chunk of the left side a few partitions at a time, their results are emitted in
+    // between.
+    while (result_partition_ < results_.size()) {
+      auto &rows = results_[result_partition_];
+      if (result_pos_ < rows.size()) {
+        *values = std::move(rows[result_pos_++]);
+        return true;
+      }
+      std::vector<std::vector<Value>>().swap(rows);
+      result_partition_++;
+      result_pos_ = 0;
+    }
+    if (left_done_ && probe_partition_ == partitions_.size()) {
+      return false;
+    }
+    ProbePartitioned();
+  }
+  while (!done_) {
+    if (left_pos_ == left_keys_.size()) {
+      // Probe with the join keys of a whole batch of left tuples.
+      if (!left_source_(&left_batch_)) {
+        if (!NextPass()) {
+          done_ = true;
+        }
+        continue;
+      }
+      left_keys_ = plan_->LeftJoinKeyExpression().EvaluateBatch(left_batch_);
+      SpillLeftBatch();
+      left_pos_ = 0;
+      Probe();
+      continue;
+    }
+    const auto left_row = left_batch_.GetSelection()[left_pos_];
+    if (matches_ != nullptr && match_pos_ < matches_->size()) {
+      *values = left_batch_.GetRowValues(left_row);
+      const auto &right_values = (*matches_)[match_pos_++];
+      values->insert(values->end(), right_values.cbegin(), right_values.cend());
+      return true;
+    }
+    const auto matched = matches_ != nullptr;
+    ++left_pos_;
+    Probe();
+    if (!matched && plan_->GetJoinType() == JoinType::LEFT) {
+      *values = left_batch_.GetRowValues(left_row);
+      const auto &right_schema = right_child_->GetOutputSchema();
+      for (uint32_t i = 0; i < right_schema.GetColumnCount(); ++i) {
+        values->emplace_back(ValueFactory::GetNullValueByType(right_schema.GetColumn(i).GetType()));
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+void HashJoinExecutor::Probe() {
+  matches_ = left_pos_ < left_keys_.size() ? hash_table_.Find(left_keys_[left_pos_]) : nullptr;
+  match_pos_ = 0;
+}
+
+auto HashJoinExecutor::EstimateSize(const std::vector<Value> &values) -> size_t {
+  auto size = sizeof(values) + values.size() * sizeof(Value);
+  for (const auto &value : values) {
+    if (value.GetTypeId() == TypeId::VARCHAR && !value.IsNull()) {
+      size += value.GetLength();
+    }
+  }
+  return size;
+}
+
+auto HashJoinExecutor::EstimateSize(const TupleBatch &batch) -> size_t {
+  const auto &rows = batch.GetSelection();
+  auto size = rows.size() * (sizeof(std::vector<Value>) + batch.GetSchema().GetColumnCount() * sizeof(Value));
+  for (uint32_t c = 0; c < batch.GetSchema().GetColumnCount(); c++) {
+    if (batch.GetSchema().GetColumn(c).GetType() != TypeId::VARCHAR) {
+      continue;
+    }
+    for (const auto row : rows) {
+      const auto &value = batch.GetValue(row, c);
+      size += value.IsNull() ? 0 : value.GetLength();
+    }
+  }
+  return size;
+}
+
+auto HashJoinExecutor::Materialize(AbstractExecutor *child, size_t memory_limit, std::vector<TupleBatch> *batches)
+    -> bool {
+  size_t size = 0;
+  while (true) {
+    batches->emplace_back(&child->GetOutputSchema());
+    if (!child->NextBatch(&batches->back())) {
+      batches->pop_back();
+      return true;
+    }
+    size += EstimateSize(batches->back());
+    if (size > memory_limit) {
+      return false;
+    }
+  }
+}
+
+void HashJoinExecutor::Build(const BatchSource &right, uint32_t level) {
+  hash_table_.Clear();
+  level_ = level;
+  right_spills_.clear();
+  right_spills_.resize(HASH_JOIN_SPILL_PARTITIONS);
+  left_spills_.clear();
+  left_spills_.resize(HASH_JOIN_SPILL_PARTITIONS);
+  resident_bytes_.assign(HASH_JOIN_SPILL_PARTITIONS, 0);
+  memory_used_ = 0;
+
+  // Build using the right tuples, a batch at a time.
+  TupleBatch batch{&right_child_->GetOutputSchema()};
+  while (right(&batch)) {
+    const auto keys = plan_->RightJoinKeyExpression().EvaluateBatch(batch);
+    const auto &rows = batch.GetSelection();
+    for (size_t i = 0; i < rows.size(); i++) {
+      // A NULL key equals no other, the tuple never joins.
+      if (keys[i].IsNull()) {
+        continue;
+      }
+      const auto partition = SpillPartitionOf(keys[i]);
+      if (right_spills_[partition] != nullptr) {
+        right_spills_[partition]->Append(batch.GetTuple(rows[i]));
+        continue;
+      }
+      auto values = batch.GetRowValues(rows[i]);
+      const auto size = EstimateSize(values);
+      resident_bytes_[partition] += size;
+      memory_used_ += size;
+      hash_table_.Insert(keys[i], std::move(values));
+      // A partition that still does not fit after being split this many times is kept in memory regardless.
+      while (memory_used_ > memory_limit_ && level_ < HASH_JOIN_MAX_SPILL_LEVELS && SpillLargestPartition()) {
+      }
+    }
+  }
+}
+
+auto HashJoinExecutor::SpillLargestPartition() -> bool {
+  const auto largest = std::max_element(resident_bytes_.cbegin(), resident_bytes_.cend()) - resident_bytes_.cbegin();
+  if (resident_bytes_[largest] == 0) {
     return false;
   }
-  Tuple right_tuple;
-  RID right_rid;
-  auto left_key = plan_->LeftJoinKeyExpression().Evaluate(&current_left_tuple_, left_child_->GetOutputSchema());
-  if (hash_table_.Find(left_key, right_tuple, right_rid)) {
-    std::vector<Value> values;
-    AddTupleValuesTo(values, &current_left_tuple_, left_child_->GetOutputSchema());
-    AddTupleValuesTo(values, &right_tuple, right_child_->GetOutputSchema());
-    *tuple = Tuple(std::move(values), &GetOutputSchema());
-    return true;
+  const auto &schema = right_child_->GetOutputSchema();
+  auto spill = std::make_unique<SpillFile>(exec_ctx_->GetBufferPoolManager(), &schema);
+  hash_table_.RemoveIf([&](const Value &key) { return SpillPartitionOf(key) == static_cast<size_t>(largest); },
+                       [&](std::vector<Value> &&row) { spill->Append(Tuple{row, &schema}); });
+  right_spills_[largest] = std::move(spill);
+  memory_used_ -= resident_bytes_[largest];
+  resident_bytes_[largest] = 0;
+  return true;
+}
+
+void HashJoinExecutor::SpillLeftBatch() {
+  if (std::none_of(right_spills_.cbegin(), right_spills_.cend(), [](const auto &spill) { return spill != nullptr; })) {
+    return;
+  }
+  const auto &rows = left_batch_.GetSelection();
+  std::vector<uint32_t> selection;
+  std::vector<Value> keys;
+  for (size_t i = 0; i < rows.size(); i++) {
+    const auto partition = SpillPartitionOf(left_keys_[i]);
+    if (right_spills_[partition] == nullptr) {
+      selection.emplace_back(rows[i]);
+      keys.emplace_back(std::move(left_keys_[i]));
+      continue;
+    }
+    if (left_spills_[partition] == nullptr) {
+      left_spills_[partition] =
+          std::make_unique<SpillFile>(exec_ctx_->GetBufferPoolManager(), &left_child_->GetOutputSchema());
+    }
+    left_spills_[partition]->Append(left_batch_.GetTuple(rows[i]));
   }
-  if (plan_->GetJoinType() == JoinType::LEFT && !hash_table_.Contain(left_key)) {
-    std::vector<Value> values;
-    AddTupleValuesTo(values, &current_left_tuple_, left_child_->GetOutputSchema());
-    const auto column_count = right_child_->GetOutputSchema().GetColumnCount();
-    for (uint32_t i = 0; i < column_count; ++i) {
-      values.emplace_back(ValueFactory::GetNullValueByType(right_child_->GetOutputSchema().GetColumn(i).GetType()));
+  if (selection.size() != rows.size()) {
+    left_batch_.SetSelection(std::move(selection));
+    left_keys_ = std::move(keys);
+  }
+}
+
+auto HashJoinExecutor::NextPass() -> bool {
+  // Partitions without left tuples produce nothing, for left joins as well.
+  for (size_t partition = 0; partition < right_spills_.size(); partition++) {
+    if (right_spills_[partition] != nullptr && left_spills_[partition] != nullptr) {
+      pending_.push_back({std::move(right_spills_[partition]), std::move(left_spills_[partition]), level_ + 1});
     }
-    *tuple = Tuple(std::move(values), &GetOutputSchema());
-    done_ = !left_child_->Next(&current_left_tuple_, &current_left_rid_);
-    return true;
   }
-  hash_table_.Reset(plan_->LeftJoinKeyExpression().Evaluate(&current_left_tuple_, left_child_->GetOutputSchema()));
-  done_ = !left_child_->Next(&current_left_tuple_, &current_left_rid_);
-  goto START;
+  for (size_t partition = 0; partition < right_spills_.size(); partition++) {
+    right_spills_[partition].reset();
+    left_spills_[partition].reset();
+  }
+  if (pending_.empty()) {
+    return false;
+  }
+  current_ = std::move(pending_.back());
+  pending_.pop_back();
+  Build([this](TupleBatch *batch) { return current_.right_->NextBatch(batch); }, current_.level_);
+  left_source_ = [this](TupleBatch *batch) { return current_.left_->NextBatch(batch); };
+  left_keys_.clear();
+  left_pos_ = 0;
+  matches_ = nullptr;
+  match_pos_ = 0;
+  return true;
 }
 
-void HashJoinExecutor::Build() {
-  // Build using the right table.
-  Tuple tuple;
-  RID rid;
-  while (right_child_->Next(&tuple, &rid)) {
-    hash_table_.Insert(plan_->RightJoinKeyExpression().Evaluate(&tuple, right_child_->GetOutputSchema()), tuple, rid);
+void HashJoinExecutor::Partition(PartitionedInput *input, const AbstractExpression &key_expr) const {
+  const auto num_partitions = partitions_.size();
+  input->keys_.resize(input->batches_.size());
+  input->rows_.assign(threads_, std::vector<std::vector<std::pair<uint32_t, uint32_t>>>(num_partitions));
+  RunWorkers(threads_, [&](size_t worker) {
+    auto &rows = input->rows_[worker];
+    // Every worker takes every threads_'th batch.
+    for (size_t b = worker; b < input->batches_.size(); b += threads_) {
+      input->keys_[b] = key_expr.EvaluateBatch(input->batches_[b]);
+      const auto &keys = input->keys_[b];
+      for (size_t i = 0; i < keys.size(); i++) {
+        rows[PartitionOf(std::hash<Value>{}(keys[i]))].emplace_back(b, i);
+      }
+    }
+  });
+}
+
+void HashJoinExecutor::BuildPartitioned(std::vector<TupleBatch> batches) {
+  PartitionedInput right;
+  right.batches_ = std::move(batches);
+  size_t num_rows = 0;
+  for (const auto &batch : right.batches_) {
+    num_rows += batch.GetSelection().size();
+  }
+  // Enough partitions to keep every worker busy and each hash table small.
+  radix_bits_ = 0;
+  while ((size_t{1} << radix_bits_) < threads_ || (size_t{1} << radix_bits_) * HASH_JOIN_PARTITION_ROWS < num_rows) {
+    radix_bits_++;
   }
+  partitions_ = std::vector<HashTable>(size_t{1} << radix_bits_);
+  Partition(&right, plan_->RightJoinKeyExpression());
+
+  std::atomic<size_t> next_partition{0};
+  RunWorkers(threads_, [&](size_t /* worker */) {
+    for (auto p = next_partition++; p < partitions_.size(); p = next_partition++) {
+      for (const auto &worker_rows : right.rows_) {
+        for (const auto &[b, i] : worker_rows[p]) {
+          const auto &key = right.keys_[b][i];
+          // A NULL key equals no other, the tuple never joins.
+          if (!key.IsNull()) {
+            const auto &batch = right.batches_[b];
+            partitions_[p].Insert(key, batch.GetRowValues(batch.GetSelection()[i]));
+          }
+        }
+      }
+    }
+  });
 }
 
-void HashJoinExecutor::AddTupleValuesTo(std::vector<Value> &values, bustub::Tuple *tuple,
-                                        const bustub::Schema &schema) {
-  const auto column_count = schema.GetColumnCount();
-  for (uint32_t i = 0; i < column_count; ++i) {
-    values.emplace_back(tuple->GetValue(&schema, i));
+void HashJoinExecutor::ProbePartitioned() {
+  // Half the memory limit holds the chunk, the other half the results of probing it.
+  const auto budget = std::max<size_t>(memory_limit_ / 2, 1);
+  if (probe_partition_ == partitions_.size()) {
+    left_chunk_ = PartitionedInput{};
+    left_done_ = Materialize(left_child_.get(), budget, &left_chunk_.batches_);
+    Partition(&left_chunk_, plan_->LeftJoinKeyExpression());
+    results_.assign(partitions_.size(), {});
+    probe_partition_ = 0;
   }
+
+  const auto &right_schema = right_child_->GetOutputSchema();
+  const auto &left = left_chunk_;
+  result_partition_ = probe_partition_;
+  result_pos_ = 0;
+  std::atomic<size_t> next_partition{probe_partition_};
+  std::atomic<size_t> result_bytes{0};
+  RunWorkers(threads_, [&](size_t /* worker */) {
+    while (result_bytes < budget) {
+      const auto p = next_partition++;
+      if (p >= partitions_.size()) {
+        break;
+      }
+      auto &results = results_[p];
+      size_t bytes = 0;
+      for (const auto &worker_rows : left.rows_) {
+        for (const auto &[b, i] : worker_rows[p]) {
+          const auto &batch = left.batches_[b];
+          const auto row = batch.GetSelection()[i];
+          const auto *matches = partitions_[p].Find(left.keys_[b][i]);
+          if (matches != nullptr) {
+            for (const auto &right_values : *matches) {
+              auto values = batch.GetRowValues(row);
+              values.insert(values.end(), right_values.cbegin(), right_values.cend());
+              bytes += EstimateSize(values);
+              results.emplace_back(std::move(values));
+            }
+          } else if (plan_->GetJoinType() == JoinType::LEFT) {
+            auto values = batch.GetRowValues(row);
+            for (uint32_t c = 0; c < right_schema.GetColumnCount(); ++c) {
+              values.emplace_back(ValueFactory::GetNullValueByType(right_schema.GetColumn(c).GetType()));
+            }
+            bytes += EstimateSize(values);
+            results.emplace_back(std::move(values));
+          }
+        }
+      }
+      result_bytes += bytes;
+    }
+  });
+  // Every partition claimed was probed, so the ones left start right after them.
+  probe_partition_ = std::min(next_partition.load(), partitions_.size());
 }
 
 }  // namespace bustub
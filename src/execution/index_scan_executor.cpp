@@ -17,20 +17,64 @@ IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanP
 
 void IndexScanExecutor::Init() {
   auto index_info = exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexOid());
-  tree_ = dynamic_cast<BPlusTreeIndexForOneIntegerColumn *>(index_info->index_.get());
-  current_iterator_ =
-      std::make_unique<IndexIterator<GenericKey<4>, RID, GenericComparator<4>>>(tree_->GetBeginIterator());
+  cursor_ = index_info->index_->Scan(plan_->GetRange(), exec_ctx_->GetTransaction());
   table_info_ = exec_ctx_->GetCatalog()->GetTable(index_info->table_name_);
+  locked_rids_.clear();
+  // Lock the table, like a sequential scan.
+  try {
+    auto txn = exec_ctx_->GetTransaction();
+    if (txn->GetIsolationLevel() != IsolationLevel::READ_UNCOMMITTED) {
+      auto ok = exec_ctx_->GetLockManager()->LockTable(txn, LockManager::LockMode::INTENTION_SHARED,
+                                                       table_info_->oid_);
+      if (!ok) {
+        throw ExecutionException("IndexScanExecutor fails to lock table");
+      }
+    }
+  } catch (TransactionAbortException &e) {
+    throw ExecutionException(e.GetInfo());
+  }
 }
 
 auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  if (*current_iterator_ == tree_->GetEndIterator()) {
-    return false;
+  for (; !cursor_->IsEnd(); cursor_->Next()) {
+    *rid = cursor_->GetRID();
+    // Lock the row before reading it.
+    try {
+      auto txn = exec_ctx_->GetTransaction();
+      if (txn->GetIsolationLevel() != IsolationLevel::READ_UNCOMMITTED) {
+        auto ok = exec_ctx_->GetLockManager()->LockRow(txn, LockManager::LockMode::SHARED, table_info_->oid_, *rid);
+        if (!ok) {
+          throw ExecutionException("IndexScanExecutor fails to lock row");
+        }
+        locked_rids_.emplace_back(*rid);
+      }
+    } catch (TransactionAbortException &e) {
+      throw ExecutionException(e.GetInfo());
+    }
+    // The entry may point at a tuple deleted since, which is skipped.
+    if (table_info_->table_->GetTuple(*rid, tuple, exec_ctx_->GetTransaction())) {
+      cursor_->Next();
+      return true;
+    }
+  }
+  FinishScan();
+  return false;
+}
+
+void IndexScanExecutor::FinishScan() {
+  // Under read committed the shared row locks are released once the scan is done.
+  auto txn = exec_ctx_->GetTransaction();
+  if (txn->GetIsolationLevel() != IsolationLevel::READ_COMMITTED) {
+    return;
+  }
+  for (const auto &locked_rid : locked_rids_) {
+    if (!exec_ctx_->GetLockManager()->UnlockRow(txn, table_info_->oid_, locked_rid)) {
+      txn->LockTxn();
+      txn->SetState(TransactionState::ABORTED);
+      txn->UnlockTxn();
+    }
   }
-  *rid = (**current_iterator_).second;
-  table_info_->table_->GetTuple(*rid, tuple, exec_ctx_->GetTransaction());
-  ++(*current_iterator_);
-  return true;
+  locked_rids_.clear();
 }
 
 }  // namespace bustub
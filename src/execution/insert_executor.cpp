@@ -35,6 +35,8 @@
  */
 
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "execution/executors/insert_executor.h"
 
@@ -50,6 +52,7 @@ void InsertExecutor::Init() {
   schema_ = std::make_unique<Schema>(table_info->schema_);
   indices_ = std::make_unique<std::vector<IndexInfo *>>(exec_ctx_->GetCatalog()->GetTableIndexes(table_info->name_));
   done_ = false;
+  strategy_ = std::make_unique<BufferAccessStrategy>(exec_ctx_->GetBufferPoolManager()->GetPoolSize());
   // Lock table. IX mode in any isolation level.
   try {
     auto ok = exec_ctx_->GetLockManager()->LockTable(exec_ctx_->GetTransaction(),
@@ -75,7 +78,25 @@ auto InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
   RID rid_to_insert;
   int32_t num_inserted(0);
   Schema schema(std::vector<Column>{Column("size", TypeId::INTEGER)});
+  // Build the index keys of every row before writing any of them, a key too long for its index fails the statement
+  // with the table unchanged.
+  std::vector<std::pair<Tuple, RID>> rows;
+  std::vector<std::vector<Tuple>> index_tuples;
   while (child_executor_->Next(&tuple_to_insert, &rid_to_insert)) {
+    std::vector<Tuple> row_index_tuples;
+    for (auto index_info : *indices_) {
+      auto index_tuple =
+          tuple_to_insert.KeyFromTuple(*schema_, index_info->key_schema_, index_info->index_->GetKeyAttrs());
+      if (index_tuple.GetLength() > index_info->key_size_) {
+        throw ExecutionException("InsertExecutor: key too long for index " + index_info->name_);
+      }
+      row_index_tuples.emplace_back(std::move(index_tuple));
+    }
+    rows.emplace_back(tuple_to_insert, rid_to_insert);
+    index_tuples.emplace_back(std::move(row_index_tuples));
+  }
+  for (size_t i = 0; i < rows.size(); i++) {
+    auto &[tuple_to_insert, rid_to_insert] = rows[i];
     // Lock the row in X mode under any isolation level.
     try {
       auto ok = exec_ctx_->GetLockManager()->LockRow(exec_ctx_->GetTransaction(), LockManager::LockMode::EXCLUSIVE,
@@ -90,11 +111,9 @@ auto InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
     } catch (TransactionAbortException &err) {
       throw ExecutionException(err.GetInfo());
     }
-    table_->InsertTuple(tuple_to_insert, &rid_to_insert, exec_ctx_->GetTransaction());
-    for (auto index_info : *indices_) {
-      Tuple index_tuple =
-          tuple_to_insert.KeyFromTuple(*schema_, index_info->key_schema_, index_info->index_->GetKeyAttrs());
-      index_info->index_->InsertEntry(index_tuple, rid_to_insert, exec_ctx_->GetTransaction());
+    table_->InsertTuple(tuple_to_insert, &rid_to_insert, exec_ctx_->GetTransaction(), strategy_.get());
+    for (size_t j = 0; j < indices_->size(); j++) {
+      (*indices_)[j]->index_->InsertEntry(index_tuples[i][j], rid_to_insert, exec_ctx_->GetTransaction());
     }
     ++num_inserted;
   }
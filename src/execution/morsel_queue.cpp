@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_queue.cpp
+//
+// Identification: src/execution/morsel_queue.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/morsel_queue.h"
+
+#include "common/exception.h"
+#include "common/macros.h"
+#include "storage/page/table_page.h"
+
+namespace bustub {
+
+MorselQueue::MorselQueue(BufferPoolManager *bpm, page_id_t first_page_id, size_t morsel_pages)
+    : bpm_(bpm),
+      morsel_pages_(morsel_pages),
+      next_page_id_(first_page_id),
+      read_ahead_(bpm, [](Page *page) {
+        page->RLatch();
+        auto next_page_id = static_cast<TablePage *>(page)->GetNextPageId();
+        page->RUnlatch();
+        return next_page_id;
+      }) {
+  BUSTUB_ASSERT(morsel_pages_ > 0, "a morsel has to hold at least one page");
+}
+
+auto MorselQueue::Next(std::vector<page_id_t> *page_ids) -> bool {
+  std::scoped_lock lock(latch_);
+  page_ids->clear();
+  while (page_ids->size() < morsel_pages_ && next_page_id_ != INVALID_PAGE_ID) {
+    read_ahead_.Advance(next_page_id_);
+    auto page = static_cast<TablePage *>(bpm_->FetchPage(next_page_id_));
+    BUSTUB_ENSURE(page != nullptr, "BPM full");
+    page->RLatch();
+    page_ids->emplace_back(next_page_id_);
+    next_page_id_ = page->GetNextPageId();
+    page->RUnlatch();
+    bpm_->UnpinPage(page_ids->back(), false);
+  }
+  return !page_ids->empty();
+}
+
+void MorselQueue::Close() {
+  std::scoped_lock lock(latch_);
+  next_page_id_ = INVALID_PAGE_ID;
+}
+
+MorselScanner::MorselScanner(MorselQueue *queue, BufferPoolManager *bpm, Transaction *txn, const Schema *schema)
+    : queue_(queue), bpm_(bpm), txn_(txn), schema_(schema) {}
+
+auto MorselScanner::NextBatch(TupleBatch *batch) -> bool {
+  batch->Reset(schema_);
+  while (!batch->IsFull()) {
+    if (page_pos_ == morsel_.size()) {
+      page_pos_ = 0;
+      if (!queue_->Next(&morsel_)) {
+        break;
+      }
+    }
+    ScanPage(batch);
+  }
+  return !batch->IsEmpty();
+}
+
+void MorselScanner::ScanPage(TupleBatch *batch) {
+  const auto page_id = morsel_[page_pos_];
+  auto page = static_cast<TablePage *>(bpm_->FetchPage(page_id));
+  BUSTUB_ENSURE(page != nullptr, "BPM full");
+  page->RLatch();
+  RID rid;
+  auto found = resume_ ? page->GetNextTupleRid(last_rid_, &rid) : page->GetFirstTupleRid(&rid);
+  Tuple tuple;
+  while (found && !batch->IsFull()) {
+    if (!page->GetTuple(rid, &tuple, txn_, nullptr)) {
+      page->RUnlatch();
+      bpm_->UnpinPage(page_id, false);
+      throw bustub::Exception("read non-existing tuple");
+    }
+    batch->Append(tuple, rid);
+    last_rid_ = rid;
+    found = page->GetNextTupleRid(rid, &rid);
+  }
+  page->RUnlatch();
+  bpm_->UnpinPage(page_id, false);
+  // Come back to the page for the rest of its tuples if the batch filled up first.
+  resume_ = found;
+  if (!found) {
+    page_pos_++;
+  }
+}
+
+}  // namespace bustub
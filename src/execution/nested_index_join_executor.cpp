@@ -24,24 +24,24 @@ NestIndexJoinExecutor::NestIndexJoinExecutor(ExecutorContext *exec_ctx, const Ne
   }
 }
 
-void NestIndexJoinExecutor::Init() { child_executor_->Init(); }
+void NestIndexJoinExecutor::Init() {
+  child_executor_->Init();
+  left_tuples_.clear();
+  results_.clear();
+  cursor_ = 0;
+  match_ = 0;
+}
 
 auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  Tuple left_tuple;
-  RID left_rid;
-  while (child_executor_->Next(&left_tuple, &left_rid)) {
-    // Generate search key.
-    auto &index = exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexOid())->index_;
-    auto key_value = plan_->KeyPredicate()->Evaluate(&left_tuple, child_executor_->GetOutputSchema());
-    std::vector<Value> key;
-    key.emplace_back(key_value);
-    Schema schema(std::vector<Column>{Column("column", key_value.GetTypeId())});
-    Tuple search_key(key, &schema);
-    std::vector<RID> result;
-    index->ScanKey(search_key, &result, exec_ctx_->GetTransaction());
-    auto inner_table = exec_ctx_->GetCatalog()->GetTable(plan_->GetInnerTableOid());
-    if (result.empty()) {
-      if (plan_->GetJoinType() == JoinType::LEFT) {
+  auto inner_table = exec_ctx_->GetCatalog()->GetTable(plan_->GetInnerTableOid());
+  while (cursor_ < left_tuples_.size() || FetchOuterBatch()) {
+    const auto &left_tuple = left_tuples_[cursor_];
+    const auto &result = results_[cursor_];
+    if (match_ == result.size()) {
+      // The outer tuple is joined with every inner tuple of its key, if it has any.
+      cursor_++;
+      match_ = 0;
+      if (result.empty() && plan_->GetJoinType() == JoinType::LEFT) {
         std::vector<Value> values;
         AddTupleValuesTo(values, &left_tuple, child_executor_->GetOutputSchema());
         const auto column_count = inner_table->schema_.GetColumnCount();
@@ -55,7 +55,9 @@ auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
     }
     // Look up inner tuple.
     Tuple right_tuple;
-    assert(inner_table->table_->GetTuple(result.front(), &right_tuple, exec_ctx_->GetTransaction()));
+    if (!inner_table->table_->GetTuple(result[match_++], &right_tuple, exec_ctx_->GetTransaction())) {
+      throw ExecutionException("index points to a missing tuple");
+    }
     std::vector<Value> values;
     AddTupleValuesTo(values, &left_tuple, child_executor_->GetOutputSchema());
     AddTupleValuesTo(values, &right_tuple, inner_table->schema_);
@@ -65,7 +67,35 @@ auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   return false;
 }
 
-void NestIndexJoinExecutor::AddTupleValuesTo(std::vector<Value> &values, bustub::Tuple *tuple,
+auto NestIndexJoinExecutor::FetchOuterBatch() -> bool {
+  left_tuples_.clear();
+  cursor_ = 0;
+  match_ = 0;
+  auto &index = exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexOid())->index_;
+  const auto *key_schema = index->GetKeySchema();
+  std::vector<Tuple> keys;
+  Tuple left_tuple;
+  RID left_rid;
+  while (left_tuples_.size() < INDEX_JOIN_BATCH_SIZE && child_executor_->Next(&left_tuple, &left_rid)) {
+    // Generate search key, one value per index key column.
+    std::vector<Value> key;
+    key.reserve(plan_->KeyPredicates().size());
+    for (const auto &key_predicate : plan_->KeyPredicates()) {
+      auto key_value = key_predicate->Evaluate(&left_tuple, child_executor_->GetOutputSchema());
+      const auto key_type = key_schema->GetColumn(key.size()).GetType();
+      key.emplace_back(key_value.GetTypeId() == key_type ? key_value : key_value.CastAs(key_type));
+    }
+    keys.emplace_back(key, key_schema);
+    left_tuples_.push_back(left_tuple);
+  }
+  if (left_tuples_.empty()) {
+    return false;
+  }
+  index->ScanKeys(keys, &results_, exec_ctx_->GetTransaction());
+  return true;
+}
+
+void NestIndexJoinExecutor::AddTupleValuesTo(std::vector<Value> &values, const bustub::Tuple *tuple,
                                              const bustub::Schema &schema) {
   const auto column_count = schema.GetColumnCount();
   for (uint32_t i = 0; i < column_count; ++i) {
@@ -5,7 +5,15 @@ namespace bustub {
 
 ProjectionExecutor::ProjectionExecutor(ExecutorContext *exec_ctx, const ProjectionPlanNode *plan,
                                        std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_executor_(std::move(child_executor)),
+      child_batch_(&child_executor_->GetOutputSchema()) {
+  programs_.reserve(plan_->GetExpressions().size());
+  for (const auto &expr : plan_->GetExpressions()) {
+    programs_.emplace_back(*expr);
+  }
+}
 
 void ProjectionExecutor::Init() {
   // Initialize the child executor
@@ -25,12 +33,41 @@ auto ProjectionExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   // Compute expressions
   std::vector<Value> values{};
   values.reserve(GetOutputSchema().GetColumnCount());
-  for (const auto &expr : plan_->GetExpressions()) {
-    values.push_back(expr->Evaluate(&child_tuple, child_executor_->GetOutputSchema()));
+  for (auto &program : programs_) {
+    values.push_back(program.Evaluate(&child_tuple, child_executor_->GetOutputSchema()));
   }
 
   *tuple = Tuple{values, &GetOutputSchema()};
 
   return true;
 }
+
+auto ProjectionExecutor::NextBatch(TupleBatch *batch) -> bool {
+  // The child has to hand out no more tuples than the batch holds
+  if (child_batch_.GetCapacity() != batch->GetCapacity()) {
+    child_batch_ = TupleBatch{&child_executor_->GetOutputSchema(), batch->GetCapacity()};
+  }
+
+  // Get the next batch
+  if (!child_executor_->NextBatch(&child_batch_)) {
+    return false;
+  }
+
+  // Compute expressions, a column at a time
+  std::vector<std::vector<Value>> columns{};
+  columns.reserve(GetOutputSchema().GetColumnCount());
+  for (auto &program : programs_) {
+    columns.emplace_back(program.EvaluateBatch(child_batch_));
+  }
+  std::vector<RID> rids{};
+  rids.reserve(child_batch_.GetSelection().size());
+  for (const auto row : child_batch_.GetSelection()) {
+    rids.emplace_back(child_batch_.GetRid(row));
+  }
+
+  batch->Reset(&GetOutputSchema());
+  batch->SetColumns(std::move(columns), std::move(rids));
+
+  return true;
+}
 }  // namespace bustub
@@ -14,6 +14,8 @@
 
 #include "execution/executors/seq_scan_executor.h"
 
+#include "storage/page/table_page.h"
+
 namespace bustub {
 
 SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
@@ -21,8 +23,19 @@ SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNod
 
 void SeqScanExecutor::Init() {
   table_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid())->table_.get();
-  table_current_iterator_ = std::make_unique<TableIterator>(table_->Begin(exec_ctx_->GetTransaction()));
+  strategy_ = std::make_unique<BufferAccessStrategy>(exec_ctx_->GetBufferPoolManager()->GetPoolSize());
+  table_current_iterator_ =
+      std::make_unique<TableIterator>(table_->Begin(exec_ctx_->GetTransaction(), strategy_.get()));
   table_end_iterator_ = std::make_unique<TableIterator>(table_->End());
+  read_ahead_ = std::make_unique<PageReadAhead>(
+      exec_ctx_->GetBufferPoolManager(),
+      [](Page *page) {
+        page->RLatch();
+        auto next_page_id = static_cast<TablePage *>(page)->GetNextPageId();
+        page->RUnlatch();
+        return next_page_id;
+      },
+      READ_AHEAD_PAGES, strategy_.get());
   // Lock the table.
   try {
     auto txn = exec_ctx_->GetTransaction();
@@ -39,31 +52,34 @@ void SeqScanExecutor::Init() {
 }
 
 auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  if (!ScanTuple(tuple, rid)) {
+    FinishScan();
+    return false;
+  }
+  return true;
+}
+
+auto SeqScanExecutor::NextBatch(TupleBatch *batch) -> bool {
+  batch->Reset(&GetOutputSchema());
+  Tuple tuple;
+  RID rid;
+  while (!batch->IsFull() && ScanTuple(&tuple, &rid)) {
+    batch->Append(tuple, rid);
+  }
+  if (batch->IsEmpty()) {
+    FinishScan();
+    return false;
+  }
+  return true;
+}
+
+auto SeqScanExecutor::ScanTuple(Tuple *tuple, RID *rid) -> bool {
   if (*table_current_iterator_ == table_->End()) {
-    // Unlock the rows.
-    if (exec_ctx_->GetTransaction()->GetIsolationLevel() == IsolationLevel::READ_COMMITTED) {
-      std::for_each(locked_rids_.cbegin(), locked_rids_.cend(), [&](const RID &locked_rid) {
-        auto ok = exec_ctx_->GetLockManager()->UnlockRow(exec_ctx_->GetTransaction(), plan_->table_oid_, locked_rid);
-        if (!ok) {
-          exec_ctx_->GetTransaction()->LockTxn();
-          exec_ctx_->GetTransaction()->SetState(TransactionState::ABORTED);
-          exec_ctx_->GetTransaction()->UnlockTxn();
-        }
-      });
-      // Unlock the table.
-      if (exec_ctx_->GetTransaction()->GetIsolationLevel() == IsolationLevel::REPEATABLE_READ) {
-        auto ok = exec_ctx_->GetLockManager()->UnlockTable(exec_ctx_->GetTransaction(), plan_->table_oid_);
-        if (!ok) {
-          exec_ctx_->GetTransaction()->LockTxn();
-          exec_ctx_->GetTransaction()->SetState(TransactionState::ABORTED);
-          exec_ctx_->GetTransaction()->UnlockTxn();
-        }
-      }
-    }
     return false;
   }
   *rid = (*table_current_iterator_)->GetRid();
-  table_->GetTuple(*rid, tuple, exec_ctx_->GetTransaction());
+  read_ahead_->Advance(rid->GetPageId());
+  table_->GetTuple(*rid, tuple, exec_ctx_->GetTransaction(), true, strategy_.get());
   // Lock row.
   try {
     auto txn = exec_ctx_->GetTransaction();
@@ -82,4 +98,28 @@ auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   return true;
 }
 
+void SeqScanExecutor::FinishScan() {
+  // Unlock the rows.
+  if (exec_ctx_->GetTransaction()->GetIsolationLevel() == IsolationLevel::READ_COMMITTED) {
+    std::for_each(locked_rids_.cbegin(), locked_rids_.cend(), [&](const RID &locked_rid) {
+      auto ok = exec_ctx_->GetLockManager()->UnlockRow(exec_ctx_->GetTransaction(), plan_->table_oid_, locked_rid);
+      if (!ok) {
+        exec_ctx_->GetTransaction()->LockTxn();
+        exec_ctx_->GetTransaction()->SetState(TransactionState::ABORTED);
+        exec_ctx_->GetTransaction()->UnlockTxn();
+      }
+    });
+    locked_rids_.clear();
+    // Unlock the table.
+    if (exec_ctx_->GetTransaction()->GetIsolationLevel() == IsolationLevel::REPEATABLE_READ) {
+      auto ok = exec_ctx_->GetLockManager()->UnlockTable(exec_ctx_->GetTransaction(), plan_->table_oid_);
+      if (!ok) {
+        exec_ctx_->GetTransaction()->LockTxn();
+        exec_ctx_->GetTransaction()->SetState(TransactionState::ABORTED);
+        exec_ctx_->GetTransaction()->UnlockTxn();
+      }
+    }
+  }
+}
+
 }  // namespace bustub
@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// spill_file.cpp
+//
+// Identification: src/execution/spill_file.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/spill_file.h"
+
+#include "common/exception.h"
+
+namespace bustub {
+
+SpillFile::SpillFile(BufferPoolManager *bpm, const Schema *schema) : bpm_(bpm), schema_(schema) {}
+
+SpillFile::~SpillFile() {
+  FinishPage();
+  for (auto i = read_page_; i < page_ids_.size(); i++) {
+    bpm_->DeletePage(page_ids_[i]);
+  }
+}
+
+void SpillFile::Append(const Tuple &tuple) {
+  BUSTUB_ASSERT(!reading_, "append after reading started");
+  TmpTuple out{INVALID_PAGE_ID, 0};
+  if (write_page_ != nullptr && write_page_->Insert(tuple, &out)) {
+    tuple_count_++;
+    return;
+  }
+  FinishPage();
+  page_id_t page_id;
+  write_page_ = static_cast<TmpTuplePage *>(bpm_->NewPage(&page_id));
+  if (write_page_ == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate a page to spill tuples to");
+  }
+  write_page_->Init(page_id, BUSTUB_PAGE_SIZE);
+  page_ids_.emplace_back(page_id);
+  if (!write_page_->Insert(tuple, &out)) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "tuple is too large to be spilled");
+  }
+  tuple_count_++;
+}
+
+void SpillFile::FinishPage() {
+  if (write_page_ != nullptr) {
+    bpm_->UnpinPage(page_ids_.back(), true);
+    write_page_ = nullptr;
+  }
+}
+
+auto SpillFile::NextBatch(TupleBatch *batch) -> bool {
+  if (!reading_) {
+    reading_ = true;
+    FinishPage();
+  }
+  batch->Reset(schema_);
+  Tuple tuple;
+  while (!batch->IsFull() && read_page_ < page_ids_.size()) {
+    const auto page_id = page_ids_[read_page_];
+    auto page = static_cast<TmpTuplePage *>(bpm_->FetchPage(page_id));
+    BUSTUB_ENSURE(page != nullptr, "BPM full");
+    if (read_offset_ == 0) {
+      read_offset_ = page->GetFreeSpacePointer();
+    }
+    while (!batch->IsFull() && read_offset_ < BUSTUB_PAGE_SIZE) {
+      read_offset_ = page->Get(read_offset_, &tuple);
+      batch->Append(tuple, RID{});
+    }
+    bpm_->UnpinPage(page_id, false);
+    if (read_offset_ == BUSTUB_PAGE_SIZE) {
+      // The page is never read again.
+      bpm_->DeletePage(page_id);
+      read_page_++;
+      read_offset_ = 0;
+    }
+  }
+  return !batch->IsEmpty();
+}
+
+}  // namespace bustub
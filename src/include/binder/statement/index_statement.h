@@ -32,6 +32,19 @@ class IndexStatement : public BoundStatement {
   /** Name of the columns */
   std::vector<std::unique_ptr<BoundColumnRef>> cols_;
 
+  /** Whether the index stores its keys compressed, WITH (compression) */
+  bool compressed_{false};
+
+  /**
+   * Whether the index is a B-link tree, the default. Writers then latch one page at a time instead of every ancestor
+   * that may split, so inserts at the rightmost leaf do not queue up on the root. Pages are not merged when keys are
+   * removed, WITH (b_link = false) makes a tree that merges them but latches pessimistically.
+   */
+  bool b_link_{true};
+
+  /** Whether keys are unique, CREATE UNIQUE INDEX */
+  bool unique_{false};
+
   auto ToString() const -> std::string override;
 };
 
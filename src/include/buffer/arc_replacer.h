@@ -0,0 +1,117 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.h
+//
+// Identification: src/include/buffer/arc_replacer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/frame_replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * ARCReplacer implements the Adaptive Replacement Cache policy (Megiddo and
+ * Modha, FAST'03).
+ *
+ * Resident frames are split between T1, frames accessed once since they were
+ * loaded, and T2, frames accessed at least twice. The ghost lists B1 and B2
+ * remember the pages recently evicted from T1 and T2. A miss on a ghost page
+ * shifts the target size p of T1 towards the list the page was evicted from,
+ * so the policy balances recency and frequency by itself.
+ *
+ * The buffer pool evicts before it loads the new page, so Evict() cannot tell
+ * whether the incoming page is a B2 ghost; it evicts from T1 iff |T1| > p.
+ * Non-evictable frames are skipped, falling back to the other list.
+ */
+class ARCReplacer : public FrameReplacer {
+ public:
+  /**
+   * @brief Create a new ARCReplacer.
+   * @param num_frames the maximum number of frames the replacer will be required to store
+   */
+  explicit ARCReplacer(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(ARCReplacer);
+
+  ~ARCReplacer() override = default;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto Size() const -> size_t override;
+
+  /** @return the current target size of T1, for tests */
+  auto GetTargetRecentSize() const -> size_t;
+
+ private:
+  enum class ListType { NONE, RECENT, FREQUENT };
+
+  struct FrameEntry {
+    ListType list_{ListType::NONE};
+    bool evictable_{false};
+    page_id_t page_id_{INVALID_PAGE_ID};
+    /** Position in t1_ or t2_, front is the most recently used. */
+    std::list<frame_id_t>::iterator pos_;
+  };
+
+  /** A list of recently evicted page ids, front is the most recent. */
+  struct GhostList {
+    std::list<page_id_t> pages_;
+    std::unordered_map<page_id_t, std::list<page_id_t>::iterator> index_;
+
+    void PushFront(page_id_t page_id);
+    void PopBack();
+    auto Erase(page_id_t page_id) -> bool;
+    auto Size() const -> size_t { return pages_.size(); }
+  };
+
+  inline auto CheckAndHandleFrameID(frame_id_t frame_id) -> void {
+    if (frame_id < 0 || static_cast<size_t>(frame_id) >= replacer_size_) {
+      throw std::out_of_range("Frame id is out of range");
+    }
+  }
+
+  /** @return the least recently used evictable frame of a list, or -1 */
+  auto FindVictim(const std::list<frame_id_t> &list) const -> frame_id_t;
+
+  /** Take a tracked frame out of T1/T2. Caller should hold latch_. */
+  void Untrack(frame_id_t frame_id);
+
+  /** Bound the directory to |T1| + |B1| <= c and |T1| + |T2| + |B1| + |B2| <= 2c. Caller should hold latch_. */
+  void TrimGhosts();
+
+  size_t replacer_size_;
+  size_t size_{0};
+  /** Adaptive target size of T1. */
+  size_t target_recent_size_{0};
+
+  std::vector<FrameEntry> frames_;
+  std::list<frame_id_t> t1_;
+  std::list<frame_id_t> t2_;
+  GhostList b1_;
+  GhostList b2_;
+
+  mutable std::mutex latch_;
+};
+
+}  // namespace bustub
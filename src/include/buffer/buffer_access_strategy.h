@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_access_strategy.h
+//
+// Identification: src/include/buffer/buffer_access_strategy.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+class BufferPoolManagerInstance;
+
+/**
+ * BufferAccessStrategy lets a bulk operation (a sequential scan, a bulk insert)
+ * recycle a small private ring of frames, instead of pushing every page it
+ * touches through the replacer and evicting everybody else's working set.
+ *
+ * The strategy stays inactive until the operation has missed on a quarter of
+ * the pool, so small tables are cached as usual. Once active, every miss reuses
+ * the frame the operation loaded ring-size misses ago, unless somebody else has
+ * pinned or replaced it since, and hits no longer count as accesses in the
+ * replacer.
+ *
+ * A strategy belongs to a single operation and is not thread safe.
+ */
+class BufferAccessStrategy {
+ public:
+  /**
+   * @param pool_size the number of frames of the buffer pool the strategy is used with
+   * @param ring_size the number of frames to recycle, at most a quarter of the pool
+   */
+  explicit BufferAccessStrategy(size_t pool_size, size_t ring_size = BUFFER_RING_PAGES)
+      : ring_(std::max<size_t>(std::min(ring_size, pool_size / 4), 1)), activation_threshold_(pool_size / 4) {}
+
+  /** @return true once the operation recycles its ring instead of using the whole pool */
+  auto IsActive() const -> bool { return num_misses_ >= activation_threshold_; }
+
+  /** @return the number of frames in the ring */
+  auto GetRingSize() const -> size_t { return ring_.size(); }
+
+ private:
+  friend class BufferPoolManagerInstance;
+
+  /** A frame the operation loaded a page into. */
+  struct RingSlot {
+    BufferPoolManagerInstance *owner_{nullptr};
+    frame_id_t frame_id_{0};
+    page_id_t page_id_{INVALID_PAGE_ID};
+  };
+
+  /** Frames in the order they were loaded, next_slot_ is the oldest. */
+  std::vector<RingSlot> ring_;
+  size_t next_slot_{0};
+  /** Pages the operation had to load so far. */
+  size_t num_misses_{0};
+  const size_t activation_threshold_;
+};
+
+}  // namespace bustub
@@ -15,7 +15,9 @@
 #include <list>
 #include <mutex>  // NOLINT
 #include <unordered_map>
+#include <vector>
 
+#include "buffer/buffer_access_strategy.h"
 #include "buffer/lru_replacer.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
@@ -84,9 +86,53 @@ class BufferPoolManager {
     GradingCallback(callback, CallbackType::AFTER, INVALID_PAGE_ID);
   }
 
+  /**
+   * Fetch a page on behalf of a bulk operation, see BufferAccessStrategy.
+   * @param page_id id of page to be fetched
+   * @param strategy the ring of the operation, nullptr behaves like FetchPage()
+   * @return the requested page
+   */
+  auto FetchPage(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * {
+    return FetchPgWithStrategyImp(page_id, strategy);
+  }
+
+  /**
+   * Create a new page on behalf of a bulk operation, see BufferAccessStrategy.
+   * @param[out] page_id id of created page
+   * @param strategy the ring of the operation, nullptr behaves like NewPage()
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  auto NewPage(page_id_t *page_id, BufferAccessStrategy *strategy) -> Page * {
+    return NewPgWithStrategyImp(page_id, strategy);
+  }
+
+  /**
+   * Hint that the given pages are about to be fetched. Their reads are started in the background and the pages are
+   * left unpinned, so a following FetchPage() finds them in the pool. Pages that are already cached, or for which no
+   * frame can be freed, are skipped.
+   * @param page_ids ids of the pages to read ahead
+   * @param strategy the ring of the operation reading ahead, if any
+   */
+  void PrefetchPages(const std::vector<page_id_t> &page_ids, BufferAccessStrategy *strategy = nullptr) {
+    PrefetchPgsImp(page_ids, strategy);
+  }
+
   /** @return size of the buffer pool */
   virtual auto GetPoolSize() -> size_t = 0;
 
+  /**
+   * Start writing dirty unpinned pages back in the background, so that misses
+   * find clean frames to evict. Pools without a page cleaner ignore this.
+   * @param clean_fraction share of the frames to keep clean and unpinned
+   */
+  virtual void RunPageCleaner(__attribute__((unused)) double clean_fraction = PAGE_CLEANER_CLEAN_FRACTION) {}
+
+  /** Stop the page cleaner started by RunPageCleaner(), if any. */
+  virtual void StopPageCleaner() {}
+
+  /** @return the number of frames a miss can use without writing a page back: free, or unpinned and clean */
+  virtual auto GetNumCleanFrames() -> size_t { return 0; }
+
  protected:
   /**
    * Grading function. Do not modify!
@@ -145,5 +191,38 @@ class BufferPoolManager {
    * Flushes all the pages in the buffer pool to disk.
    */
   virtual void FlushAllPgsImp() = 0;
+
+  /**
+   * Fetches the requested page, recycling the ring of the strategy on a miss.
+   * Pools without ring support fetch the page as usual.
+   * @param page_id id of page to be fetched
+   * @param strategy the ring of the operation, may be nullptr
+   * @return the requested page
+   */
+  virtual auto FetchPgWithStrategyImp(page_id_t page_id, __attribute__((unused)) BufferAccessStrategy *strategy)
+      -> Page * {
+    return FetchPgImp(page_id);
+  }
+
+  /**
+   * Creates a new page, recycling the ring of the strategy for its frame.
+   * Pools without ring support create the page as usual.
+   * @param[out] page_id id of created page
+   * @param strategy the ring of the operation, may be nullptr
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  virtual auto NewPgWithStrategyImp(page_id_t *page_id, __attribute__((unused)) BufferAccessStrategy *strategy)
+      -> Page * {
+    return NewPgImp(page_id);
+  }
+
+  /**
+   * Starts reading the given pages into the buffer pool without pinning them.
+   * Read-ahead is only a hint, so by default it does nothing.
+   * @param page_ids ids of the pages to read ahead
+   * @param strategy the ring of the operation reading ahead, may be nullptr
+   */
+  virtual void PrefetchPgsImp(__attribute__((unused)) const std::vector<page_id_t> &page_ids,
+                              __attribute__((unused)) BufferAccessStrategy *strategy) {}
 };
 }  // namespace bustub
@@ -12,22 +12,34 @@
 
 #pragma once
 
+#include <condition_variable>  // NOLINT
+#include <future>              // NOLINT
 #include <list>
 #include <memory>
 #include <mutex>  // NOLINT
 #include <shared_mutex>
+#include <thread>  // NOLINT
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
+#include "buffer/buffer_access_strategy.h"
 #include "buffer/buffer_pool_manager.h"
-#include "buffer/lru_k_replacer.h"
+#include "buffer/frame_replacer.h"
 #include "common/config.h"
-#include "container/hash/extendible_hash_table.h"
+#include "container/hash/page_table.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_scheduler.h"
 #include "storage/page/page.h"
 
 namespace bustub {
 
+/** Page sized buffer that meets the alignment O_DIRECT asks for. */
+struct alignas(BUSTUB_PAGE_ALIGNMENT) PageBuffer {
+  char data_[BUSTUB_PAGE_SIZE];
+};
+
 /**
  * BufferPoolManager reads disk pages to and from its internal buffer pool.
  */
@@ -40,9 +52,26 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    * @param replacer_k the lookback constant k for the LRU-K replacer
    * @param log_manager the log manager (for testing only: nullptr = disable
    * logging). Please ignore this for P1.
+   * @param policy the replacement policy of the buffer pool
    */
   BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
-                            LogManager *log_manager = nullptr);
+                            LogManager *log_manager = nullptr, ReplacerPolicy policy = ReplacerPolicy::LRU_K);
+
+  /**
+   * @brief Creates a new BufferPoolManagerInstance that is one shard of a
+   * ParallelBufferPoolManager.
+   * @param pool_size the size of the buffer pool
+   * @param num_instances total number of BPIs in the parallel BPM
+   * @param instance_index index of this BPI in the parallel BPM
+   * @param disk_manager the disk manager
+   * @param replacer_k the lookback constant k for the LRU-K replacer
+   * @param log_manager the log manager (for testing only: nullptr = disable
+   * logging). Please ignore this for P1.
+   * @param policy the replacement policy of the buffer pool
+   */
+  BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                            DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
+                            LogManager *log_manager = nullptr, ReplacerPolicy policy = ReplacerPolicy::LRU_K);
 
   /**
    * @brief Destroy an existing BufferPoolManagerInstance.
@@ -55,6 +84,27 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   /** @brief Return the pointer to all the pages in the buffer pool. */
   auto GetPages() -> Page * { return pages_; }
 
+  /**
+   * @brief Start the page cleaner thread. Whenever fewer than clean_fraction
+   * of the frames are free or unpinned and clean, it writes dirty unpinned
+   * pages back in batches of PAGE_CLEANER_BATCH_PAGES, in page id order. It
+   * wakes up every PAGE_CLEANER_INTERVAL, and right away when a miss had to
+   * write back its victim.
+   *
+   * The cleaner writes a copy of each page, so fetching a page that is being
+   * cleaned does not wait. Only another write of the page, or reading it back
+   * after it was evicted, waits for the copy to reach the disk.
+   *
+   * @param clean_fraction share of the frames to keep clean and unpinned
+   */
+  void RunPageCleaner(double clean_fraction = PAGE_CLEANER_CLEAN_FRACTION) override;
+
+  /** @brief Stop the page cleaner thread and wait for its last batch. */
+  void StopPageCleaner() override;
+
+  /** @brief Return the number of frames that are free, or unpinned and clean. */
+  auto GetNumCleanFrames() -> size_t override;
+
  protected:
   /**
    * TODO(P1): Add implementation
@@ -159,34 +209,218 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    */
   auto DeletePgImp(page_id_t page_id) -> bool override;
 
+  /**
+   * @brief Fetch the requested page like FetchPgImp(). Once the strategy is
+   * active, a miss recycles the oldest frame of its ring when that frame still
+   * holds the page the ring loaded and nobody has pinned it, and hits are not
+   * recorded in the replacer.
+   * @param page_id id of page to be fetched
+   * @param strategy the ring of the operation, may be nullptr
+   * @return nullptr if page_id cannot be fetched, otherwise pointer to the
+   * requested page
+   */
+  auto FetchPgWithStrategyImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * override;
+
+  /**
+   * @brief Create a new page like NewPgImp(), taking its frame from the ring
+   * of the strategy the same way FetchPgWithStrategyImp() does.
+   * @param[out] page_id id of created page
+   * @param strategy the ring of the operation, may be nullptr
+   * @return nullptr if no new pages could be created, otherwise pointer to new
+   * page
+   */
+  auto NewPgWithStrategyImp(page_id_t *page_id, BufferAccessStrategy *strategy) -> Page * override;
+
+  /**
+   * @brief Start reading the given pages into free or evictable frames.
+   *
+   * The pages are published in the page table right away, unpinned and not
+   * evictable while their reads are in flight. A FetchPgImp() on such a page
+   * waits for the read instead of issuing its own. Finished reads are reaped
+   * lazily, the next time somebody needs the frame or a free frame.
+   *
+   * @param page_ids ids of the pages to read ahead
+   * @param strategy the ring of the operation reading ahead, may be nullptr
+   */
+  void PrefetchPgsImp(const std::vector<page_id_t> &page_ids, BufferAccessStrategy *strategy) override;
+
   /** Number of pages in the buffer pool. */
   const size_t pool_size_;
+  /** How many instances are in the parallel BPM (if present, otherwise just 1 BPI) */
+  const uint32_t num_instances_ = 1;
+  /** Index of this BPI in the parallel BPM (if present, otherwise just 0) */
+  const uint32_t instance_index_ = 0;
   /** The next page id to be allocated  */
-  std::atomic<page_id_t> next_page_id_ = 0;
-  /** Bucket size for the extendible hash table */
-  const size_t bucket_size_ = 4;
+  std::atomic<page_id_t> next_page_id_ = instance_index_;
 
   /** Array of buffer pool pages. */
   Page *pages_;
   /** [Thread-Safe] Pointer to the disk manager. */
   DiskManager *disk_manager_ __attribute__((__unused__));
+  /** [Thread-Safe] Issues the page reads and writes of this instance, several of them concurrently. */
+  std::unique_ptr<DiskScheduler> disk_scheduler_;
   /** Pointer to the log manager. Please ignore this for P1. */
   LogManager *log_manager_ __attribute__((__unused__));
-  /** [Thread-Safe] Page table for keeping track of buffer pool pages. */
-  ExtendibleHashTable<page_id_t, frame_id_t> *page_table_;
+  /** [Thread-Safe] Page table for keeping track of buffer pool pages, sized for pool_size_ pages. */
+  PageTable *page_table_;
   /** [Thread-Safe] Replacer to find unpinned pages for replacement. */
-  LRUKReplacer *replacer_;
+  std::unique_ptr<FrameReplacer> replacer_;
   /** List of free frames that don't have any pages on them. */
   std::list<frame_id_t> free_list_;
-  /** Protect free_list_*/
+  /**
+   * True while a frame is reserved for a page whose write-back or read is in
+   * flight. The page is already in the page table, but its data is not valid
+   * until the flag is cleared. One bool per frame, so that frames latched
+   * separately do not share a word.
+   */
+  std::unique_ptr<bool[]> frame_io_in_flight_;
+  /** Frames being filled by PrefetchPgsImp(), with the completion of their read. */
+  std::unordered_map<frame_id_t, std::future<bool>> prefetching_;
+  /** Evicted pages whose write-back has not reached the disk yet. They must not be re-read from disk until it does. */
+  std::unordered_set<page_id_t> pages_writing_back_;
+  /**
+   * Pages whose copy the page cleaner is writing. Their frames stay usable,
+   * but the page must not be written or re-read from disk until the copy is out.
+   */
+  std::unordered_set<page_id_t> pages_cleaning_;
+  /** Signalled whenever an in-flight frame I/O completes. Waited on with latch_. */
+  std::condition_variable io_done_cv_;
+  /** The page cleaner, see RunPageCleaner(). */
+  std::thread cleaner_thread_;
+  /** Wakes up the page cleaner. Waited on with latch_. */
+  std::condition_variable cleaner_cv_;
+  bool cleaner_running_{false};
+  bool cleaner_wakeup_{false};
+  double clean_fraction_{PAGE_CLEANER_CLEAN_FRACTION};
+  /** The page cleaner copies pages here, under the latch, before writing them. */
+  std::vector<PageBuffer> cleaner_buffers_;
+  /** Protect free_list_, page table / replacer updates and the in-flight I/O state. Never held across disk I/O. */
   std::mutex latch_;
+  /**
+   * One latch per frame, protecting the page_id_, pin_count_ and is_dirty_ of
+   * its page and its frame_io_in_flight_ flag. A hit finds its frame through
+   * the lock-free page table and pins it under this latch alone, and so does
+   * an unpin. Everybody else changing that state holds latch_ as well, always
+   * taken first.
+   */
+  std::unique_ptr<std::mutex[]> frame_latches_;
+  /**
+   * @brief Pin a page that is resident and not waiting for I/O, without
+   * taking latch_.
+   * @param page_id id of the page to pin
+   * @param strategy the ring of the operation, may be nullptr
+   * @return the pinned page, or nullptr if the caller has to take the slow path
+   */
+  auto TryPinResident(page_id_t page_id, BufferAccessStrategy *strategy) -> Page *;
+
   /**
    * @brief Allocate a page on disk. Caller should acquire the latch before
-   * calling this function.
+   * calling this function. Page ids are strided by num_instances_ so that
+   * every allocated id maps back to this instance.
    * @return the id of the allocated page
    */
   auto AllocatePage() -> page_id_t;
 
+  /**
+   * @brief Take a frame from the free list, or evict one through the replacer.
+   * The evicted page is removed from the page table. Caller should hold the
+   * latch.
+   * @param[out] frame_id the reserved frame
+   * @param[out] evicted_page_id the dirty page that has to be written back
+   * before the frame can be reused, INVALID_PAGE_ID if there is none
+   * @param strategy if active, its ring is tried before the free list
+   * @return false if every frame is pinned
+   */
+  auto AcquireFrame(frame_id_t *frame_id, page_id_t *evicted_page_id, BufferAccessStrategy *strategy = nullptr)
+      -> bool;
+
+  /**
+   * @brief Take the page out of a frame AcquireFrame() picked: unmap it and
+   * note the write-back it needs. Caller should hold the latch and the frame
+   * latch, and the page must be unpinned.
+   * @param frame_id the frame
+   * @param[out] evicted_page_id the page if it is dirty, left alone otherwise
+   */
+  void ReleaseFrame(frame_id_t frame_id, page_id_t *evicted_page_id);
+
+  /**
+   * @brief Note that the operation behind `strategy` loaded `page_id` into
+   * `frame_id`, so the frame joins its ring. Caller should hold the latch.
+   */
+  void AddToRing(BufferAccessStrategy *strategy, frame_id_t frame_id, page_id_t page_id);
+
+  /**
+   * @brief Write back the evicted page and/or read the new page into a frame
+   * reserved by AcquireFrame(), then wake up everyone waiting on it. The
+   * caller should hold `lock` when calling; it is released during the disk I/O
+   * and re-acquired before returning.
+   * @param lock the caller's lock on latch_
+   * @param frame_id the reserved frame
+   * @param evicted_page_id the page to write back first, INVALID_PAGE_ID if none
+   * @param read_page_id the page to read into the frame, INVALID_PAGE_ID if none
+   */
+  void DoFrameIO(std::unique_lock<std::mutex> &lock, frame_id_t frame_id, page_id_t evicted_page_id,
+                 page_id_t read_page_id);
+
+  /**
+   * @brief Schedule a single page read or write on the disk scheduler.
+   * @return the future that becomes ready once the request has completed
+   */
+  inline auto SchedulePageIO(bool is_write, page_id_t page_id, char *data) -> std::future<bool> {
+    auto promise = disk_scheduler_->CreatePromise();
+    auto future = promise.get_future();
+    disk_scheduler_->Schedule({is_write, data, page_id, std::move(promise)});
+    return future;
+  }
+
+  /**
+   * @brief Block until the in-flight I/O (if any) on the frame has completed.
+   * Caller should hold `lock`.
+   */
+  inline void WaitFrameIO(std::unique_lock<std::mutex> &lock, frame_id_t frame_id) {
+    CompletePrefetch(lock, frame_id);
+    io_done_cv_.wait(lock, [this, frame_id] { return !frame_io_in_flight_[frame_id]; });
+  }
+
+  /**
+   * @brief If the frame is being prefetched, wait for its read and make the
+   * frame usable again. Caller should hold `lock`; it is released while
+   * waiting.
+   */
+  void CompletePrefetch(std::unique_lock<std::mutex> &lock, frame_id_t frame_id);
+
+  /**
+   * @brief Make the frames of every prefetch whose read already completed
+   * usable again, without blocking. Caller should hold the latch.
+   */
+  void ReapPrefetches();
+
+  /**
+   * @brief Clear the in-flight state of a frame whose prefetch read has
+   * completed. Caller should hold the latch.
+   */
+  void FinishPrefetch(frame_id_t frame_id);
+
+  /** @brief Body of the page cleaner thread. */
+  void RunCleaner();
+
+  /**
+   * @brief One round of the page cleaner: write back up to
+   * PAGE_CLEANER_BATCH_PAGES dirty unpinned pages if fewer than the target of
+   * clean frames are available.
+   * @return the number of pages written
+   */
+  auto CleanPages() -> size_t;
+
+  /** @brief Count free, and unpinned clean frames. Caller should hold the latch. */
+  auto CountCleanFrames() -> size_t;
+
+  /**
+   * @brief Validate that the page_id being used is accessible to this BPI.
+   * @param page_id the page id to validate
+   */
+  void ValidatePageId(page_id_t page_id) const;
+
   /**
    * @brief Deallocate a page on disk. Caller should acquire the latch before
    * calling this function.
@@ -0,0 +1,139 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// clock_pro_replacer.h
+//
+// Identification: src/include/buffer/clock_pro_replacer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/frame_replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * ClockProReplacer implements CLOCK-Pro (Jiang, Chen and Zhang, USENIX ATC'05),
+ * a CLOCK approximation of LIRS.
+ *
+ * Resident pages are hot or cold. A new page starts cold and in its test
+ * period. A cold page that is referenced again during its test period has a
+ * small reuse distance and turns hot; a cold page evicted during its test
+ * period stays on the clock as a non-resident entry, and faulting it back in
+ * makes it hot directly. Three hands sweep one circular list:
+ *
+ * - HAND_cold evicts unreferenced cold pages, which is all Evict() needs.
+ * - HAND_hot turns unreferenced hot pages cold when there are more hot pages
+ *   than the hot target, and ends the test periods it passes.
+ * - HAND_test drops the oldest non-resident entries, at most num_frames are kept.
+ *
+ * The cold target adapts: it grows when a non-resident page is faulted in and
+ * shrinks when a test period expires unused. A hit only sets a reference bit.
+ */
+class ClockProReplacer : public FrameReplacer {
+ public:
+  /**
+   * @brief Create a new ClockProReplacer.
+   * @param num_frames the maximum number of frames the replacer will be required to store
+   */
+  explicit ClockProReplacer(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(ClockProReplacer);
+
+  ~ClockProReplacer() override = default;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto Size() const -> size_t override;
+
+  /** @return the current number of frames the replacer aims to keep cold, for tests */
+  auto GetColdTarget() const -> size_t;
+
+ private:
+  enum class PageStatus { HOT, COLD, NON_RESIDENT };
+
+  struct ClockEntry {
+    page_id_t page_id_;
+    frame_id_t frame_id_;
+    PageStatus status_;
+    bool referenced_{false};
+    bool in_test_{false};
+  };
+
+  using Hand = std::list<ClockEntry>::iterator;
+
+  struct FrameState {
+    bool tracked_{false};
+    bool evictable_{false};
+    Hand pos_;
+  };
+
+  inline auto CheckAndHandleFrameID(frame_id_t frame_id) -> void {
+    if (frame_id < 0 || static_cast<size_t>(frame_id) >= replacer_size_) {
+      throw std::out_of_range("Frame id is out of range");
+    }
+  }
+
+  /** @return the entry after pos on the clock */
+  auto Next(Hand pos) -> Hand;
+
+  /** Insert an entry at the list head, just behind HAND_hot. Caller should hold latch_. */
+  auto InsertAtHead(const ClockEntry &entry) -> Hand;
+
+  /** Move an entry to the list head. Caller should hold latch_. */
+  void MoveToHead(Hand pos);
+
+  /** Take an entry off the clock, moving the hands that point at it forward. Caller should hold latch_. */
+  void Erase(Hand pos);
+
+  /** Sweep HAND_hot until one hot page turned cold. Caller should hold latch_. */
+  void RunHandHot();
+
+  /** Sweep HAND_test until one non-resident entry was dropped. Caller should hold latch_. */
+  void RunHandTest();
+
+  /** Sweep HAND_cold by one entry. @return the evicted frame, or -1. Caller should hold latch_. */
+  auto RunHandCold() -> frame_id_t;
+
+  /** A test period ended without a reuse. Caller should hold latch_. */
+  void DecreaseColdTarget();
+
+  /** Stop tracking a resident frame, leaving its entry to the caller. Caller should hold latch_. */
+  void Untrack(frame_id_t frame_id);
+
+  size_t replacer_size_;
+  size_t size_{0};
+  size_t cold_target_{1};
+  size_t num_hot_{0};
+  size_t num_non_resident_{0};
+
+  std::list<ClockEntry> clock_;
+  Hand hand_hot_;
+  Hand hand_cold_;
+  Hand hand_test_;
+
+  std::vector<FrameState> frames_;
+  std::unordered_map<page_id_t, Hand> non_resident_;
+
+  mutable std::mutex latch_;
+};
+
+}  // namespace bustub
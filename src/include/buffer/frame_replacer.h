@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_replacer.h
+//
+// Identification: src/include/buffer/frame_replacer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/** The replacement policies a buffer pool can be created with. */
+enum class ReplacerPolicy { LRU_K, TWO_Q, ARC, CLOCK_PRO };
+
+/**
+ * FrameReplacer is the interface between a buffer pool and its replacement
+ * policy. Every implementation shares the semantics of LRUKReplacer:
+ *
+ * - The first access of a frame starts tracking it, and a newly tracked frame
+ *   is evictable.
+ * - Size() is the number of evictable frames.
+ * - Evict() and Remove() forget the frame. Remove() throws on a
+ *   non-evictable frame and ignores an untracked one.
+ * - Frame ids outside [0, num_frames) throw std::out_of_range.
+ *
+ * Policies that remember recently evicted pages (ARC, 2Q, CLOCK-Pro) need the
+ * id of the page a frame holds, so it is passed along with every access.
+ * Implementations are thread safe.
+ */
+class FrameReplacer {
+ public:
+  FrameReplacer() = default;
+  virtual ~FrameReplacer() = default;
+
+  /**
+   * @brief Pick a victim among the evictable frames and stop tracking it.
+   * @param[out] frame_id id of the evicted frame
+   * @return true if a frame was evicted, false if no frame is evictable
+   */
+  virtual auto Evict(frame_id_t *frame_id) -> bool = 0;
+
+  /**
+   * @brief Record that a frame holding the given page was accessed.
+   * @param frame_id id of the accessed frame
+   * @param page_id id of the page in the frame, INVALID_PAGE_ID if unknown
+   */
+  virtual void RecordAccess(frame_id_t frame_id, page_id_t page_id) = 0;
+
+  /**
+   * @brief Toggle whether a tracked frame may be evicted, adjusting Size().
+   * @param frame_id id of the frame
+   * @param set_evictable whether the frame is evictable
+   */
+  virtual void SetEvictable(frame_id_t frame_id, bool set_evictable) = 0;
+
+  /**
+   * @brief Stop tracking an evictable frame without evicting it, e.g. because
+   * its page was deleted. A removed page is not remembered as recently evicted.
+   * @param frame_id id of the frame
+   */
+  virtual void Remove(frame_id_t frame_id) = 0;
+
+  /** @return the number of evictable frames */
+  virtual auto Size() const -> size_t = 0;
+};
+
+/**
+ * @brief Create the replacer of a buffer pool.
+ * @param policy the replacement policy
+ * @param num_frames number of frames in the buffer pool
+ * @param k the lookback constant, only used by ReplacerPolicy::LRU_K
+ */
+auto MakeFrameReplacer(ReplacerPolicy policy, size_t num_frames, size_t k = LRUK_REPLACER_K)
+    -> std::unique_ptr<FrameReplacer>;
+
+/** @return the name of a policy, e.g. "lru-k" */
+auto ReplacerPolicyToString(ReplacerPolicy policy) -> std::string;
+
+}  // namespace bustub
@@ -13,17 +13,17 @@
 
 #pragma once
 
-#include <list>
-#include <map>
+#include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>  // NOLINT
 #include <set>
-#include <shared_mutex>  // NOLINT
-#include <unordered_map>
-#include <unordered_set>
+#include <stdexcept>
+#include <tuple>
 #include <utility>
 #include <vector>
 
+#include "buffer/frame_replacer.h"
 #include "common/config.h"
 #include "common/macros.h"
 
@@ -39,8 +39,13 @@ namespace bustub {
  * A frame with less than k historical references is given
  * +inf as its backward k-distance. When multiple frames have +inf backward
  * k-distance, classical LRU algorithm is used to choose victim.
+ *
+ * Evictable frames are kept ordered by backward k-distance, so Evict() is
+ * O(log n). Accesses to frames that already have a history are buffered per
+ * thread shard and applied in batches, so page hits do not serialize on the
+ * replacer latch.
  */
-class LRUKReplacer {
+class LRUKReplacer : public FrameReplacer {
  public:
   /**
    *
@@ -59,7 +64,7 @@ class LRUKReplacer {
    *
    * @brief Destroys the LRUReplacer.
    */
-  ~LRUKReplacer();
+  ~LRUKReplacer() override;
 
   /**
    * TODO(P1): Add implementation
@@ -79,7 +84,7 @@ class LRUKReplacer {
    * @return true if a frame is evicted successfully, false if no frames can be
    * evicted.
    */
-  auto Evict(frame_id_t *frame_id) -> bool;
+  auto Evict(frame_id_t *frame_id) -> bool override;
 
   /**
    * TODO(P1): Add implementation
@@ -96,6 +101,9 @@ class LRUKReplacer {
    */
   void RecordAccess(frame_id_t frame_id);
 
+  /** LRU-K only needs the frame, the page id is ignored. */
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id) override { RecordAccess(frame_id); }
+
   /**
    * TODO(P1): Add implementation
    *
@@ -115,7 +123,7 @@ class LRUKReplacer {
    * @param frame_id id of frame whose 'evictable' status will be modified
    * @param set_evictable whether the given frame is evictable or not
    */
-  void SetEvictable(frame_id_t frame_id, bool set_evictable);
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
 
   /**
    * TODO(P1): Add implementation
@@ -135,7 +143,7 @@ class LRUKReplacer {
    *
    * @param frame_id id of frame to be removed
    */
-  void Remove(frame_id_t frame_id);
+  void Remove(frame_id_t frame_id) override;
 
   /**
    * TODO(P1): Add implementation
@@ -144,243 +152,81 @@ class LRUKReplacer {
    *
    * @return size_t
    */
-  auto Size() const -> size_t;
+  auto Size() const -> size_t override;
 
  private:
-  /**
-   * Timer simulates a tiktok timer.
-   */
-  class Timer {
-   public:
-    /**
-     * @brief A new timer.
-     */
-    Timer() = default;
-
-    /**
-     * @note Default destructor is enough.
-     */
-    ~Timer() = default;
-
-    /**
-     * @brief Get the simulated time.
-     *
-     * @return size_t
-     */
-    inline auto GetTime() -> size_t { return ++time_; }
-
-   private:
-    size_t time_{0UL};
-  };
+  /** Number of access buffers RecordAccess() spreads recording threads over. */
+  static constexpr size_t NUM_ACCESS_SHARDS = 16;
+  /** Buffered accesses of one shard that trigger a drain into the history. */
+  static constexpr size_t ACCESS_BATCH_SIZE = 64;
 
   /**
-   * Entry helps the LRUKReplacer to manage the access history for every frame.
+   * Accesses to already tracked frames are buffered here, each stamped with
+   * its logical time, and applied to the history in timestamp order by
+   * DrainAccesses(). A hit therefore only takes the latch of its shard.
    */
-  class Entry {
-   public:
-    /**
-     * @brief A new LRU-K Replacer Entry. Call the Record() INSTANTLY when you
-     * allocate a new entry.
-     */
-    explicit Entry(size_t k, frame_id_t frame_id, Timer *timer)
-        : k_{k},
-          history_front_idx_{0},
-          history_back_idx_{0},
-          history_size_{0},
-          id_(frame_id),
-          evictable_{true},
-          timer_{timer} {
-      history_ = new size_t[k_];
-    }
-
-    DISALLOW_COPY_AND_MOVE(Entry);
-
-    /**
-     * @brief Delete a entry.
-     */
-    ~Entry() { delete[] history_; }
-
-    /**
-     * @brief Check whether this entry can be evicted or not.
-     *
-     * @return True if evictable, false if not.
-     */
-    inline auto IsEvictable() const -> bool { return evictable_; }
-
-    /**
-     * @brief Get the earliest timestamp which you might want in the case where
-     * there are multiple Inf+ K-Distance values.
-     *
-     * @return size_t
-     */
-    inline auto GetEarliestTimestamp() const -> size_t { return history_[history_front_idx_]; }
-
-    /**
-     * @brief Record the access according to the current timestamp.
-     */
-    inline auto RecordAccess() -> void {
-      if (history_size_ == k_) {
-        history_front_idx_ = (history_front_idx_ + 1) % k_;
-      } else {
-        history_size_++;
-      }
-      history_[history_back_idx_] = timer_->GetTime();
-      history_back_idx_ = (history_back_idx_ + 1) % k_;
-    }
-
-    /**
-     * @brief Get the size(#<=k) of the history.
-     */
-    inline auto GetSize() const -> size_t { return history_size_; }
-    /**
-     * @brief Get the id of the frame.
-     */
-    inline auto GetID() const -> frame_id_t { return id_; }
-
-    /**
-     * @brief Set the evictable status of this entry.
-     *
-     * @param set_evictable The evictable status.
-     */
-    inline auto SetEvictable(bool set_evictable) -> void { evictable_ = set_evictable; }
-
-   private:
-    size_t k_;
-    size_t history_front_idx_;
-    size_t history_back_idx_;
-    size_t history_size_;
-    size_t *history_;
-    frame_id_t id_;
-    bool evictable_;
-    Timer *timer_;
+  struct alignas(64) AccessShard {
+    std::mutex latch_;
+    std::vector<std::pair<size_t, frame_id_t>> accesses_;
   };
 
-  class TempPool {
-   public:
-    TempPool() = default;
-
-    ~TempPool() = default;
-
-    DISALLOW_COPY_AND_MOVE(TempPool);
-
-    inline auto IsEmpty() const -> bool { return pool_.empty(); }
-
-    inline auto Get(frame_id_t frame_id) -> std::shared_ptr<Entry> { return *(map_[frame_id]); };
-
-    inline auto Contain(frame_id_t frame_id) const -> bool { return map_.count(frame_id) != 0; }
-
-    inline auto Remove(frame_id_t frame_id) -> std::shared_ptr<Entry> {
-      if (map_.count(frame_id) != 0) {
-        auto iter = map_[frame_id];
-        auto res = std::move(*iter);
-        pool_.erase(iter);
-        map_.erase(frame_id);
-        return res;
-      }
-      return {nullptr};
-    }
-
-    inline auto Insert(frame_id_t frame_id, std::shared_ptr<Entry> entry) -> void {
-      pool_.emplace_back(std::move(entry));
-      map_.emplace(frame_id, --pool_.end());
-    }
-
-    inline auto EvictableFront(frame_id_t &result) -> bool {
-      for (auto &entry : pool_) {
-        if (entry->IsEvictable()) {
-          auto id = entry->GetID();
-          auto &iter = map_[id];
-          pool_.erase(iter);
-          map_.erase(id);
-          result = id;
-          return true;
-        }
-      }
-      return false;
-    }
-
-   private:
-    std::list<std::shared_ptr<Entry>> pool_;
-    std::unordered_map<frame_id_t, decltype(pool_)::iterator> map_;
+  /** Bookkeeping of one frame. Its last k accesses live in history_[frame_id * k_, (frame_id + 1) * k_). */
+  struct FrameState {
+    /** Slot of the oldest retained access in the frame's history ring. */
+    size_t history_head_{0};
+    size_t history_size_{0};
+    /** Time of the first access since the frame was last evicted or removed. */
+    size_t tracked_since_{0};
+    bool evictable_{false};
   };
 
-  class CachePool {
-   public:
-    CachePool() = default;
-
-    ~CachePool() = default;
-
-    DISALLOW_COPY_AND_MOVE(CachePool);
-
-    inline auto Contain(frame_id_t frame_id) const -> bool { return map_.count(frame_id) != 0; }
-
-    inline auto Get(frame_id_t frame_id) -> std::shared_ptr<Entry> { return *(map_[frame_id]); };
-
-    inline void Adjust(frame_id_t frame_id) {
-      auto old_iter = map_[frame_id];
-      auto entry = *old_iter;
-      pool_.erase(old_iter);
-      auto [new_iter, _] = pool_.emplace(std::move(entry));
-      map_[frame_id] = new_iter;
-    }
-
-    inline void Insert(frame_id_t frame_id, std::shared_ptr<Entry> entry) {
-      auto [iter, _] = pool_.emplace(std::move(entry));
-      map_.emplace(frame_id, iter);
-    }
-
-    inline auto PopEvictedFront(frame_id_t &result) -> bool {
-      for (auto iter = pool_.begin(); iter != pool_.end(); ++iter) {
-        auto &entry = *iter;
-        if (entry->IsEvictable()) {
-          auto id = entry->GetID();
-          pool_.erase(iter);
-          map_.erase(id);
-          result = id;
-          return true;
-        }
-      }
-      return false;
-    }
-
-    inline auto Remove(frame_id_t frame_id) -> bool {
-      if (map_.count(frame_id) == 0) {
-        return false;
-      }
-      auto iter = map_[frame_id];
-      pool_.erase(iter);
-      map_.erase(frame_id);
-      return true;
-    }
-
-    inline auto IsEmpty() const -> bool { return pool_.empty(); }
-
-   private:
-    struct Compare {
-      inline auto operator()(const std::shared_ptr<Entry> &x, const std::shared_ptr<Entry> &y) const -> bool {
-        return x->GetEarliestTimestamp() < y->GetEarliestTimestamp();
-      }
-    };
-    std::set<std::shared_ptr<Entry>, Compare> pool_;
-    std::unordered_map<frame_id_t, decltype(pool_)::iterator> map_;
-  };
+  /**
+   * Eviction order: frames with fewer than k accesses (+inf backward
+   * k-distance) first, then by the timestamp of the kth most recent access
+   * (earliest access for +inf frames), ascending.
+   */
+  using EvictionKey = std::tuple<bool, size_t, frame_id_t>;
 
   /**
    * @brief IsValidFrameID checks whether the frame_id is in the range [0,replacer_size_-1]
    */
   inline auto CheckAndHandleFrameID(frame_id_t frame_id) -> void {
-    if (frame_id > static_cast<frame_id_t>(replacer_size_)) {
+    if (frame_id < 0 || static_cast<size_t>(frame_id) >= replacer_size_) {
       throw std::out_of_range("Frame id is out of range");
     }
   }
 
-  size_t size_;
+  /** @return the shard the calling thread records its accesses into */
+  static auto ShardIndex() -> size_t;
+
+  /** @return the position of a tracked frame in evictable_frames_ */
+  auto GetEvictionKey(frame_id_t frame_id) const -> EvictionKey;
+
+  /** Append an access to the history of a frame, tracking it first if needed. Caller should hold latch_. */
+  void ApplyAccess(frame_id_t frame_id, size_t timestamp);
+
+  /** Apply every buffered access in timestamp order. Caller should hold latch_. */
+  void DrainAccesses();
+
+  /** Forget the history of an evictable frame that leaves the replacer. Caller should hold latch_. */
+  void Untrack(frame_id_t frame_id);
+
+  size_t size_{0};
   size_t replacer_size_;
   size_t k_;
-  TempPool *temp_pool_;
-  CachePool *cache_pool_;
-
-  Timer *timer_;
-  mutable std::shared_mutex latch_;
+  /** Logical clock, ticked by every access. */
+  std::atomic<size_t> current_timestamp_{0};
+
+  /** Flat history rings, k_ timestamps per frame. */
+  std::vector<size_t> history_;
+  std::vector<FrameState> frames_;
+  /** Whether a frame has an access history. Read without latch_ by RecordAccess(). */
+  std::unique_ptr<std::atomic<bool>[]> tracked_;
+  /** Evictable frames in eviction order, so Evict() takes the first one. */
+  std::set<EvictionKey> evictable_frames_;
+  std::array<AccessShard, NUM_ACCESS_SHARDS> access_shards_;
+
+  /** Protects everything but tracked_ and the access shards. */
+  mutable std::mutex latch_;
 };
 }  // namespace bustub
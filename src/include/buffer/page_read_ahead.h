@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_read_ahead.h
+//
+// Identification: src/include/buffer/page_read_ahead.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <deque>
+#include <functional>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * PageReadAhead keeps the pages following a scan position prefetched, for
+ * scans that walk a chain of pages linked by a next page id (table heaps,
+ * B+ tree leaves).
+ *
+ * The chain can only be followed by looking into the pages themselves, so
+ * every hop fetches the furthest page known so far. In steady state that page
+ * was requested one step earlier, and while the scan is over cached pages the
+ * hops are free and the uncached pages further down are all read in parallel.
+ */
+class PageReadAhead {
+ public:
+  /** Extracts the id of the page after `page` in the chain, INVALID_PAGE_ID at the end. */
+  using NextPageIdFn = std::function<page_id_t(Page *page)>;
+
+  /**
+   * @param bpm the buffer pool to read ahead into, may be nullptr for an iterator that is already at the end
+   * @param next_page_id how to follow the chain
+   * @param window how many pages to keep requested ahead of the scan. It is capped to a quarter of the pool so
+   * read-ahead cannot flush out everything else.
+   * @param strategy the ring of the scan, read-ahead goes through it as well
+   */
+  PageReadAhead(BufferPoolManager *bpm, NextPageIdFn next_page_id, size_t window = READ_AHEAD_PAGES,
+                BufferAccessStrategy *strategy = nullptr);
+
+  /**
+   * Tell the read-ahead the scan is now on `page_id`. Calling it again for the same page is cheap.
+   * @param page_id the page the scan is on
+   */
+  void Advance(page_id_t page_id);
+
+ private:
+  BufferPoolManager *bpm_;
+  NextPageIdFn next_page_id_;
+  size_t window_;
+  BufferAccessStrategy *strategy_;
+  /** The page the scan is on. */
+  page_id_t current_page_id_{INVALID_PAGE_ID};
+  /** Pages after the current one that have been requested, in chain order. */
+  std::deque<page_id_t> ahead_;
+  /** True once the end of the chain has been requested. */
+  bool end_of_chain_{false};
+};
+
+}  // namespace bustub
@@ -0,0 +1,154 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.h
+//
+// Identification: src/include/buffer/parallel_buffer_pool_manager.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * ParallelBufferPoolManager shards pages across several independent
+ * BufferPoolManagerInstances. A page id is always served by the instance
+ * `page_id % num_instances`, so each instance only ever contends on its own
+ * latch and a miss in one shard does not stall fetches in the others.
+ */
+class ParallelBufferPoolManager : public BufferPoolManager {
+ public:
+  /**
+   * @brief Creates a new ParallelBufferPoolManager.
+   * @param num_instances the number of individual BufferPoolManagerInstances to store
+   * @param pool_size the pool size of each BufferPoolManagerInstance
+   * @param disk_manager the disk manager
+   * @param replacer_k the lookback constant k for the LRU-K replacer of each instance
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param policy the replacement policy of each instance
+   */
+  ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                            size_t replacer_k = LRUK_REPLACER_K, LogManager *log_manager = nullptr,
+                            ReplacerPolicy policy = ReplacerPolicy::LRU_K);
+
+  /**
+   * @brief Destroys an existing ParallelBufferPoolManager.
+   */
+  ~ParallelBufferPoolManager() override = default;
+
+  DISALLOW_COPY_AND_MOVE(ParallelBufferPoolManager);
+
+  /** @brief Return the total number of frames across all instances. */
+  auto GetPoolSize() -> size_t override { return num_instances_ * pool_size_; }
+
+  /** @brief Return the number of instances the pages are sharded across. */
+  auto GetNumInstances() const -> size_t { return num_instances_; }
+
+  /** @brief Start the page cleaner of every instance. */
+  void RunPageCleaner(double clean_fraction = PAGE_CLEANER_CLEAN_FRACTION) override;
+
+  /** @brief Stop the page cleaner of every instance. */
+  void StopPageCleaner() override;
+
+  /** @brief Return the number of clean frames over all instances. */
+  auto GetNumCleanFrames() -> size_t override;
+
+ protected:
+  /**
+   * @brief Get the BufferPoolManagerInstance responsible for handling the given page id.
+   * @param page_id page id
+   * @return pointer to the BufferPoolManagerInstance responsible for handling the given page id
+   */
+  auto GetBufferPoolManager(page_id_t page_id) -> BufferPoolManagerInstance *;
+
+  /**
+   * @brief Fetch the requested page from the responsible instance.
+   * @param page_id id of page to be fetched
+   * @return the requested page
+   */
+  auto FetchPgImp(page_id_t page_id) -> Page * override;
+
+  /**
+   * @brief Unpin the target page from the responsible instance.
+   * @param page_id id of page to be unpinned
+   * @param is_dirty true if the page should be marked as dirty, false otherwise
+   * @return false if the page pin count is <= 0 before this call, true otherwise
+   */
+  auto UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool override;
+
+  /**
+   * @brief Flush the target page to disk through the responsible instance.
+   * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
+   * @return false if the page could not be found in the page table, true otherwise
+   */
+  auto FlushPgImp(page_id_t page_id) -> bool override;
+
+  /**
+   * @brief Create a new page. Instances are tried in round robin order starting
+   * from a rotating index, so allocations spread evenly over the shards.
+   * @param[out] page_id id of created page
+   * @return nullptr if no new pages could be created in any instance, otherwise
+   * pointer to new page
+   */
+  auto NewPgImp(page_id_t *page_id) -> Page * override;
+
+  /**
+   * @brief Delete the page through the responsible instance.
+   * @param page_id id of page to be deleted
+   * @return false if the page exists but could not be deleted, true if the page
+   * didn't exist or deletion succeeded
+   */
+  auto DeletePgImp(page_id_t page_id) -> bool override;
+
+  /**
+   * @brief Flush all the pages of every instance to disk.
+   */
+  void FlushAllPgsImp() override;
+
+  /**
+   * @brief Fetch the requested page from the responsible instance, recycling the ring of the strategy.
+   * @param page_id id of page to be fetched
+   * @param strategy the ring of the operation, may be nullptr
+   * @return the requested page
+   */
+  auto FetchPgWithStrategyImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * override;
+
+  /**
+   * @brief Create a new page like NewPgImp(), recycling the ring of the strategy.
+   * @param[out] page_id id of created page
+   * @param strategy the ring of the operation, may be nullptr
+   * @return nullptr if no new pages could be created in any instance, otherwise pointer to new page
+   */
+  auto NewPgWithStrategyImp(page_id_t *page_id, BufferAccessStrategy *strategy) -> Page * override;
+
+  /**
+   * @brief Hand every page to be read ahead to its responsible instance.
+   * @param page_ids ids of the pages to read ahead
+   * @param strategy the ring of the operation reading ahead, may be nullptr
+   */
+  void PrefetchPgsImp(const std::vector<page_id_t> &page_ids, BufferAccessStrategy *strategy) override;
+
+  /** Number of instances the pages are sharded across. */
+  const size_t num_instances_;
+  /** Number of frames of each instance. */
+  const size_t pool_size_;
+  /** The instance NewPgImp() starts probing from next time. */
+  std::atomic<size_t> next_instance_{0};
+  /** The buffer pool instances, indexed by `page_id % num_instances_`. */
+  std::vector<std::unique_ptr<BufferPoolManagerInstance>> instances_;
+};
+}  // namespace bustub
@@ -0,0 +1,101 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer.h
+//
+// Identification: src/include/buffer/two_queue_replacer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/frame_replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * TwoQueueReplacer implements the full 2Q policy (Johnson and Shasha, VLDB'94).
+ *
+ * A newly loaded page enters A1in, a FIFO that absorbs correlated references:
+ * hits there do not reorder it. Once A1in holds more than Kin frames its
+ * oldest page is evicted and remembered in the ghost FIFO A1out. A page that
+ * is loaded again while remembered in A1out has proven to be reused and goes
+ * to Am, an LRU list of the hot pages. Pages only seen once are therefore
+ * never able to push hot pages out of the pool.
+ */
+class TwoQueueReplacer : public FrameReplacer {
+ public:
+  /**
+   * @brief Create a new TwoQueueReplacer with the tuning the paper recommends,
+   * Kin = 25% and Kout = 50% of the frames.
+   * @param num_frames the maximum number of frames the replacer will be required to store
+   */
+  explicit TwoQueueReplacer(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(TwoQueueReplacer);
+
+  ~TwoQueueReplacer() override = default;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto Size() const -> size_t override;
+
+ private:
+  enum class QueueType { NONE, IN, MAIN };
+
+  struct FrameEntry {
+    QueueType queue_{QueueType::NONE};
+    bool evictable_{false};
+    page_id_t page_id_{INVALID_PAGE_ID};
+    /** Position in a1_in_ or am_, front is the newest / most recently used. */
+    std::list<frame_id_t>::iterator pos_;
+  };
+
+  inline auto CheckAndHandleFrameID(frame_id_t frame_id) -> void {
+    if (frame_id < 0 || static_cast<size_t>(frame_id) >= replacer_size_) {
+      throw std::out_of_range("Frame id is out of range");
+    }
+  }
+
+  /** @return the oldest evictable frame of a queue, or -1 */
+  auto FindVictim(const std::list<frame_id_t> &queue) const -> frame_id_t;
+
+  /** Drop the oldest ghosts until A1out holds at most Kout pages. Caller should hold latch_. */
+  void TrimOut();
+
+  /** Take a tracked frame out of its queue. Caller should hold latch_. */
+  void Untrack(frame_id_t frame_id);
+
+  size_t replacer_size_;
+  size_t size_{0};
+  size_t max_in_size_;
+  size_t max_out_size_;
+
+  std::vector<FrameEntry> frames_;
+  std::list<frame_id_t> a1_in_;
+  std::list<frame_id_t> am_;
+  /** Ghost FIFO of page ids evicted from A1in, front is the most recent. */
+  std::list<page_id_t> a1_out_;
+  std::unordered_map<page_id_t, std::list<page_id_t>::iterator> a1_out_index_;
+
+  mutable std::mutex latch_;
+};
+
+}  // namespace bustub
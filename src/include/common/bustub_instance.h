@@ -12,12 +12,15 @@
 
 #pragma once
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <optional>
 #include <shared_mutex>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <thread>  // NOLINT
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -40,6 +43,7 @@ class LogManager;
 class CheckpointManager;
 class Catalog;
 class ExecutionEngine;
+class IndexStatement;
 
 class ResultWriter {
  public:
@@ -210,10 +214,26 @@ class BustubInstance {
    */
   auto MakeExecutorContext(Transaction *txn) -> std::unique_ptr<ExecutorContext>;
 
+  /**
+   * Create the B+ tree index of a CREATE INDEX statement, with the smallest
+   * GenericKey that holds every possible key. Caller should hold catalog_lock_.
+   */
+  auto CreateBPlusTreeIndex(Transaction *txn, const IndexStatement &index_stmt, const Schema &key_schema,
+                            const std::vector<uint32_t> &col_ids) -> IndexInfo *;
+
  public:
-  explicit BustubInstance(const std::string &db_file_name);
+  /**
+   * Create a BusTub instance backed by the given database file.
+   * @param db_file_name the database file name
+   * @param bpm_num_instances the number of buffer pool shards the pages are spread across
+   */
+  explicit BustubInstance(const std::string &db_file_name, size_t bpm_num_instances = 1);
 
-  BustubInstance();
+  /**
+   * Create a BusTub instance backed by memory.
+   * @param bpm_num_instances the number of buffer pool shards the pages are spread across
+   */
+  explicit BustubInstance(size_t bpm_num_instances = 1);
 
   ~BustubInstance();
 
@@ -267,6 +287,46 @@ class BustubInstance {
     return variable == "1" || variable == "true" || variable == "yes";
   }
 
+  /** @return the session variable as an integer, or nothing if it is unset or not a whole number */
+  auto GetIntegerSessionVariable(const std::string &key) -> std::optional<int64_t> {
+    auto variable = GetSessionVariable(key);
+    try {
+      size_t end;
+      auto value = std::stoll(variable, &end);
+      if (end == variable.size()) {
+        return value;
+      }
+    } catch (std::logic_error &) {
+      // Not a number.
+    }
+    return std::nullopt;
+  }
+
+  /**
+   * @return the number of threads a query may use, at most one per core. `set execution_threads=0` uses every core,
+   * a negative or invalid value runs serially.
+   */
+  auto GetExecutionThreads() -> size_t {
+    const size_t cores = std::max(std::thread::hardware_concurrency(), 1U);
+    auto threads = GetIntegerSessionVariable("execution_threads").value_or(1);
+    if (threads < 0) {
+      return 1;
+    }
+    if (threads == 0) {
+      return cores;
+    }
+    return std::min(static_cast<size_t>(threads), cores);
+  }
+
+  /**
+   * @return the bytes of tuples a hash join may keep in memory, `set hash_join_memory_limit=<bytes>`. A value that is
+   * not a positive number uses the default.
+   */
+  auto GetHashJoinMemoryLimit() -> size_t {
+    auto limit = GetIntegerSessionVariable("hash_join_memory_limit").value_or(0);
+    return limit > 0 ? static_cast<size_t>(limit) : HASH_JOIN_MEMORY_LIMIT;
+  }
+
  private:
   void CmdDisplayTables(ResultWriter &writer);
   void CmdDisplayIndices(ResultWriter &writer);
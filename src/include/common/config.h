@@ -14,6 +14,7 @@
 
 #include <atomic>
 #include <chrono>  // NOLINT
+#include <cstddef>
 #include <cstdint>
 
 namespace bustub {
@@ -33,10 +34,26 @@ static constexpr int INVALID_TXN_ID = -1;
 static constexpr int INVALID_LSN = -1;                                               // invalid log sequence number
 static constexpr int HEADER_PAGE_ID = 0;                                             // the header page id
 static constexpr int BUSTUB_PAGE_SIZE = 4096;                                        // size of a data page in byte
+static constexpr int BUSTUB_PAGE_ALIGNMENT = 512;  // alignment of page frames, the minimum O_DIRECT requires
 static constexpr int BUFFER_POOL_SIZE = 10;                                          // size of buffer pool
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
 static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr int DISK_SCHEDULER_WORKERS = 4;  // number of disk requests a buffer pool keeps in flight
+static constexpr int READ_AHEAD_PAGES = 8;        // pages a sequential scan keeps prefetched ahead of itself
+static constexpr int BUFFER_RING_PAGES = 16;      // frames a bulk scan or insert recycles, see BufferAccessStrategy
+static constexpr double PAGE_CLEANER_CLEAN_FRACTION = 0.25;  // share of frames the page cleaner keeps clean
+static constexpr int PAGE_CLEANER_BATCH_PAGES = 16;          // dirty pages the page cleaner writes per round
+static constexpr std::chrono::milliseconds PAGE_CLEANER_INTERVAL(10);  // how often the page cleaner looks for work
+static constexpr std::size_t INDEX_BUILD_SORT_MEMORY = 64 << 20;  // bytes of keys an index build sorts in memory
+static constexpr double INDEX_BUILD_FILL_FACTOR = 0.9;           // share of each page a new index fills
+static constexpr std::size_t INDEX_JOIN_BATCH_SIZE = 128;        // outer tuples an index join looks up at once
+static constexpr uint32_t TUPLE_BATCH_SIZE = 256;                // rows an executor hands its parent at once
+static constexpr std::size_t MORSEL_PAGES = 4;                   // table pages a parallel scan worker claims at once
+static constexpr std::size_t HASH_JOIN_PARTITION_ROWS = 4096;    // build tuples per partition of a parallel hash join
+static constexpr std::size_t HASH_JOIN_MEMORY_LIMIT = 64 << 20;  // bytes of tuples a hash join keeps in memory
+static constexpr std::size_t HASH_JOIN_SPILL_PARTITIONS = 8;     // partitions a spilling hash join splits inputs into
+static constexpr uint32_t HASH_JOIN_MAX_SPILL_LEVELS = 4;        // times a spilled partition is split again at most
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
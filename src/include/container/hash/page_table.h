@@ -0,0 +1,117 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table.h
+//
+// Identification: src/include/container/hash/page_table.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+/**
+ * page_table.h
+ *
+ * Fixed-capacity, open-addressed hash table from page ids to frame ids
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "container/hash/hash_table.h"
+
+namespace bustub {
+
+/**
+ * PageTable maps the pages of a buffer pool to their frames.
+ *
+ * A buffer pool never holds more pages than it has frames, so the table is
+ * allocated once with at least twice as many slots as frames and never grows.
+ * Every slot is a single 64-bit word packing a page id and a frame id, and
+ * collisions are resolved by linear probing, so a lookup is one hash and a
+ * few loads from a flat array.
+ *
+ * Find() takes no latch. Writers are serialized by an internal latch. An
+ * insert or an update only ever stores one slot, which a concurrent reader
+ * sees either entirely or not at all. Remove() shifts the entries following
+ * the removed one backwards to keep probe sequences free of holes, and bumps
+ * a sequence number around that, so a reader that raced with it retries.
+ */
+class PageTable : public HashTable<page_id_t, frame_id_t> {
+ public:
+  /**
+   * @brief Create a new PageTable.
+   * @param num_frames the maximum number of pages the table will be required to hold
+   */
+  explicit PageTable(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(PageTable);
+
+  ~PageTable() override = default;
+
+  /**
+   * @brief Find the frame holding the given page. Lock-free.
+   * @param page_id the page to look up
+   * @param[out] frame_id the frame holding the page, if found
+   * @return true if the page is in the table, false otherwise
+   */
+  auto Find(const page_id_t &page_id, frame_id_t &frame_id) -> bool override;
+
+  /**
+   * @brief Remove the given page from the table.
+   * @param page_id the page to remove
+   * @return true if the page was in the table, false otherwise
+   */
+  auto Remove(const page_id_t &page_id) -> bool override;
+
+  /**
+   * @brief Map a page to a frame, overwriting the frame of a page that is
+   * already in the table. Inserting more pages than num_frames is an error.
+   * @param page_id the page to insert, must be valid
+   * @param frame_id the frame holding the page
+   */
+  void Insert(const page_id_t &page_id, const frame_id_t &frame_id) override;
+
+  /** @return the number of pages in the table */
+  auto Size() const -> size_t;
+
+  /** @return the number of slots */
+  auto GetCapacity() const -> size_t { return mask_ + 1; }
+
+ private:
+  /** INVALID_PAGE_ID is never a key, so a slot packing it is empty. */
+  static constexpr uint64_t EMPTY_SLOT = ~static_cast<uint64_t>(0);
+
+  static auto Pack(page_id_t page_id, frame_id_t frame_id) -> uint64_t {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(page_id)) << 32) | static_cast<uint32_t>(frame_id);
+  }
+  static auto PageOf(uint64_t slot) -> page_id_t { return static_cast<page_id_t>(slot >> 32); }
+  static auto FrameOf(uint64_t slot) -> frame_id_t { return static_cast<frame_id_t>(slot & 0xFFFFFFFF); }
+
+  /** @return the home slot of a page. Page ids are mostly dense, so they are scrambled first. */
+  auto HomeOf(page_id_t page_id) const -> size_t {
+    return static_cast<size_t>((static_cast<uint64_t>(static_cast<uint32_t>(page_id)) * 0x9E3779B97F4A7C15ULL) >>
+                               shift_);
+  }
+
+  /** @return the slot holding page_id, or the empty slot ending its probe sequence. Caller should hold write_latch_. */
+  auto Probe(page_id_t page_id) const -> size_t;
+
+  std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+  size_t mask_;
+  /** 64 - log2(capacity), HomeOf() keeps the top bits of the product. */
+  int shift_;
+  size_t max_size_;
+  std::atomic<size_t> size_{0};
+  /** Odd while Remove() is moving entries around. */
+  std::atomic<uint64_t> version_{0};
+  std::mutex write_latch_;
+};
+
+}  // namespace bustub
@@ -17,6 +17,7 @@
 #include <vector>
 
 #include "catalog/catalog.h"
+#include "common/config.h"
 #include "concurrency/transaction.h"
 #include "storage/page/tmp_tuple_page.h"
 
@@ -33,10 +34,19 @@ class ExecutorContext {
    * @param bpm The buffer pool manager that the executor uses
    * @param txn_mgr The transaction manager that the executor uses
    * @param lock_mgr The lock manager that the executor uses
+   * @param execution_threads The number of threads a parallel executor may use, 1 runs everything serially
+   * @param hash_join_memory_limit The bytes of tuples a hash join may keep in memory before spilling to disk
    */
   ExecutorContext(Transaction *transaction, Catalog *catalog, BufferPoolManager *bpm, TransactionManager *txn_mgr,
-                  LockManager *lock_mgr)
-      : transaction_(transaction), catalog_{catalog}, bpm_{bpm}, txn_mgr_(txn_mgr), lock_mgr_(lock_mgr) {}
+                  LockManager *lock_mgr, size_t execution_threads = 1,
+                  size_t hash_join_memory_limit = HASH_JOIN_MEMORY_LIMIT)
+      : transaction_(transaction),
+        catalog_{catalog},
+        bpm_{bpm},
+        txn_mgr_(txn_mgr),
+        lock_mgr_(lock_mgr),
+        execution_threads_(execution_threads),
+        hash_join_memory_limit_(hash_join_memory_limit) {}
 
   ~ExecutorContext() = default;
 
@@ -60,6 +70,12 @@ class ExecutorContext {
   /** @return the transaction manager */
   auto GetTransactionManager() -> TransactionManager * { return txn_mgr_; }
 
+  /** @return the number of threads a parallel executor may use */
+  auto GetExecutionThreads() const -> size_t { return execution_threads_; }
+
+  /** @return the bytes of tuples a hash join may keep in memory */
+  auto GetHashJoinMemoryLimit() const -> size_t { return hash_join_memory_limit_; }
+
  private:
   /** The transaction context associated with this executor context */
   Transaction *transaction_;
@@ -71,6 +87,10 @@ class ExecutorContext {
   TransactionManager *txn_mgr_;
   /** The lock manager associated with this executor context */
   LockManager *lock_mgr_;
+  /** The number of threads a parallel executor may use */
+  size_t execution_threads_;
+  /** The bytes of tuples a hash join may keep in memory */
+  size_t hash_join_memory_limit_;
 };
 
 }  // namespace bustub
@@ -14,12 +14,16 @@
 
 #include "execution/executor_context.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_batch.h"
 
 namespace bustub {
 /**
  * The AbstractExecutor implements the Volcano tuple-at-a-time iterator model.
  * This is the base class from which all executors in the BustTub execution
  * engine inherit, and defines the minimal interface that all executors support.
+ *
+ * Executors can also be pulled a batch of rows at a time with NextBatch(). An
+ * executor is driven by one of Next() and NextBatch() only, its parent picks.
  */
 class AbstractExecutor {
  public:
@@ -46,6 +50,23 @@ class AbstractExecutor {
    */
   virtual auto Next(Tuple *tuple, RID *rid) -> bool = 0;
 
+  /**
+   * Yield the next batch of tuples from this executor. Executors that do not
+   * produce batches themselves fill it by calling Next().
+   * @param[out] batch The batch the tuples are stored in, it is reset first
+   * @return `true` if at least one tuple was selected in the batch, `false` if
+   * there are no more tuples
+   */
+  virtual auto NextBatch(TupleBatch *batch) -> bool {
+    batch->Reset(&GetOutputSchema());
+    Tuple tuple;
+    RID rid;
+    while (!batch->IsFull() && Next(&tuple, &rid)) {
+      batch->Append(tuple, rid);
+    }
+    return !batch->IsEmpty();
+  }
+
   /** @return The schema of the tuples that this executor produces */
   virtual auto GetOutputSchema() const -> const Schema & = 0;
 
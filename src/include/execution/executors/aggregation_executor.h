@@ -132,6 +132,54 @@ class SimpleAggregationHashTable {
     CombineAggregateValues(&ht_[agg_key], agg_val);
   }
 
+  /**
+   * Merges a partial aggregation result, computed by another table over other tuples, into the aggregation result.
+   * @param[out] result The output aggregate value
+   * @param partial The partial aggregate value
+   */
+  void MergeAggregateValues(AggregateValue *result, const AggregateValue &partial) {
+    for (uint32_t i = 0; i < agg_exprs_.size(); i++) {
+      auto &this_result = result->aggregates_.at(i);
+      auto &this_partial = partial.aggregates_.at(i);
+      if (this_partial.IsNull()) {
+        continue;
+      }
+      if (this_result.IsNull()) {
+        this_result = this_partial;
+        continue;
+      }
+      switch (agg_types_[i]) {
+        case AggregationType::CountStarAggregate:
+        case AggregationType::CountAggregate:
+        case AggregationType::SumAggregate:
+          this_result = this_result.Add(this_partial);
+          break;
+        case AggregationType::MinAggregate:
+          if (this_result.CompareGreaterThan(this_partial) == CmpBool::CmpTrue) {
+            this_result = this_partial;
+          }
+          break;
+        case AggregationType::MaxAggregate:
+          if (this_result.CompareLessThan(this_partial) == CmpBool::CmpTrue) {
+            this_result = this_partial;
+          }
+          break;
+      }
+    }
+  }
+
+  /**
+   * Inserts a partial aggregation result into the hash table and then merges it with the current aggregation.
+   * @param agg_key the key to be inserted
+   * @param agg_val the partial aggregate value to be inserted
+   */
+  void InsertMerge(const AggregateKey &agg_key, const AggregateValue &agg_val) {
+    if (ht_.count(agg_key) == 0) {
+      ht_.insert({agg_key, GenerateInitialAggregateValue()});
+    }
+    MergeAggregateValues(&ht_[agg_key], agg_val);
+  }
+
   /**
    * Clear the hash table
    */
@@ -208,6 +256,13 @@ class AggregationExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of tuples from the aggregation.
+   * @param[out] batch The batch the tuples are stored in
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the aggregation */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
@@ -215,24 +270,58 @@ class AggregationExecutor : public AbstractExecutor {
   auto GetChildExecutor() const -> const AbstractExecutor *;
 
  private:
-  /** @return The tuple as an AggregateKey */
-  auto MakeAggregateKey(const Tuple *tuple) -> AggregateKey {
+  /** @return The values of each expression for every selected tuple of the batch, a column per expression */
+  static auto EvaluateColumns(const std::vector<AbstractExpressionRef> &exprs, const TupleBatch &batch)
+      -> std::vector<std::vector<Value>> {
+    std::vector<std::vector<Value>> columns;
+    columns.reserve(exprs.size());
+    for (const auto &expr : exprs) {
+      columns.emplace_back(expr->EvaluateBatch(batch));
+    }
+    return columns;
+  }
+
+  /** @return The i'th selected tuple of a batch as an AggregateKey, given its group by columns */
+  static auto MakeAggregateKey(const std::vector<std::vector<Value>> &group_bys, size_t i) -> AggregateKey {
     std::vector<Value> keys;
-    for (const auto &expr : plan_->GetGroupBys()) {
-      keys.emplace_back(expr->Evaluate(tuple, child_->GetOutputSchema()));
+    keys.reserve(group_bys.size());
+    for (const auto &column : group_bys) {
+      keys.emplace_back(column[i]);
     }
     return {keys};
   }
 
-  /** @return The tuple as an AggregateValue */
-  auto MakeAggregateValue(const Tuple *tuple) -> AggregateValue {
+  /** @return The i'th selected tuple of a batch as an AggregateValue, given its aggregate columns */
+  static auto MakeAggregateValue(const std::vector<std::vector<Value>> &aggregates, size_t i) -> AggregateValue {
     std::vector<Value> vals;
-    for (const auto &expr : plan_->GetAggregates()) {
-      vals.emplace_back(expr->Evaluate(tuple, child_->GetOutputSchema()));
+    vals.reserve(aggregates.size());
+    for (const auto &column : aggregates) {
+      vals.emplace_back(column[i]);
     }
     return {vals};
   }
 
+  /** Combine every selected tuple of a batch of the child's output into an aggregation hash table. */
+  void AggregateBatch(const TupleBatch &batch, SimpleAggregationHashTable *aht) const {
+    // Evaluate the expressions a batch at a time, only the hash table is updated per tuple.
+    const auto group_bys = EvaluateColumns(plan_->GetGroupBys(), batch);
+    const auto aggregates = EvaluateColumns(plan_->GetAggregates(), batch);
+    for (size_t i = 0; i < batch.GetSelection().size(); i++) {
+      aht->InsertCombine(MakeAggregateKey(group_bys, i), MakeAggregateValue(aggregates, i));
+    }
+  }
+
+  /**
+   * Build the hash table with a parallel scan of the table, if the child is a sequential scan, possibly filtered,
+   * and the query may use more than one thread. Every worker aggregates the morsels it scans into a table of its
+   * own, and the partial results are merged once the scan is done.
+   * @return `false` if the hash table has to be built from the child executor instead
+   */
+  auto AggregateInParallel() -> bool;
+
+  /** Produce the values of the next output tuple, `false` if there are no more */
+  auto NextValues(std::vector<Value> *values) -> bool;
+
  private:
   enum class EmptyStatus { kEmpty, kNotEmpty, kReturnedForEmpty };
   /** The aggregation plan node */
@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <unordered_map>
 #include <utility>
@@ -21,6 +23,7 @@
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/hash_join_plan.h"
+#include "execution/spill_file.h"
 #include "storage/table/tuple.h"
 
 namespace std {
@@ -44,7 +47,18 @@ namespace bustub {
 
 auto operator==(const bustub::Value &x, const bustub::Value &y) -> bool;
 /**
- * HashJoinExecutor executes a nested-loop JOIN on two tables.
+ * HashJoinExecutor executes a hash JOIN on two tables, building a hash table on the right side and probing it with
+ * the left side.
+ *
+ * If the query may use more than one thread, both sides are materialized and split into partitions by the bits of
+ * the hash of their join key, so that every partition of the build side fits in cache. The partitions are then built
+ * and probed independently by a pool of workers.
+ *
+ * The build side is kept within the memory limit of the executor context (a hybrid hash join). Once it grows past
+ * the limit the tuples are split into partitions by their hash, and the largest partitions are spilled to disk until
+ * the rest fits. Left tuples of a spilled partition are spilled as well instead of probed, and once the left side is
+ * done every pair of spilled partitions is joined the same way, split again with the next bits of the hash if it
+ * still does not fit.
  */
 class HashJoinExecutor : public AbstractExecutor {
  public:
@@ -72,49 +86,132 @@ class HashJoinExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of tuples from the join.
+   * @param[out] batch The batch the joined tuples are stored in.
+   * @return `true` if a tuple was produced, `false` if there are no more
+   * tuples.
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the join */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
-  void Build();
-
  private:
+  /** Fills a batch with the next tuples of an input, `false` once there are none. */
+  using BatchSource = std::function<bool(TupleBatch *)>;
+
   class HashTable {
    public:
     HashTable() = default;
 
     ~HashTable() = default;
 
-    void Insert(const Value &value, const Tuple &tuple, RID rid) {
-      if (table_indices_.count(value) == 0) {
-        table_indices_[value] = 0;
-      }
-      table_[value].emplace_back(tuple, rid);
+    void Insert(const Value &value, std::vector<Value> row) { table_[value].emplace_back(std::move(row)); }
+
+    /** @return The values of the rows inserted with a key equal to value, `nullptr` if there are none */
+    auto Find(const Value &value) const -> const std::vector<std::vector<Value>> * {
+      auto iter = table_.find(value);
+      return iter == table_.end() ? nullptr : &iter->second;
     }
 
-    auto Find(const Value &value, Tuple &tuple, RID &rid) -> bool {
-      if (table_indices_.count(value) > 0) {
-        auto &index = table_indices_[value];
-        if (index >= table_[value].size()) {
-          return false;
+    /** Remove the rows of every key pred holds for, handing each of them to consume. */
+    template <typename Pred, typename Consume>
+    void RemoveIf(Pred pred, Consume consume) {
+      for (auto iter = table_.begin(); iter != table_.end();) {
+        if (!pred(iter->first)) {
+          ++iter;
+          continue;
+        }
+        for (auto &row : iter->second) {
+          consume(std::move(row));
         }
-        tuple = table_[value][index].first;
-        rid = table_[value][index].second;
-        ++index;
-        return true;
+        iter = table_.erase(iter);
       }
-      return false;
     }
 
-    auto Contain(const Value &value) -> bool { return table_indices_.count(value) > 0; }
-
-    void Reset(const Value &value) { table_indices_[value] = 0; }
+    void Clear() { table_.clear(); }
 
    private:
-    std::unordered_map<Value, std::vector<std::pair<Tuple, RID>>> table_;
-    std::unordered_map<Value, size_t> table_indices_;
+    std::unordered_map<Value, std::vector<std::vector<Value>>> table_;
+  };
+
+  /** The tuples of one side of a parallel join, materialized and split into partitions. */
+  struct PartitionedInput {
+    std::vector<TupleBatch> batches_;
+    /** The join key of every selected tuple of every batch, in the order of the selection. */
+    std::vector<std::vector<Value>> keys_;
+    /** The tuples per worker and partition, as the index of their batch and their position in its selection. */
+    std::vector<std::vector<std::vector<std::pair<uint32_t, uint32_t>>>> rows_;
+  };
+
+  /** A pair of partitions spilled by a pass over the inputs, joined by a later one. */
+  struct SpilledPartition {
+    std::unique_ptr<SpillFile> right_;
+    std::unique_ptr<SpillFile> left_;
+    /** The pass joining the partition splits it with the bits of the hash of this level. */
+    uint32_t level_;
   };
 
-  void AddTupleValuesTo(std::vector<Value> &values, bustub::Tuple *tuple, const bustub::Schema &schema);
+  /** @return An estimate of the memory the values take */
+  static auto EstimateSize(const std::vector<Value> &values) -> size_t;
+
+  /** @return An estimate of the memory the selected tuples of a batch take */
+  static auto EstimateSize(const TupleBatch &batch) -> size_t;
+
+  /**
+   * Pull batches from a child until it is done or memory_limit bytes are materialized.
+   * @param[out] batches the batches pulled, appended to
+   * @return `true` if the child is done
+   */
+  static auto Materialize(AbstractExecutor *child, size_t memory_limit, std::vector<TupleBatch> *batches) -> bool;
+
+  /** Build the hash table of the resident partitions from the right tuples, spilling partitions if they do not fit. */
+  void Build(const BatchSource &right, uint32_t level);
+
+  /** Spill the resident partition taking the most memory, `false` if none is left. */
+  auto SpillLargestPartition() -> bool;
+
+  /** Spill the tuples of the left batch whose partition is spilled, instead of probing with them. */
+  void SpillLeftBatch();
+
+  /** Start joining the next pair of spilled partitions, `false` if there are none left. */
+  auto NextPass() -> bool;
+
+  /** @return The partition a join key belongs to when splitting at the current level */
+  auto SpillPartitionOf(const Value &key) const -> size_t {
+    const auto hash = static_cast<uint64_t>(std::hash<Value>{}(key)) * 0x9E3779B97F4A7C15ULL;
+    return (hash >> (64 - SPILL_BITS * (level_ + 1))) & (HASH_JOIN_SPILL_PARTITIONS - 1);
+  }
+
+  /** Evaluate the join keys of the materialized tuples and split them into partitions, using every worker. */
+  void Partition(PartitionedInput *input, const AbstractExpression &key_expr) const;
+
+  /** Partition the materialized right side and build a hash table per partition, using every worker. */
+  void BuildPartitioned(std::vector<TupleBatch> batches);
+
+  /**
+   * Probe the partitions with the current chunk of the left side, partitioning the next chunk first if every
+   * partition was probed with it, using every worker. Stops claiming partitions once the results reach half the
+   * memory limit, the rest are probed once those are emitted.
+   */
+  void ProbePartitioned();
+
+  /** @return The partition a join key with the given hash belongs to */
+  auto PartitionOf(size_t hash) const -> size_t {
+    // Use the top bits of the mixed hash, the hash tables of the partitions bucket by all of them.
+    return radix_bits_ == 0 ? 0 : (static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ULL) >> (64 - radix_bits_);
+  }
+
+  /** Produce the values of the next joined tuple, pulling batches from the left child as needed. */
+  auto NextValues(std::vector<Value> *values) -> bool;
+
+  /** Look up the right tuples matching the left tuple at the probe position. */
+  void Probe();
+
+  /** The number of bits of the hash a spilling join splits a partition by. */
+  static constexpr uint32_t SPILL_BITS = 3;
+  static_assert(HASH_JOIN_SPILL_PARTITIONS == 1 << SPILL_BITS);
 
   bool done_;
   bool result_generated_;
@@ -123,9 +220,51 @@ class HashJoinExecutor : public AbstractExecutor {
   std::unique_ptr<AbstractExecutor> left_child_;
   std::unique_ptr<AbstractExecutor> right_child_;
   HashTable hash_table_;
+  /** The bytes of tuples the join may keep in memory. */
+  size_t memory_limit_;
+
+  /** Where the left tuples come from, the left child at first and the spilled partitions later. */
+  BatchSource left_source_;
+  /** The level of the current pass, the one over the children is 0. */
+  uint32_t level_;
+  /** The spilled partitions of the current pass, nullptr for resident ones. */
+  std::vector<std::unique_ptr<SpillFile>> right_spills_;
+  std::vector<std::unique_ptr<SpillFile>> left_spills_;
+  /** The memory the tuples of every resident partition take, and all of them. */
+  std::vector<size_t> resident_bytes_;
+  size_t memory_used_;
+  /** Whether the pass over the children spilled, the hash table then has to be built again by Init(). */
+  bool spilled_;
+  /** The partitions left to join, and the ones being joined. */
+  std::vector<SpilledPartition> pending_;
+  SpilledPartition current_;
+
+  /** The left tuples being probed, a batch at a time. */
+  TupleBatch left_batch_;
+  /** The join key of every selected tuple of the left batch. */
+  std::vector<Value> left_keys_;
+  /** The position in the selection of the left batch of the tuple being probed. */
+  size_t left_pos_;
+  /** The right tuples matching the tuple being probed, and how many of them were joined with it. */
+  const std::vector<std::vector<Value>> *matches_;
+  size_t match_pos_;
 
-  Tuple current_left_tuple_;
-  RID current_left_rid_;
+  /** The number of workers, with more than one the join runs partitioned if the right side fits in memory. */
+  size_t threads_;
+  bool partitioned_;
+  /** Whether the partitioned join has probed with every left tuple. */
+  bool left_done_;
+  /** The partitions are numbered by the top radix_bits_ of the hash of the join key. */
+  uint32_t radix_bits_;
+  /** The hash table of every partition of the right side. */
+  std::vector<HashTable> partitions_;
+  /** The chunk of the left side being probed, at most half the memory limit, and the next partition to probe. */
+  PartitionedInput left_chunk_;
+  size_t probe_partition_;
+  /** The joined tuples of every partition probed, and the position of the next one to emit. */
+  std::vector<std::vector<std::vector<Value>>> results_;
+  size_t result_partition_;
+  size_t result_pos_;
 };
 
 }  // namespace bustub
@@ -43,10 +43,15 @@ class IndexScanExecutor : public AbstractExecutor {
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
  private:
+  /** Release the row locks that are not held until commit. */
+  void FinishScan();
+
   /** The index scan plan node to be executed. */
   const IndexScanPlanNode *plan_;
-  BPlusTreeIndexForOneIntegerColumn *tree_;
   TableInfo *table_info_;
-  std::unique_ptr<IndexIterator<GenericKey<4>, RID, GenericComparator<4>>> current_iterator_;
+  /** Walks the index in key order, whatever key size it was created with. */
+  std::unique_ptr<IndexCursor> cursor_;
+  /** The rows locked by the scan. */
+  std::vector<RID> locked_rids_;
 };
 }  // namespace bustub
@@ -68,6 +68,8 @@ class InsertExecutor : public AbstractExecutor {
   std::unique_ptr<Schema> schema_;
   std::unique_ptr<std::vector<IndexInfo *>> indices_;
   std::vector<RID> locked_rids_;
+  /** Keeps a bulk insert from flushing the buffer pool. */
+  std::unique_ptr<BufferAccessStrategy> strategy_;
 };
 
 }  // namespace bustub
@@ -29,6 +29,10 @@ namespace bustub {
 
 /**
  * IndexJoinExecutor executes index join operations.
+ *
+ * Outer tuples are read in batches of INDEX_JOIN_BATCH_SIZE, and the keys of a
+ * batch are looked up in the index at once, see Index::ScanKeys(). Joined
+ * tuples come out in the order of the outer tuples.
  */
 class NestIndexJoinExecutor : public AbstractExecutor {
  public:
@@ -48,9 +52,19 @@ class NestIndexJoinExecutor : public AbstractExecutor {
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
  private:
-  void AddTupleValuesTo(std::vector<Value> &values, Tuple *tuple, const Schema &schema);
+  void AddTupleValuesTo(std::vector<Value> &values, const Tuple *tuple, const Schema &schema);
+  /** Read the next batch of outer tuples and look up their keys. @return false if there are no outer tuples left */
+  auto FetchOuterBatch() -> bool;
   /** The nested index join plan node. */
   const NestedIndexJoinPlanNode *plan_;
   std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The outer tuples of the current batch */
+  std::vector<Tuple> left_tuples_;
+  /** The RIDs the index holds for the key of every outer tuple of the batch */
+  std::vector<std::vector<RID>> results_;
+  /** The next outer tuple of the batch to join */
+  size_t cursor_{0};
+  /** The next RID of the outer tuple at cursor_ to join it with */
+  size_t match_{0};
 };
 }  // namespace bustub
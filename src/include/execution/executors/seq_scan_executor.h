@@ -16,6 +16,7 @@
 #include <memory>
 #include <vector>
 
+#include "buffer/page_read_ahead.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/seq_scan_plan.h"
@@ -46,15 +47,32 @@ class SeqScanExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of tuples from the sequential scan.
+   * @param[out] batch The batch the scanned tuples are stored in
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the sequential scan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
  private:
+  /** Read and lock the tuple at the scan position and move past it, `false` at the end of the table. */
+  auto ScanTuple(Tuple *tuple, RID *rid) -> bool;
+
+  /** Release the row locks the scan does not need to hold any longer once it reached the end. */
+  void FinishScan();
+
   /** The sequential scan plan node to be executed */
   std::vector<RID> locked_rids_;
   const SeqScanPlanNode *plan_;
   std::unique_ptr<TableIterator> table_current_iterator_;
   std::unique_ptr<TableIterator> table_end_iterator_;
   TableHeap *table_;
+  /** Keeps a large scan from flushing the buffer pool. */
+  std::unique_ptr<BufferAccessStrategy> strategy_;
+  /** Keeps the table pages after the scan position prefetched. */
+  std::unique_ptr<PageReadAhead> read_ahead_;
 };
 }  // namespace bustub
@@ -20,6 +20,7 @@
 #include "catalog/schema.h"
 #include "fmt/format.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_batch.h"
 
 #define BUSTUB_EXPR_CLONE_WITH_CHILDREN(cname)                                                                   \
   auto CloneWithChildren(std::vector<AbstractExpressionRef> children) const->std::unique_ptr<AbstractExpression> \
@@ -68,6 +69,22 @@ class AbstractExpression {
   virtual auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
                             const Schema &right_schema) const -> Value = 0;
 
+  /**
+   * Evaluate the expression on every selected row of a batch. Unless overridden, each row is serialized into a
+   * tuple and passed to Evaluate().
+   * @param batch The rows, of the schema the expression refers to
+   * @return One value per selected row, in the order of the selection vector
+   */
+  virtual auto EvaluateBatch(const TupleBatch &batch) const -> std::vector<Value> {
+    std::vector<Value> values;
+    values.reserve(batch.GetSelection().size());
+    for (const auto row : batch.GetSelection()) {
+      const auto tuple = batch.GetTuple(row);
+      values.emplace_back(Evaluate(&tuple, batch.GetSchema()));
+    }
+    return values;
+  }
+
   /** @return the child_idx'th child of this expression */
   auto GetChildAt(uint32_t child_idx) const -> const AbstractExpressionRef & { return children_[child_idx]; }
 
@@ -68,6 +68,17 @@ class ArithmeticExpression : public AbstractExpression {
     return ValueFactory::GetIntegerValue(*res);
   }
 
+  auto EvaluateBatch(const TupleBatch &batch) const -> std::vector<Value> override {
+    auto values = GetChildAt(0)->EvaluateBatch(batch);
+    const auto rhs = GetChildAt(1)->EvaluateBatch(batch);
+    for (size_t i = 0; i < values.size(); i++) {
+      auto res = PerformComputation(values[i], rhs[i]);
+      values[i] = res == std::nullopt ? ValueFactory::GetNullValueByType(TypeId::INTEGER)
+                                      : ValueFactory::GetIntegerValue(*res);
+    }
+    return values;
+  }
+
   /** @return the string representation of the expression node and its children
    */
   auto ToString() const -> std::string override {
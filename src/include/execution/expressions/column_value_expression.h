@@ -48,6 +48,16 @@ class ColumnValueExpression : public AbstractExpression {
                            : right_tuple->GetValue(&right_schema, col_idx_);
   }
 
+  auto EvaluateBatch(const TupleBatch &batch) const -> std::vector<Value> override {
+    const auto &column = batch.GetColumn(col_idx_);
+    std::vector<Value> values;
+    values.reserve(batch.GetSelection().size());
+    for (const auto row : batch.GetSelection()) {
+      values.emplace_back(column[row]);
+    }
+    return values;
+  }
+
   auto GetTupleIdx() const -> uint32_t { return tuple_idx_; }
   auto GetColIdx() const -> uint32_t { return col_idx_; }
 
@@ -50,6 +50,15 @@ class ComparisonExpression : public AbstractExpression {
     return ValueFactory::GetBooleanValue(PerformComparison(lhs, rhs));
   }
 
+  auto EvaluateBatch(const TupleBatch &batch) const -> std::vector<Value> override {
+    auto values = GetChildAt(0)->EvaluateBatch(batch);
+    const auto rhs = GetChildAt(1)->EvaluateBatch(batch);
+    for (size_t i = 0; i < values.size(); i++) {
+      values[i] = ValueFactory::GetBooleanValue(PerformComparison(values[i], rhs[i]));
+    }
+    return values;
+  }
+
   /** @return the string representation of the expression node and its children
    */
   auto ToString() const -> std::string override {
@@ -34,6 +34,10 @@ class ConstantValueExpression : public AbstractExpression {
     return val_;
   }
 
+  auto EvaluateBatch(const TupleBatch &batch) const -> std::vector<Value> override {
+    return std::vector<Value>(batch.GetSelection().size(), val_);
+  }
+
   /** @return the string representation of the plan node and its children */
   auto ToString() const -> std::string override { return val_.ToString(); }
 
@@ -0,0 +1,146 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// expression_program.h
+//
+// Identification: src/include/execution/expressions/expression_program.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/arithmetic_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "storage/table/tuple.h"
+#include "storage/table/tuple_batch.h"
+#include "type/type_id.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * ExpressionProgram is an expression compiled once into a flat list of instructions, which is run instead of
+ * walking the expression tree through virtual calls for every tuple.
+ *
+ * Every instruction writes one register, a vector holding a value for each row the program runs on. Integer and
+ * boolean results live in registers of plain 64-bit lanes with a separate null flag per row, so that comparisons,
+ * arithmetic and logic are tight loops over them rather than operations on Values. Everything else, and the
+ * expressions the program does not know, is kept in registers of Values, the latter evaluated through the tree.
+ *
+ * Programs hold their registers between runs and are not thread-safe.
+ */
+class ExpressionProgram {
+ public:
+  /**
+   * Compile an expression.
+   * @param expr the expression, which has to outlive the program
+   */
+  explicit ExpressionProgram(const AbstractExpression &expr);
+
+  /** @return the value of the expression for the tuple */
+  auto Evaluate(const Tuple *tuple, const Schema &schema) -> Value;
+
+  /** @return the value of the expression for every selected row of the batch, in the order of the selection */
+  auto EvaluateBatch(const TupleBatch &batch) -> std::vector<Value>;
+
+  /** @return whether the boolean expression is true for the tuple, NULL is not */
+  auto IsTrue(const Tuple *tuple, const Schema &schema) -> bool;
+
+  /** @return the selected rows of the batch the boolean expression is true for */
+  auto Select(const TupleBatch &batch) -> std::vector<uint32_t>;
+
+  /** @return the number of instructions, for tests */
+  auto GetInstructionCount() const -> size_t { return instructions_.size(); }
+
+ private:
+  /** How the values of a register are stored. */
+  enum class RegisterKind { Integer, Boolean, Value };
+
+  enum class OpCode {
+    LoadColumn,
+    LoadConstant,
+    EvaluateTree,
+    ToInteger,
+    ToBoolean,
+    ToValue,
+    CompareIntegers,
+    CompareValues,
+    Arithmetic,
+    Logic,
+  };
+
+  struct Register {
+    RegisterKind kind_;
+    /** The type of the values, only integer types for RegisterKind::Integer. */
+    TypeId type_;
+    /** The lanes of integer and boolean registers, booleans are 0 or 1. */
+    std::vector<int64_t> lanes_;
+    /** Whether the value of a row is NULL, for integer and boolean registers. */
+    std::vector<uint8_t> nulls_;
+    /** The values of value registers. */
+    std::vector<Value> values_;
+  };
+
+  struct Instruction {
+    OpCode op_;
+    /** The register written, every instruction writes its own. */
+    uint32_t dst_;
+    uint32_t lhs_{0};
+    uint32_t rhs_{0};
+    /** The column of LoadColumn. */
+    uint32_t column_{0};
+    /** The expression EvaluateTree evaluates, and the one LoadConstant loads the value of. */
+    const AbstractExpression *expr_{nullptr};
+    ComparisonType comparison_{ComparisonType::Equal};
+    ArithmeticType arithmetic_{ArithmeticType::Plus};
+    LogicType logic_{LogicType::And};
+  };
+
+  /** The rows a program runs on, either a single tuple or the selected rows of a batch. */
+  struct Input {
+    const TupleBatch *batch_;
+    const Tuple *tuple_;
+    const Schema *schema_;
+
+    auto RowCount() const -> size_t { return batch_ != nullptr ? batch_->GetSelection().size() : 1; }
+  };
+
+  /** @return the register holding the result of expr, after appending the instructions computing it */
+  auto Compile(const AbstractExpression &expr) -> uint32_t;
+
+  /** @return the register holding the values of src stored as kind, src itself if they already are */
+  auto Convert(uint32_t src, RegisterKind kind) -> uint32_t;
+
+  /** @return a new register, the destination of the instruction appended next */
+  auto Emit(Instruction instruction, RegisterKind kind, TypeId type) -> uint32_t;
+
+  /** Run every instruction on the input. */
+  void Run(const Input &input);
+
+  void Execute(const Instruction &instruction, const Input &input, size_t row_count);
+
+  /** @return the value of the row in the register */
+  static auto GetValue(const Register &reg, size_t row) -> Value;
+
+  std::vector<Instruction> instructions_;
+  std::vector<Register> registers_;
+  /** The register holding the value of the whole expression. */
+  uint32_t result_;
+  /** The register each column is loaded into, and the conversions of registers emitted, while compiling. */
+  std::unordered_map<uint32_t, uint32_t> column_registers_;
+  std::map<std::pair<uint32_t, RegisterKind>, uint32_t> conversions_;
+};
+
+}  // namespace bustub
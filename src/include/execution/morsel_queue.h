@@ -0,0 +1,101 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_queue.h
+//
+// Identification: src/include/execution/morsel_queue.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/page_read_ahead.h"
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "common/rid.h"
+#include "concurrency/transaction.h"
+#include "storage/table/tuple_batch.h"
+
+namespace bustub {
+
+/**
+ * MorselQueue hands out the pages of a table heap to the workers of a parallel scan, a few consecutive pages (a
+ * morsel) at a time. Workers that finish early simply claim more morsels, so the work stays balanced however the
+ * tuples are spread over the pages.
+ *
+ * The pages are linked by their next page id, so the queue follows the chain itself while handing out morsels and
+ * keeps the pages after the last morsel prefetched. Only the queue is shared, see MorselScanner for the workers.
+ */
+class MorselQueue {
+ public:
+  /**
+   * @param bpm the buffer pool the table heap lives in
+   * @param first_page_id the first page of the table heap
+   * @param morsel_pages the number of pages handed out at once
+   */
+  MorselQueue(BufferPoolManager *bpm, page_id_t first_page_id, size_t morsel_pages = MORSEL_PAGES);
+
+  /**
+   * Claim the next morsel, thread safe.
+   * @param[out] page_ids the pages of the morsel, in chain order
+   * @return false once every page has been handed out
+   */
+  auto Next(std::vector<page_id_t> *page_ids) -> bool;
+
+  /** Stop handing out morsels, e.g. because a worker failed and the result is of no use anymore. */
+  void Close();
+
+ private:
+  BufferPoolManager *bpm_;
+  size_t morsel_pages_;
+  std::mutex latch_;
+  /** The first page not handed out yet, INVALID_PAGE_ID at the end of the chain. */
+  page_id_t next_page_id_;
+  PageReadAhead read_ahead_;
+};
+
+/**
+ * MorselScanner is a worker of a parallel scan. It reads the tuples of the morsels it claims from a MorselQueue a
+ * batch at a time, the same way a TableIterator does.
+ */
+class MorselScanner {
+ public:
+  /**
+   * @param queue the queue shared by all workers of the scan
+   * @param bpm the buffer pool the table heap lives in
+   * @param txn the transaction scanning, it has to hold a lock covering the whole table
+   * @param schema the schema of the table
+   */
+  MorselScanner(MorselQueue *queue, BufferPoolManager *bpm, Transaction *txn, const Schema *schema);
+
+  /**
+   * Read the next tuples.
+   * @param[out] batch the batch the tuples are stored in
+   * @return `true` if a tuple was read, `false` once the queue ran out of morsels
+   */
+  auto NextBatch(TupleBatch *batch) -> bool;
+
+ private:
+  /** Append the tuples of the current page to the batch, until the batch is full or the page is done. */
+  void ScanPage(TupleBatch *batch);
+
+  MorselQueue *queue_;
+  BufferPoolManager *bpm_;
+  Transaction *txn_;
+  const Schema *schema_;
+  /** The pages of the morsel claimed last and the one of them the scan is on. */
+  std::vector<page_id_t> morsel_;
+  size_t page_pos_{0};
+  /** The tuple read last if the batch filled up in the middle of the current page. */
+  RID last_rid_;
+  bool resume_{false};
+};
+
+}  // namespace bustub
@@ -34,21 +34,45 @@ class IndexScanPlanNode : public AbstractPlanNode {
   IndexScanPlanNode(SchemaRef output, index_oid_t index_oid)
       : AbstractPlanNode(std::move(output), {}), index_oid_(index_oid) {}
 
+  /**
+   * Creates a new index scan plan node over part of the index.
+   * @param output the output format of this scan plan node
+   * @param index_oid the identifier of the index to be scanned
+   * @param range the bounds and direction of the scan
+   */
+  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid, IndexRange range)
+      : AbstractPlanNode(std::move(output), {}), index_oid_(index_oid), range_(std::move(range)) {}
+
   auto GetType() const -> PlanType override { return PlanType::IndexScan; }
 
   /** @return the identifier of the table that should be scanned */
   auto GetIndexOid() const -> index_oid_t { return index_oid_; }
 
+  /** @return the part of the index that should be scanned */
+  auto GetRange() const -> const IndexRange & { return range_; }
+
   BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(IndexScanPlanNode);
 
   /** The table whose tuples should be scanned. */
   index_oid_t index_oid_;
 
   // Add anything you want here for index lookup
+  /** The part of the index to scan, all of it by default. */
+  IndexRange range_;
 
  protected:
   auto PlanNodeToString() const -> std::string override {
-    return fmt::format("IndexScan {{ index_oid={} }}", index_oid_);
+    if (range_.IsFull()) {
+      return fmt::format("IndexScan {{ index_oid={} }}", index_oid_);
+    }
+    const auto lower = range_.lower_.has_value() ? fmt::format("{}{}", range_.lower_inclusive_ ? "[" : "(",
+                                                               range_.lower_->ToString())
+                                                 : std::string("(-inf");
+    const auto upper = range_.upper_.has_value() ? fmt::format("{}{}", range_.upper_->ToString(),
+                                                               range_.upper_inclusive_ ? "]" : ")")
+                                                 : std::string("+inf)");
+    return fmt::format("IndexScan {{ index_oid={}, range={}, {}{} }}", index_oid_, lower, upper,
+                       range_.reverse_ ? ", reverse" : "");
   }
 };
 
@@ -0,0 +1,80 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// spill_file.h
+//
+// Identification: src/include/execution/spill_file.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/schema.h"
+#include "common/macros.h"
+#include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tuple.h"
+#include "storage/table/tuple_batch.h"
+
+namespace bustub {
+
+/**
+ * SpillFile holds tuples an operator cannot keep in memory. The tuples are stored in TmpTuplePages of the buffer
+ * pool, which writes them to disk once they are evicted, so only the page being written or read stays pinned.
+ *
+ * Tuples are appended, then read back once a batch at a time, in no particular order. Every page is deleted as
+ * soon as it has been read, the rest by the destructor.
+ */
+class SpillFile {
+ public:
+  /**
+   * @param bpm the buffer pool the pages are allocated from
+   * @param schema the schema of the tuples, which has to outlive the file
+   */
+  SpillFile(BufferPoolManager *bpm, const Schema *schema);
+
+  ~SpillFile();
+
+  DISALLOW_COPY_AND_MOVE(SpillFile);
+
+  /** Append a tuple. Must not be called once reading started. */
+  void Append(const Tuple &tuple);
+
+  /**
+   * Read the next tuples.
+   * @param[out] batch the batch the tuples are stored in
+   * @return `true` if a tuple was read, `false` once every tuple has been
+   */
+  auto NextBatch(TupleBatch *batch) -> bool;
+
+  /** @return the schema of the tuples */
+  auto GetSchema() const -> const Schema & { return *schema_; }
+
+  /** @return the number of tuples appended */
+  auto GetTupleCount() const -> size_t { return tuple_count_; }
+
+  /** @return the number of pages the tuples take */
+  auto GetPageCount() const -> size_t { return page_ids_.size(); }
+
+ private:
+  /** Unpin the page being written, once it is full or reading starts. */
+  void FinishPage();
+
+  BufferPoolManager *bpm_;
+  const Schema *schema_;
+  std::vector<page_id_t> page_ids_;
+  /** The last page, pinned while tuples are appended to it. */
+  TmpTuplePage *write_page_{nullptr};
+  size_t tuple_count_{0};
+  bool reading_{false};
+  /** The page of the next tuple to read, and the offset of the tuple in it, 0 before the page was opened. */
+  size_t read_page_{0};
+  uint32_t read_offset_{0};
+};
+
+}  // namespace bustub
@@ -139,13 +139,42 @@ class Optimizer {
   auto IsPredicateTrue(const AbstractExpression &expr) -> bool;
 
   /**
-   * @brief optimize order by as index scan if there's an index on a table
+   * @brief optimize order by as index scan if there's an index on a table, in reverse for descending order bys
    */
   auto OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
-  /** @brief check if the index can be matched */
-  auto MatchIndex(const std::string &table_name, uint32_t index_key_idx)
-      -> std::optional<std::tuple<index_oid_t, std::string>>;
+  /**
+   * @brief scan only the range of an index that a filter over a seq scan can match, e.g. for `WHERE x BETWEEN 1
+   * AND 5` with an index on (x). The filter is kept above the index scan.
+   */
+  auto OptimizeFilterAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief narrow range down to the values of a column that an `AND`ed predicate can be true for, from its
+   * `<column> <op> <constant>` comparisons.
+   *
+   * @param expr the predicate
+   * @param column_id the column the range bounds
+   * @param column_type the type of the column, constants of other types are only used if they are narrower integers
+   * @param[in,out] range the range to narrow down
+   * @return false if no comparison bounds the column
+   */
+  auto CollectIndexRange(const AbstractExpression &expr, uint32_t column_id, TypeId column_type, IndexRange &range)
+      -> bool;
+
+  /** @brief find an index on the table whose key columns are exactly column_ids, in any order, or nullptr */
+  auto MatchIndex(const std::string &table_name, const std::vector<uint32_t> &column_ids) -> const IndexInfo *;
+
+  /**
+   * @brief split a join predicate made of `AND`ed `<outer column> = <inner column>` comparisons.
+   *
+   * @param expr the join predicate
+   * @param[out] outer_keys outer key expressions, rewritten to read tuple 0
+   * @param[out] inner_column_ids the inner column compared with each outer key
+   * @return false if the predicate has any other shape
+   */
+  auto CollectEquiJoinKeys(const AbstractExpression &expr, std::vector<AbstractExpressionRef> &outer_keys,
+                           std::vector<uint32_t> &inner_column_ids) -> bool;
 
   /**
    * @brief optimize sort + limit as top N
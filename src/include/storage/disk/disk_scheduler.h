@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler.h
+//
+// Identification: src/include/storage/disk/disk_scheduler.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <future>  // NOLINT
+#include <optional>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/channel.h"
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * @brief Represents a Write or Read request for the DiskManager to execute.
+ */
+struct DiskRequest {
+  /** Flag indicating whether the request is a write or a read. */
+  bool is_write_;
+
+  /**
+   *  Pointer to the start of the memory location where a page is either:
+   *   1. being read into from disk (on a read).
+   *   2. being written out to disk (on a write).
+   */
+  char *data_;
+
+  /** ID of the page being read from / written to disk. */
+  page_id_t page_id_;
+
+  /** Callback used to signal to the request issuer when the request has been completed. */
+  std::promise<bool> callback_;
+};
+
+using DiskSchedulerPromise = std::promise<bool>;
+
+/**
+ * @brief The DiskScheduler schedules disk read and write operations.
+ *
+ * A request is scheduled by calling DiskScheduler::Schedule() with an appropriate DiskRequest object. The scheduler
+ * keeps a pool of background worker threads that take requests off a shared queue and hand them to the disk
+ * manager, so as many page I/Os as there are workers can be outstanding at the same time. The issuer waits on the
+ * future of the request's callback to learn when it has completed.
+ *
+ * Requests are not ordered against each other: an issuer that needs a write to land before a read of the same
+ * buffer must wait for the write's completion before scheduling the read.
+ */
+class DiskScheduler {
+ public:
+  /**
+   * @brief Creates a DiskScheduler and starts its worker threads.
+   * @param disk_manager the disk manager the requests are executed against
+   * @param num_workers the number of requests that can be in flight at once
+   */
+  explicit DiskScheduler(DiskManager *disk_manager, size_t num_workers = DISK_SCHEDULER_WORKERS);
+
+  /**
+   * @brief Drains the outstanding requests and joins the worker threads.
+   */
+  ~DiskScheduler();
+
+  DISALLOW_COPY_AND_MOVE(DiskScheduler);
+
+  /**
+   * @brief Schedules a request for the DiskManager to execute.
+   *
+   * @param r The request to be scheduled.
+   */
+  void Schedule(DiskRequest r);
+
+  /**
+   * @brief Schedules a batch of requests at once. Every worker is woken up, so
+   * the requests are executed concurrently.
+   *
+   * @param requests The requests to be scheduled.
+   */
+  void Schedule(std::vector<DiskRequest> requests);
+
+  /**
+   * @brief Create a Promise object. If you want to implement your own version of promise, you can change this
+   * function so that our test cases can use your promise implementation.
+   *
+   * @return std::promise<bool>
+   */
+  auto CreatePromise() -> DiskSchedulerPromise { return {}; };
+
+  /** @return the number of worker threads, i.e. the maximum number of requests in flight */
+  auto GetNumWorkers() const -> size_t { return workers_.size(); }
+
+ private:
+  /**
+   * @brief Worker thread loop. Processes scheduled requests until it takes a
+   * std::nullopt off the queue, which happens when the scheduler is destroyed.
+   */
+  void StartWorkerThread();
+
+  /** Pointer to the disk manager. */
+  DiskManager *disk_manager_ __attribute__((__unused__));
+  /** A shared queue to concurrently schedule and process requests. When the DiskScheduler's destructor is called,
+   * `std::nullopt` is put into the queue once per worker to signal them to stop execution. */
+  Channel<std::optional<DiskRequest>> request_queue_;
+  /** The background threads responsible for issuing scheduled requests to the disk manager. */
+  std::vector<std::thread> workers_;
+};
+}  // namespace bustub
@@ -10,8 +10,10 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
-#include <list>
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <optional>
 #include <queue>
 #include <string>
 #include <utility>
@@ -31,22 +33,39 @@ namespace bustub {
  *
  * Implementation of simple b+ tree data structure where internal pages direct
  * the search and leaf pages contain actual data.
- * (1) We only support unique key
+ * (1) We only support unique key, non-unique indexes make their keys unique
+ *     with the RID (see BPlusTreeIndex)
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
+ *
+ * Every page links to the next page of its level and knows its high key, so
+ * that a search reaching a page after a split moved its key to the right can
+ * follow the link. In B-link mode (Lehman and Yao) inserts rely on it: they
+ * latch one level at a time and fill in the parent after the split, instead
+ * of latching every ancestor a split may reach. Removes in that mode leave
+ * underfull pages in place rather than merge them, so the tree never shrinks
+ * and parent page ids are not kept up to date.
+ *
+ * Trees with compressed pages (see CompressedPairArray) hold more keys per
+ * page, the more the keys of a page have in common. Leaves are separated by
+ * the shortest key that tells them apart (GenericComparator::Separator) to
+ * make internal pages compress as well. A page only runs out of space when a
+ * key is inserted, so compressed trees use B-link mode, where pages are never
+ * merged.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
   using InternalPage = BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>;
   using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
-  using LatchedPageContainer = std::list<Page *>;
+  using LatchedPageContainer = std::vector<Page *>;
   enum class SearchMode { Find, Insert, Delete };
   enum class UseMode { Read, Write };
 
  public:
   explicit BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
+                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE,
+                     bool b_link = false, IndexKeyFormat key_format = IndexKeyFormat::PLAIN);
 
   // Returns true if this B+ tree has no keys and values.
   auto IsEmpty() const -> bool;
@@ -57,17 +76,50 @@ class BPlusTree {
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *transaction = nullptr);
 
+  /**
+   * @brief Build the empty tree bottom-up from pairs in strictly increasing key order, instead of inserting them
+   * one by one. Pages are packed left to right and filled to fill_factor of their capacity, leaving room for later
+   * inserts.
+   *
+   * @param next Stores the next pair and returns true, or returns false after the last one.
+   * @param fill_factor Share of each page to fill, pages are never filled below half.
+   * @return false if the tree is not empty
+   */
+  auto BulkLoad(const std::function<bool(MappingType *)> &next, double fill_factor = 1.0,
+                Transaction *transaction = nullptr) -> bool;
+
   // return the value associated with a given key
   auto GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr) -> bool;
 
+  /**
+   * @brief Look up a batch of keys in one ordered pass over the leaves.
+   *
+   * The keys are visited in sorted order. Keys that land on the same leaf are answered from it together, and a key
+   * that lands on the next leaf moves there along the leaf chain, so each leaf is read once per batch.
+   *
+   * @param[out] results The values of every key, in the order of keys.
+   * @param in_range If set, every key starts a range of entries, the ones from it on for which in_range(entry key,
+   * key) holds, and all values of the range are returned instead of the value of the key only. A range may go on
+   * over the following leaves.
+   */
+  void GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results,
+                 Transaction *transaction = nullptr,
+                 const std::function<bool(const KeyType &, const KeyType &)> &in_range = nullptr);
+
   // return the page id of the root node
   auto GetRootPageId() -> page_id_t;
 
   // index iterator
   auto Begin() -> INDEXITERATOR_TYPE;
+  // iterator on the first entry whose key is not less than key
   auto Begin(const KeyType &key) -> INDEXITERATOR_TYPE;
   auto End() -> INDEXITERATOR_TYPE;
 
+  // reverse index iterator, on the last entry, moving towards smaller keys
+  auto RBegin() -> INDEXITERATOR_TYPE;
+  // reverse index iterator on the last entry whose key is not greater than key
+  auto RBegin(const KeyType &key) -> INDEXITERATOR_TYPE;
+
   // print the B+ tree
   void Print(BufferPoolManager *bpm);
 
@@ -81,6 +133,9 @@ class BPlusTree {
   void RemoveFromFile(const std::string &file_name, Transaction *transaction = nullptr);
 
  private:
+  /** Writes the pages of BulkLoad(), see b_plus_tree.cpp. */
+  class BulkLoader;
+
   auto UsePage(page_id_t page_id, UseMode mode, Transaction *transaction) -> Page *;
 
   void DisusePage(Page *page, UseMode mode);
@@ -98,7 +153,100 @@ class BPlusTree {
   auto PessimisticSearch(const KeyType &key, SearchMode mode, Transaction *transaction = nullptr,
                          LatchedPageContainer *latched_pages = nullptr) -> LeafPage *;
 
-  auto OptimisticSearch(const KeyType &key, SearchMode mode, Transaction *transaction, bool &success) -> LeafPage *;
+  /**
+   * @brief Find the leaf to which the key should go without taking any latch (optimistic lock coupling).
+   *
+   * Every page on the way is read between Page::ReadVersion() and Page::ValidateVersion(), and the search
+   * starts over from the root when a writer got in between.
+   *
+   * @param key The key to search for, nullptr for the leftmost leaf.
+   * @param[out] version The version of the leaf when it was reached, to validate what is read from it.
+   * @param[out] path If not nullptr, the page ids of the internal pages the search went down from, root first.
+   * @return The pinned and unlatched leaf, nullptr if the tree is empty.
+   */
+  auto OptimisticSearch(const KeyType *key, uint64_t *version, std::vector<page_id_t> *path = nullptr) -> LeafPage *;
+
+  /**
+   * @brief Find the leaf that holds the last entry before key, like OptimisticSearch().
+   *
+   * Internal pages are followed down to the child whose subtree holds the keys just below key. The leaf found may
+   * hold no entry before key, when key is its first entry or it is empty, the entries before key are then in the
+   * leaves before it.
+   *
+   * @param key The key to search for, nullptr for the rightmost leaf.
+   * @param inclusive Whether an entry equal to key is before it.
+   * @param[out] version The version of the leaf when it was reached, to validate what is read from it.
+   * @param[out] low The least key that may be in the leaf, unset for the leftmost leaf.
+   * @return The pinned and unlatched leaf, nullptr if the tree is empty.
+   */
+  auto OptimisticSearchBefore(const KeyType *key, bool inclusive, uint64_t *version, std::optional<KeyType> *low)
+      -> LeafPage *;
+
+  /**
+   * @brief Find the last entry before key, for reverse iteration.
+   *
+   * @param key The key to search for, nullptr for the last entry of the tree.
+   * @param inclusive Whether an entry equal to key is before it.
+   * @return The page id and index of the entry, INVALID_PAGE_ID if there is none.
+   */
+  auto PositionBefore(const KeyType *key, bool inclusive) -> std::pair<page_id_t, int>;
+
+  /**
+   * @brief Write latch the leaf to which the key should go, if inserting or removing the key there cannot change
+   * any page above it.
+   *
+   * @return The pinned and write latched leaf, nullptr if the tree is empty or the leaf is not safe.
+   */
+  auto OptimisticLatchLeaf(const KeyType &key, SearchMode mode, Transaction *transaction) -> LeafPage *;
+
+  /**
+   * @return The next page of the level if key is not less than the high key of the page, INVALID_PAGE_ID if key
+   * belongs to the page.
+   */
+  auto RightLinkFor(BPlusTreePage *tree_page, const KeyType &key) -> page_id_t;
+
+  /**
+   * @brief Follow the right links from the write latched page to the page of its level that key belongs to,
+   * latching each page before releasing the previous one.
+   *
+   * @return The write latched page key belongs to.
+   */
+  auto MoveRight(BPlusTreePage *tree_page, const KeyType &key) -> BPlusTreePage *;
+
+  /** @brief Make a tree of a single leaf holding the pair, with the root id latch held. */
+  void StartNewTree(const KeyType &key, const ValueType &value);
+
+  /**
+   * @brief Insert the pair into the leaf that has no room for it, and move the upper half of the pairs to a new next
+   * page.
+   *
+   * @return The new leaf, pinned. The high key of leaf separates them in the parent.
+   */
+  auto SplitLeaf(LeafPage *leaf, const KeyType &key, const ValueType &value) -> LeafPage *;
+
+  /**
+   * @brief Share pairs, the entries of the full internal page with the new one, between the page and a new next page.
+   *
+   * @return The new page, pinned. Its first key separates it from page in the parent.
+   */
+  auto SplitInternal(InternalPage *page, const std::vector<std::pair<KeyType, page_id_t>> &pairs) -> InternalPage *;
+
+  /** @brief Write latch the leaf key belongs to, in B-link mode. */
+  auto BLinkLatchLeaf(const KeyType &key, std::vector<page_id_t> *path) -> LeafPage *;
+
+  auto BLinkInsert(const KeyType &key, const ValueType &value) -> bool;
+
+  /**
+   * @brief Insert the separator of a split, in B-link mode, and split the parents that are full in turn.
+   *
+   * @param path The internal pages the search for key went down from, root first.
+   * @param level The level of the split page, 0 for leaves.
+   * @param left_id The split page.
+   * @param key The first key of the new page.
+   * @param right_id The new page.
+   */
+  void BLinkInsertInParent(std::vector<page_id_t> *path, int level, page_id_t left_id, KeyType key,
+                           page_id_t right_id);
 
   /**
    * @brief Insert the kv pair into the parent node of `node`.
@@ -149,11 +297,14 @@ class BPlusTree {
 
   // member variable
   std::string index_name_;
-  page_id_t root_page_id_;
+  /** Changed with root_page_id_page_ write latched, read optimistically against its version. */
+  std::atomic<page_id_t> root_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
   int leaf_max_size_;
   int internal_max_size_;
+  bool b_link_;
+  IndexKeyFormat key_format_;
   // Used for uniformly handle the unlatch case.
   std::unique_ptr<Page> root_page_id_page_;
 };
@@ -11,9 +11,11 @@
 
 #pragma once
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "container/hash/hash_function.h"
@@ -24,10 +26,23 @@ namespace bustub {
 
 #define BPLUSTREE_INDEX_TYPE BPlusTreeIndex<KeyType, ValueType, KeyComparator>
 
+/**
+ * An index over a B+ tree, which only holds unique keys.
+ *
+ * A non-unique index appends the RID to every key, as a hidden BIGINT key
+ * column, which keeps the keys of the tree unique. The entries of a key sit
+ * next to each other, in RID order, and are found with a scan from the key
+ * followed by a NULL RID, which sorts first.
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeIndex : public Index {
  public:
-  BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager);
+  /**
+   * @param key_format COMPRESSED stores more keys per page (see CompressedPairArray), in a B-link tree.
+   * @param b_link Whether to use a B-link tree for PLAIN keys as well.
+   */
+  BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager,
+                 IndexKeyFormat key_format = IndexKeyFormat::PLAIN, bool b_link = false);
 
   void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
 
@@ -35,6 +50,22 @@ class BPlusTreeIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                Transaction *transaction) override;
+
+  auto Scan(const IndexRange &range, Transaction *transaction) -> std::unique_ptr<IndexCursor> override;
+
+  /**
+   * @brief Fill the empty index with entries in any order, much faster than inserting them one by one. The entries
+   * are sorted by key, spilling to temporary files beyond INDEX_BUILD_SORT_MEMORY, and the tree is built bottom-up.
+   * Of entries with the same key, only the one with the smallest RID is kept in a unique index.
+   *
+   * @param next Stores the next key and RID and returns true, or returns false after the last entry.
+   * @param fill_factor Share of each tree page to fill.
+   */
+  void BulkLoad(const std::function<bool(Tuple *, RID *)> &next, Transaction *transaction,
+                double fill_factor = INDEX_BUILD_FILL_FACTOR);
+
   auto GetBeginIterator() -> INDEXITERATOR_TYPE;
 
   auto GetBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE;
@@ -42,14 +73,71 @@ class BPlusTreeIndex : public Index {
   auto GetEndIterator() -> INDEXITERATOR_TYPE;
 
  protected:
+  /** @return The least key whose first column is value, the other columns being NULL */
+  auto BoundKey(const Value &value) const -> KeyType;
+
+  /**
+   * @return The key of the tree for the entry of key and rid. rid is ignored by a unique index, nullptr for the least
+   * key of the tree with key, at which its entries start.
+   */
+  auto TreeKey(const Tuple &key, const RID *rid) const -> KeyType;
+
+  // the keys of the tree, the key schema followed by the RID in a non-unique index
+  Schema tree_key_schema_;
   // comparator for key
   KeyComparator comparator_;
+  // comparator for the key columns, without the RID
+  KeyComparator key_comparator_;
   // container
   BPlusTree<KeyType, ValueType, KeyComparator> container_;
+  // the first column of the key, which range scans are bounded on
+  Schema first_column_schema_;
+  // comparator for the first column of keys
+  KeyComparator first_column_comparator_;
+};
+
+/** IndexCursor over an IndexIterator of a BPlusTreeIndex. */
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTreeIndexCursor : public IndexCursor {
+ public:
+  /**
+   * @param in_range Whether a key is still within the scan, the cursor ends at the first one that is not. nullptr to
+   * scan until the iterator ends.
+   */
+  explicit BPlusTreeIndexCursor(INDEXITERATOR_TYPE &&iterator,
+                                std::function<bool(const KeyType &)> in_range = nullptr)
+      : iterator_(std::move(iterator)), in_range_(std::move(in_range)) {
+    Load();
+  }
+
+  auto IsEnd() -> bool override { return at_end_; }
+
+  auto GetRID() -> RID override { return rid_; }
+
+  void Next() override {
+    ++iterator_;
+    Load();
+  }
+
+ private:
+  /** Read the entry the iterator is on. */
+  void Load() {
+    at_end_ = iterator_.IsEnd();
+    if (at_end_) {
+      return;
+    }
+    const auto &pair = *iterator_;
+    at_end_ = in_range_ && !in_range_(pair.first);
+    rid_ = pair.second;
+  }
+
+  INDEXITERATOR_TYPE iterator_;
+  std::function<bool(const KeyType &)> in_range_;
+  bool at_end_;
+  RID rid_;
 };
 
-/** We only support index table with one integer key for now in BusTub. Hardcode
- * everything here. */
+/** Indexes created from SQL with a single integer column use the smallest key. */
 
 constexpr static const auto INTEGER_SIZE = 4;
 using IntegerKeyType = GenericKey<INTEGER_SIZE>;
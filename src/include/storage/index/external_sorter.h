@@ -0,0 +1,149 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// external_sorter.h
+//
+// Identification: src/include/storage/index/external_sorter.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * ExternalSorter sorts more items than fit in memory, for building indexes
+ * bottom-up. Items are collected with Add() until memory_limit bytes are
+ * buffered; the buffer is then sorted and spilled as a run to a temporary
+ * file. After Sort(), Next() returns the items in order, merging the runs and
+ * what is still in memory. Without spilled runs it is a plain std::sort.
+ *
+ * Items are spilled byte by byte, so T must be trivially copyable in effect.
+ */
+template <typename T, typename Compare>
+class ExternalSorter {
+ public:
+  /**
+   * @param compare strict weak ordering of the items
+   * @param memory_limit bytes of items to buffer before spilling a run
+   */
+  ExternalSorter(Compare compare, size_t memory_limit)
+      : compare_(std::move(compare)), max_buffered_(std::max<size_t>(memory_limit / sizeof(T), 1)) {}
+
+  ~ExternalSorter() {
+    for (auto *run : runs_) {
+      std::fclose(run);
+    }
+  }
+
+  DISALLOW_COPY_AND_MOVE(ExternalSorter);
+
+  /** Add an item. Must not be called after Sort(). */
+  void Add(const T &item) {
+    BUSTUB_ASSERT(!sorted_, "add after sort");
+    buffer_.push_back(item);
+    if (buffer_.size() == max_buffered_) {
+      SpillRun();
+    }
+  }
+
+  /** Sort the items added so far, to be read with Next(). */
+  void Sort() {
+    sorted_ = true;
+    std::sort(buffer_.begin(), buffer_.end(), compare_);
+    if (runs_.empty()) {
+      return;
+    }
+    // Seed the merge with the head of every run, the in-memory buffer being the last one.
+    for (size_t source = 0; source <= runs_.size(); source++) {
+      T item;
+      if (ReadFrom(source, &item)) {
+        heap_.emplace_back(std::move(item), source);
+      }
+    }
+    std::make_heap(heap_.begin(), heap_.end(), HeapCompare{&compare_});
+  }
+
+  /**
+   * @param[out] item the next item in order
+   * @return false if all items have been returned
+   */
+  auto Next(T *item) -> bool {
+    BUSTUB_ASSERT(sorted_, "next before sort");
+    if (runs_.empty()) {
+      return ReadFrom(0, item);
+    }
+    if (heap_.empty()) {
+      return false;
+    }
+    std::pop_heap(heap_.begin(), heap_.end(), HeapCompare{&compare_});
+    auto &[head, source] = heap_.back();
+    *item = std::move(head);
+    if (ReadFrom(source, &head)) {
+      std::push_heap(heap_.begin(), heap_.end(), HeapCompare{&compare_});
+    } else {
+      heap_.pop_back();
+    }
+    return true;
+  }
+
+  /** @return the number of runs spilled to disk */
+  auto GetNumRuns() const -> size_t { return runs_.size(); }
+
+ private:
+  /** Orders the merge heap so that its front is the smallest head. */
+  struct HeapCompare {
+    auto operator()(const std::pair<T, size_t> &a, const std::pair<T, size_t> &b) const -> bool {
+      return (*compare_)(b.first, a.first);
+    }
+    const Compare *compare_;
+  };
+
+  void SpillRun() {
+    std::sort(buffer_.begin(), buffer_.end(), compare_);
+    auto *run = std::tmpfile();
+    if (run == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot create a temporary file for sorting");
+    }
+    runs_.push_back(run);
+    if (std::fwrite(buffer_.data(), sizeof(T), buffer_.size(), run) != buffer_.size()) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot spill a sorted run to disk");
+    }
+    std::rewind(run);
+    buffer_.clear();
+  }
+
+  /** Read the next item of a run, or of the in-memory buffer if source is the number of runs. */
+  auto ReadFrom(size_t source, T *item) -> bool {
+    if (source == runs_.size()) {
+      if (buffer_pos_ == buffer_.size()) {
+        return false;
+      }
+      *item = buffer_[buffer_pos_++];
+      return true;
+    }
+    return std::fread(item, sizeof(T), 1, runs_[source]) == 1;
+  }
+
+  Compare compare_;
+  size_t max_buffered_;
+  bool sorted_{false};
+  std::vector<T> buffer_;
+  size_t buffer_pos_{0};
+  std::vector<std::FILE *> runs_;
+  /** Head of every source that is not exhausted yet, with the source it came from. */
+  std::vector<std::pair<T, size_t>> heap_;
+};
+
+}  // namespace bustub
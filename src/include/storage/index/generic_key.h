@@ -12,9 +12,14 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstring>
+#include <vector>
 
+#include "common/exception.h"
 #include "storage/table/tuple.h"
+#include "type/limits.h"
+#include "type/type_util.h"
 #include "type/value.h"
 
 namespace bustub {
@@ -30,6 +35,9 @@ template <size_t KeySize>
 class GenericKey {
  public:
   inline void SetFromKey(const Tuple &tuple) {
+    if (tuple.GetLength() > KeySize) {
+      throw Exception(ExceptionType::OUT_OF_RANGE, "index key does not fit into the key size of the index");
+    }
     // intialize to 0
     memset(data_, 0, KeySize);
     memcpy(data_, tuple.GetData(), tuple.GetLength());
@@ -72,35 +80,179 @@ class GenericKey {
 
 /**
  * Function object returns true if lhs < rhs, used for trees
+ *
+ * The key schema is resolved once, at construction, into the type and offset
+ * of every column. Comparisons then read the serialized fields straight out
+ * of the keys: fixed-width types compare as the C++ types they are stored as,
+ * VARCHARs like TypeUtil::CompareStrings. No Value is ever built. NULLs
+ * compare by their sentinel encodings (the minimum of the integer types, a
+ * length prefix that sorts before any string), which keeps the order total.
  */
 template <size_t KeySize>
 class GenericComparator {
  public:
   inline auto operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const -> int {
-    uint32_t column_count = key_schema_->GetColumnCount();
-
-    for (uint32_t i = 0; i < column_count; i++) {
-      Value lhs_value = (lhs.ToValue(key_schema_, i));
-      Value rhs_value = (rhs.ToValue(key_schema_, i));
-
-      if (lhs_value.CompareLessThan(rhs_value) == CmpBool::CmpTrue) {
-        return -1;
+    // Single-column integer keys, the common case, skip the column loop.
+    if (integer_key_type_ == TypeId::INTEGER) {
+      return CompareFixed<int32_t>(lhs.data_, rhs.data_, 0);
+    }
+    if constexpr (KeySize >= sizeof(int64_t)) {
+      if (integer_key_type_ == TypeId::BIGINT) {
+        return CompareFixed<int64_t>(lhs.data_, rhs.data_, 0);
       }
-      if (lhs_value.CompareGreaterThan(rhs_value) == CmpBool::CmpTrue) {
-        return 1;
+    }
+    for (const auto &column : columns_) {
+      auto cmp = CompareColumn(lhs.data_, rhs.data_, column);
+      if (cmp != 0) {
+        return cmp;
       }
     }
     // equals
     return 0;
   }
 
-  GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_} {}
+  /**
+   * @return INTEGER or BIGINT if the key is a single column of that type, stored
+   * in the first bytes of the key, INVALID otherwise. Such keys order like the
+   * integers they hold, which lets B+ tree pages search them without
+   * deserializing Values.
+   */
+  inline auto GetIntegerKeyType() const -> TypeId { return integer_key_type_; }
+
+  /**
+   * @return A key that sorts after lhs and not after rhs, for lhs < rhs, to separate them in a B+ tree. It is rhs
+   * with the first column the keys differ in cut to the shortest prefix that still sorts after lhs, if that is a
+   * VARCHAR. The bytes cut off are zeroed, so separators have more in common with each other than full keys.
+   */
+  inline auto Separator(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const -> GenericKey<KeySize> {
+    auto separator = rhs;
+    if (integer_key_type_ != TypeId::INVALID) {
+      return separator;
+    }
+    for (const auto &column : columns_) {
+      if (CompareColumn(lhs.data_, rhs.data_, column) == 0) {
+        continue;
+      }
+      if (column.type_ != TypeId::VARCHAR) {
+        break;
+      }
+      uint32_t lhs_len;
+      uint32_t rhs_len;
+      const auto *lhs_data = VarcharAt(lhs.data_, column.offset_, &lhs_len);
+      auto *rhs_data = const_cast<char *>(VarcharAt(separator.data_, column.offset_, &rhs_len));
+      if (lhs_len == BUSTUB_VALUE_NULL || rhs_len == BUSTUB_VALUE_NULL) {
+        break;
+      }
+      // Keep the characters up to the first one that differs from lhs. If lhs is a prefix of rhs, that is the one
+      // after the end of lhs.
+      const auto *mismatch = std::mismatch(lhs_data, lhs_data + std::min(lhs_len, rhs_len) - 1, rhs_data).second;
+      const auto common = mismatch - rhs_data;
+      const auto len = static_cast<uint32_t>(common) + 1;
+      if (len < rhs_len - 1) {
+        // The length counts the terminating '\0'.
+        memset(rhs_data + len, 0, rhs_len - len);
+        const auto new_len = len + 1;
+        memcpy(rhs_data - sizeof(uint32_t), &new_len, sizeof(uint32_t));
+      }
+      break;
+    }
+    return separator;
+  }
+
+  GenericComparator(const GenericComparator &other)
+      : key_schema_{other.key_schema_}, columns_{other.columns_}, integer_key_type_{other.integer_key_type_} {}
 
   // constructor
-  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
+  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {
+    if (key_schema_ == nullptr) {
+      return;
+    }
+    for (const auto &col : key_schema_->GetColumns()) {
+      columns_.push_back({col.GetType(), col.GetOffset()});
+    }
+    if (columns_.size() != 1) {
+      return;
+    }
+    const auto &col = key_schema_->GetColumn(0);
+    const auto type = col.GetType();
+    if ((type == TypeId::INTEGER || type == TypeId::BIGINT) && col.GetOffset() == 0 &&
+        col.GetFixedLength() <= KeySize) {
+      integer_key_type_ = type;
+    }
+  }
 
  private:
+  /** Where a key column is serialized, see Tuple. */
+  struct KeyColumn {
+    TypeId type_;
+    uint32_t offset_;
+  };
+
+  template <typename T>
+  static inline auto CompareFixed(const char *lhs, const char *rhs, uint32_t offset) -> int {
+    T lhs_field;
+    T rhs_field;
+    memcpy(&lhs_field, lhs + offset, sizeof(T));
+    memcpy(&rhs_field, rhs + offset, sizeof(T));
+    return (lhs_field > rhs_field) - (lhs_field < rhs_field);
+  }
+
+  /**
+   * A VARCHAR column holds the offset of its data, a length prefix followed by the characters.
+   * @return the characters of the varchar whose offset is stored at offset, with their length in len
+   */
+  static inline auto VarcharAt(const char *key, uint32_t offset, uint32_t *len) -> const char * {
+    int32_t data_offset;
+    memcpy(&data_offset, key + offset, sizeof(int32_t));
+    // B+ tree readers that take no latch may see a key torn by a writer. Keep their reads inside the key, the
+    // result is thrown away when the read fails validation.
+    data_offset = std::clamp<int32_t>(data_offset, 0, KeySize - sizeof(uint32_t));
+    memcpy(len, key + data_offset, sizeof(uint32_t));
+    if (*len != BUSTUB_VALUE_NULL) {
+      *len = std::clamp<uint32_t>(*len, 1, KeySize - data_offset - sizeof(uint32_t) + 1);
+    }
+    return key + data_offset + sizeof(uint32_t);
+  }
+
+  static inline auto CompareVarchar(const char *lhs, const char *rhs, uint32_t offset) -> int {
+    uint32_t lhs_len;
+    uint32_t rhs_len;
+    const auto *lhs_data = VarcharAt(lhs, offset, &lhs_len);
+    const auto *rhs_data = VarcharAt(rhs, offset, &rhs_len);
+    if (lhs_len == BUSTUB_VALUE_NULL || rhs_len == BUSTUB_VALUE_NULL) {
+      return (lhs_len != BUSTUB_VALUE_NULL) - (rhs_len != BUSTUB_VALUE_NULL);
+    }
+    // The length counts the terminating '\0'.
+    auto cmp =
+        TypeUtil::CompareStrings(lhs_data, static_cast<int>(lhs_len) - 1, rhs_data, static_cast<int>(rhs_len) - 1);
+    return (cmp > 0) - (cmp < 0);
+  }
+
+  static inline auto CompareColumn(const char *lhs, const char *rhs, const KeyColumn &column) -> int {
+    switch (column.type_) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        return CompareFixed<int8_t>(lhs, rhs, column.offset_);
+      case TypeId::SMALLINT:
+        return CompareFixed<int16_t>(lhs, rhs, column.offset_);
+      case TypeId::INTEGER:
+        return CompareFixed<int32_t>(lhs, rhs, column.offset_);
+      case TypeId::BIGINT:
+        return CompareFixed<int64_t>(lhs, rhs, column.offset_);
+      case TypeId::DECIMAL:
+        return CompareFixed<double>(lhs, rhs, column.offset_);
+      case TypeId::TIMESTAMP:
+        return CompareFixed<uint64_t>(lhs, rhs, column.offset_);
+      case TypeId::VARCHAR:
+        return CompareVarchar(lhs, rhs, column.offset_);
+      default:
+        throw Exception(ExceptionType::MISMATCH_TYPE, "index key column type cannot be compared");
+    }
+  }
+
   Schema *key_schema_;
+  std::vector<KeyColumn> columns_;
+  TypeId integer_key_type_{TypeId::INVALID};
 };
 
 }  // namespace bustub
@@ -13,11 +13,14 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "catalog/schema.h"
+#include "common/exception.h"
+#include "fmt/format.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
@@ -43,10 +46,14 @@ class IndexMetadata {
    * @param table_name The name of the table on which the index is created
    * @param tuple_schema The schema of the indexed key
    * @param key_attrs The mapping from indexed columns to base table columns
+   * @param unique Whether the index holds at most one entry per key, or one per key and RID
    */
   IndexMetadata(std::string index_name, std::string table_name, const Schema *tuple_schema,
-                std::vector<uint32_t> key_attrs)
-      : name_(std::move(index_name)), table_name_(std::move(table_name)), key_attrs_(std::move(key_attrs)) {
+                std::vector<uint32_t> key_attrs, bool unique = true)
+      : name_(std::move(index_name)),
+        table_name_(std::move(table_name)),
+        key_attrs_(std::move(key_attrs)),
+        unique_(unique) {
     key_schema_ = std::make_shared<Schema>(Schema::CopySchema(tuple_schema, key_attrs_));
   }
 
@@ -73,6 +80,9 @@ class IndexMetadata {
    * columns */
   inline auto GetKeyAttrs() const -> const std::vector<uint32_t> & { return key_attrs_; }
 
+  /** @return True if the index holds at most one entry per key, an entry with the key of another is not inserted */
+  inline auto IsUnique() const -> bool { return unique_; }
+
   /** @return A string representation for debugging */
   auto ToString() const -> std::string {
     std::stringstream os;
@@ -80,6 +90,7 @@ class IndexMetadata {
     os << "IndexMetadata["
        << "Name = " << name_ << ", "
        << "Type = B+Tree, "
+       << "Unique = " << (unique_ ? "true" : "false") << ", "
        << "Table name = " << table_name_ << "] :: ";
     os << key_schema_->ToString();
 
@@ -93,10 +104,55 @@ class IndexMetadata {
   std::string table_name_;
   /** The mapping relation between key schema and tuple schema */
   const std::vector<uint32_t> key_attrs_;
+  /** Whether keys are unique in the index */
+  const bool unique_;
   /** The schema of the indexed key */
   std::shared_ptr<Schema> key_schema_;
 };
 
+/**
+ * The part of an ordered index to scan, bounded on the first key column.
+ *
+ * Bounds are compared with the first column of the keys only, so a bound on a
+ * composite index takes in every key whose first column is within it. A
+ * missing bound leaves that side of the scan open.
+ */
+struct IndexRange {
+  /** The least value of the first key column to scan */
+  std::optional<Value> lower_;
+  /** Whether keys equal to the lower bound are scanned */
+  bool lower_inclusive_{true};
+  /** The greatest value of the first key column to scan */
+  std::optional<Value> upper_;
+  /** Whether keys equal to the upper bound are scanned */
+  bool upper_inclusive_{true};
+  /** Whether to scan in descending key order */
+  bool reverse_{false};
+
+  /** @return True if the range takes in the whole index, in ascending order */
+  auto IsFull() const -> bool { return !lower_.has_value() && !upper_.has_value() && !reverse_; }
+};
+
+/**
+ * class IndexCursor - Iterates the entries of an index in key order
+ *
+ * Executors get a cursor from Index::Scan() and do not need to know the key
+ * type the index was instantiated with.
+ */
+class IndexCursor {
+ public:
+  virtual ~IndexCursor() = default;
+
+  /** @return True once the cursor has moved past the last entry of the scan */
+  virtual auto IsEnd() -> bool = 0;
+
+  /** @return The RID of the current entry */
+  virtual auto GetRID() -> RID = 0;
+
+  /** Move to the next entry. */
+  virtual void Next() = 0;
+};
+
 /////////////////////////////////////////////////////////////////////
 // Index class definition
 /////////////////////////////////////////////////////////////////////
@@ -141,6 +197,9 @@ class Index {
   /** @return The index key attributes */
   auto GetKeyAttrs() const -> const std::vector<uint32_t> & { return metadata_->GetKeyAttrs(); }
 
+  /** @return True if the index holds at most one entry per key */
+  auto IsUnique() const -> bool { return metadata_->IsUnique(); }
+
   /** @return A string representation for debugging */
   auto ToString() const -> std::string {
     std::stringstream os;
@@ -173,11 +232,39 @@ class Index {
    * Search the index for the provided key.
    * @param key The index key
    * @param result The collection of RIDs that is populated with results of the
-   * search
+   * search, every entry with the key in a non-unique index
    * @param transaction The transaction context
    */
   virtual void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) = 0;
 
+  /**
+   * Search the index for a batch of keys.
+   * @param keys The index keys
+   * @param results The collections of RIDs of every key, in the order of keys
+   * @param transaction The transaction context
+   */
+  virtual void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                        Transaction *transaction) {
+    results->assign(keys.size(), {});
+    for (size_t i = 0; i < keys.size(); i++) {
+      ScanKey(keys[i], &(*results)[i], transaction);
+    }
+  }
+
+  ///////////////////////////////////////////////////////////////////
+  // Range Index Scan
+  ///////////////////////////////////////////////////////////////////
+
+  /**
+   * Scan the entries of an ordered index within a range, in key order.
+   * @param range The bounds and direction of the scan, IndexRange{} for all entries in ascending order
+   * @param transaction The transaction context
+   * @return A cursor positioned on the first entry of the scan
+   */
+  virtual auto Scan(const IndexRange &range, Transaction *transaction) -> std::unique_ptr<IndexCursor> {
+    throw NotImplementedException(fmt::format("index {} does not support ordered scans", GetName()));
+  }
+
  private:
   /** The Index structure owns its metadata */
   std::unique_ptr<IndexMetadata> metadata_;
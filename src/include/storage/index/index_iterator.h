@@ -13,7 +13,11 @@
  * For range scan of b+ tree
  */
 #pragma once
+#include <functional>
+#include <utility>
+
 #include "buffer/buffer_pool_manager.h"
+#include "buffer/page_read_ahead.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 
 namespace bustub {
@@ -25,8 +29,14 @@ class IndexIterator {
   using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
 
  public:
+  /** Finds the page id and index of the last entry before a key, INVALID_PAGE_ID if there is none. */
+  using PositionBefore = std::function<std::pair<page_id_t, int>(const KeyType &)>;
+
   // you may define your own constructor based on your member variables
   IndexIterator(page_id_t begin_page, int begin_index, BufferPoolManager *buffer_pool_manager);
+  /** A reverse iterator, that moves from an entry to the one before it, found with position_before. */
+  IndexIterator(page_id_t begin_page, int begin_index, BufferPoolManager *buffer_pool_manager,
+                PositionBefore position_before);
   ~IndexIterator();  // NOLINT
 
   auto IsEnd() -> bool;
@@ -40,10 +50,17 @@ class IndexIterator {
   auto operator!=(const IndexIterator &itr) const -> bool;
 
  private:
+  /** Move on to the next leaf, and past empty ones, while index_ is past the end of the current leaf. */
+  void SkipExhaustedLeaves();
+
   page_id_t page_id_;
   int index_;
   BufferPoolManager *buffer_pool_manager_;
   MappingType pair_;
+  /** Set for a reverse iterator, leaves have no pointer to the one before them. */
+  PositionBefore position_before_;
+  /** Keeps the leaves after the current one prefetched, following their sibling pointers. */
+  PageReadAhead read_ahead_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,213 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_compressed_pairs.h
+//
+// Identification: src/include/storage/page/b_plus_tree_compressed_pairs.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+/**
+ * The compressed layout of the (key, value) pairs of a B+ tree page, laid
+ * over the array that holds them in a plain page.
+ *
+ * The keys of a page agree on most of their bytes: a common prefix of their
+ * data, the zero padding after it, the high bytes of little-endian integers.
+ * Those are stored once, in a base key, and every pair only keeps the bytes
+ * at the positions where some key of the page differs from the base, next to
+ * its value:
+ *
+ *  -------------------------------------------------------------------------
+ * | BaseKey (key) | Width (1) | Positions (key) | BYTES(1)+VALUE(1) | ...
+ *  -------------------------------------------------------------------------
+ *
+ * Width is the number of positions kept. Pairs take width plus the value size
+ * bytes, so how many fit depends on the keys, see Capacity(). A key that
+ * differs from the base at a new position widens every pair of the page.
+ *
+ * Readers that take no latch may see the array torn by a writer. Reads are
+ * kept inside the array, the result is thrown away when the read fails
+ * validation.
+ */
+template <typename KeyType, typename ValueType, size_t ArraySize>
+class CompressedPairArray {
+  static constexpr size_t KEY_SIZE = sizeof(KeyType);
+  static constexpr size_t SLOTS_SIZE = ArraySize - 2 * KEY_SIZE - 1;
+  static_assert(KEY_SIZE <= UINT8_MAX, "key positions are stored in a byte");
+
+ public:
+  /** @return how many pairs fit when width bytes of every key are kept */
+  static constexpr auto Capacity(size_t width) -> int {
+    return static_cast<int>(SLOTS_SIZE / (width + sizeof(ValueType)));
+  }
+
+  /** Store the n pairs, replacing what the array held. */
+  void Encode(const MappingType *pairs, int n) {
+    width_ = 0;
+    if (n == 0) {
+      return;
+    }
+    base_ = pairs[0].first;
+    bool differs[KEY_SIZE] = {};
+    for (int i = 1; i < n; i++) {
+      MarkDifferences(pairs[i].first, differs);
+    }
+    for (size_t pos = 0; pos < KEY_SIZE; pos++) {
+      if (differs[pos]) {
+        positions_[width_++] = pos;
+      }
+    }
+    for (int i = 0; i < n; i++) {
+      Write(i, pairs[i]);
+    }
+  }
+
+  /** @return the n pairs of the array */
+  auto Decode(int n) const -> std::vector<MappingType> {
+    std::vector<MappingType> pairs;
+    pairs.reserve(n);
+    for (int i = 0; i < n; i++) {
+      pairs.emplace_back(KeyAt(i), ValueAt(i));
+    }
+    return pairs;
+  }
+
+  auto KeyAt(int index) const -> KeyType {
+    KeyType key = base_;
+    auto *bytes = reinterpret_cast<char *>(&key);
+    const auto *slot = SlotAt(index);
+    const auto width = Width();
+    for (size_t i = 0; i < width; i++) {
+      bytes[std::min<size_t>(positions_[i], KEY_SIZE - 1)] = slot[i];
+    }
+    return key;
+  }
+
+  auto ValueAt(int index) const -> ValueType {
+    ValueType value;
+    memcpy(&value, SlotAt(index) + Width(), sizeof(ValueType));
+    return value;
+  }
+
+  /** @return whether n + 1 pairs fit once key is stored along the n pairs of the array */
+  auto Fits(int n, const KeyType &key) const -> bool {
+    return n + 1 <= Capacity(n == 0 ? 0 : Width() + NewPositions(key));
+  }
+
+  /** @return how many of the n pairs, counted from the first, fit in an array */
+  static auto FitCount(const MappingType *pairs, int n) -> int {
+    bool differs[KEY_SIZE] = {};
+    size_t width = 0;
+    for (int i = 1; i < n; i++) {
+      for (size_t pos = 0; pos < KEY_SIZE; pos++) {
+        if (!differs[pos] && ByteAt(pairs[i].first, pos) != ByteAt(pairs[0].first, pos)) {
+          differs[pos] = true;
+          width++;
+        }
+      }
+      if (i + 1 > Capacity(width)) {
+        return i;
+      }
+    }
+    return n;
+  }
+
+  /** Insert the pair at index, n being the number of pairs before. Check Fits() before invocation. */
+  void Insert(int index, int n, const MappingType &pair) {
+    if (n == 0 || NewPositions(pair.first) != 0) {
+      auto pairs = Decode(n);
+      pairs.insert(pairs.begin() + index, pair);
+      Encode(pairs.data(), n + 1);
+      return;
+    }
+    memmove(SlotAt(index + 1), SlotAt(index), (n - index) * Stride());
+    Write(index, pair);
+  }
+
+  /** Remove the pair at index, n being the number of pairs before. */
+  void Remove(int index, int n) { memmove(SlotAt(index), SlotAt(index + 1), (n - index - 1) * Stride()); }
+
+  /**
+   * @brief Binary search the pairs in [begin, end) for a key, like KeySearch().
+   *
+   * @return The index of the first key that is not less than key, or greater than key if upper is set.
+   */
+  template <typename KeyComparator>
+  auto Search(int begin, int end, const KeyType &key, const KeyComparator &comparator, bool upper = false) const
+      -> int {
+    auto lo = begin;
+    auto hi = end;
+    while (lo < hi) {
+      auto mid = lo + (hi - lo) / 2;
+      auto cmp = comparator(KeyAt(mid), key);
+      if (cmp < 0 || (upper && cmp == 0)) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+ private:
+  static auto ByteAt(const KeyType &key, size_t pos) -> char { return reinterpret_cast<const char *>(&key)[pos]; }
+
+  void MarkDifferences(const KeyType &key, bool *differs) const {
+    for (size_t pos = 0; pos < KEY_SIZE; pos++) {
+      differs[pos] = differs[pos] || ByteAt(key, pos) != ByteAt(base_, pos);
+    }
+  }
+
+  /** @return the number of positions key differs from the base at that are not kept yet */
+  auto NewPositions(const KeyType &key) const -> size_t {
+    bool differs[KEY_SIZE] = {};
+    MarkDifferences(key, differs);
+    const auto width = Width();
+    for (size_t i = 0; i < width; i++) {
+      differs[positions_[i]] = false;
+    }
+    return std::count(differs, differs + KEY_SIZE, true);
+  }
+
+  auto Width() const -> size_t { return std::min<size_t>(width_, KEY_SIZE); }
+
+  auto Stride() const -> size_t { return Width() + sizeof(ValueType); }
+
+  auto SlotAt(int index) const -> const char * {
+    return slots_ + std::min<size_t>(std::max(index, 0) * Stride(), SLOTS_SIZE - Stride());
+  }
+
+  auto SlotAt(int index) -> char * {
+    return slots_ + std::min<size_t>(std::max(index, 0) * Stride(), SLOTS_SIZE - Stride());
+  }
+
+  void Write(int index, const MappingType &pair) {
+    auto *slot = SlotAt(index);
+    for (size_t i = 0; i < width_; i++) {
+      slot[i] = ByteAt(pair.first, positions_[i]);
+    }
+    memcpy(slot + width_, &pair.second, sizeof(ValueType));
+  }
+
+  KeyType base_;
+  uint8_t width_;
+  uint8_t positions_[KEY_SIZE];
+  char slots_[SLOTS_SIZE];
+};
+
+}  // namespace bustub
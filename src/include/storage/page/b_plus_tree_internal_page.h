@@ -14,12 +14,13 @@
 #include <string>
 #include <vector>
 
+#include "storage/page/b_plus_tree_compressed_pairs.h"
 #include "storage/page/b_plus_tree_page.h"
 
 namespace bustub {
 
 #define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
-#define INTERNAL_PAGE_HEADER_SIZE 24
+#define INTERNAL_PAGE_HEADER_SIZE (32 + sizeof(KeyType))
 #define INTERNAL_PAGE_SIZE ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)))
 /**
  * Store n indexed keys and n+1 child pointers (page_id) within internal page.
@@ -29,20 +30,57 @@ namespace bustub {
  * the first key always remains invalid. That is to say, any search/lookup
  * should ignore the first key.
  *
+ * Like leaves, internal pages link to the next page of their level, and their
+ * high key bounds the keys of their subtree from above when there is one.
+ *
+ * Compressed pages lay a CompressedPairArray over the pairs, like leaves.
+ *
  * Internal page format (keys are stored in increasing order):
  *  --------------------------------------------------------------------------
  * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
  *  --------------------------------------------------------------------------
+ *
+ *  Header format (size in byte, 32 bytes plus the key size in total):
+ *  ---------------------------------------------------------------------
+ * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
+ *  ---------------------------------------------------------------------
+ *  -------------------------------------------------------------------------------
+ * | ParentPageId (4) | PageId (4) | KeyFormat (4) | NextPageId (4) | HighKey (key)
+ *  -------------------------------------------------------------------------------
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeInternalPage : public BPlusTreePage {
  public:
+  using CompressedPairs = CompressedPairArray<KeyType, ValueType, INTERNAL_PAGE_SIZE * sizeof(MappingType)>;
+  // The max size of compressed pages. The halves of a full page and one more entry fit in a page even if their keys
+  // do not compress.
+  static constexpr int COMPRESSED_MAX_SIZE = 2 * CompressedPairs::Capacity(sizeof(KeyType)) - 1;
+
   // must call initialize method after "create" a new node
-  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = INTERNAL_PAGE_SIZE);
+  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = INTERNAL_PAGE_SIZE,
+            IndexKeyFormat key_format = IndexKeyFormat::PLAIN);
+
+  auto GetNextPageId() const -> page_id_t;
+  void SetNextPageId(page_id_t next_page_id);
+  auto GetHighKey() const -> const KeyType &;
+  void SetHighKey(const KeyType &high_key);
 
   auto KeyAt(int index) const -> KeyType;
   void SetKeyAt(int index, const KeyType &key);
   auto ValueAt(int index) const -> ValueType;
+  /**
+   * @brief Binary search the page for the child whose subtree holds key.
+   *
+   * @return The page id of the child.
+   */
+  auto Lookup(const KeyType &key, const KeyComparator &comparator) const -> ValueType;
+  /**
+   * @brief Binary search the page for the child whose subtree holds key, or the keys just below it.
+   *
+   * @param inclusive If false, the child whose subtree holds the greatest keys less than key.
+   * @return The index of the child.
+   */
+  auto ChildIndex(const KeyType &key, const KeyComparator &comparator, bool inclusive = true) const -> int;
   /**
    * @brief Get the adjacent(the next by default) node of the value.
    *
@@ -79,6 +117,19 @@ class BPlusTreeInternalPage : public BPlusTreePage {
    */
   void InsertAfter(const ValueType &value, const KeyType &new_key, const ValueType &new_value);
 
+  /**
+   * @return Whether the key can be inserted without the page exceeding its max size, or running out of space if it is
+   * compressed.
+   */
+  auto CanInsert(const KeyType &key) const -> bool;
+
+  /**
+   * @brief Insert the pair(key,value) in key order, after the keys that are not greater than key.
+   *
+   * @note Check the size with the max size before invocation.
+   */
+  void Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
+
   void PushBack(const KeyType &key, const ValueType &value);
 
   void PushFront(const ValueType &value);
@@ -106,12 +157,24 @@ class BPlusTreeInternalPage : public BPlusTreePage {
 
   auto PopFront() -> MappingType;
 
+  // The pairs of a plain page.
   inline auto Get() -> MappingType * { return array_; }
 
  private:
+  inline auto Compressed() const -> const CompressedPairs * {
+    return reinterpret_cast<const CompressedPairs *>(array_);
+  }
+  inline auto Compressed() -> CompressedPairs * { return reinterpret_cast<CompressedPairs *>(array_); }
+
+  /** Apply change to the pairs of a compressed page, decoded, and encode them again. */
+  template <typename Change>
+  void Recode(Change change);
+
   auto KeyToString(const KeyType &key) const -> std::string;
 
+  page_id_t next_page_id_;
+  KeyType high_key_;
   // Flexible array member for page data.
-  MappingType array_[(INTERNAL_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / sizeof(MappingType)];
+  MappingType array_[INTERNAL_PAGE_SIZE];
 };
 }  // namespace bustub
@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_key_search.h
+//
+// Identification: src/include/storage/page/b_plus_tree_key_search.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "type/type_id.h"
+
+namespace bustub {
+
+/**
+ * In-page key search shared by B+ tree leaf and internal pages.
+ *
+ * Keys sit in a sorted array of (key, value) pairs. In general they are
+ * binary searched with the comparator. Single-column INTEGER and BIGINT keys
+ * (see GenericComparator::GetIntegerKeyType) skip the comparator: the
+ * integers are read straight from the keys, binary searched down to a small
+ * window, and the window is counted with SIMD compares.
+ */
+
+/**
+ * @return how many of the n integers at base, base + stride, base + 2 * stride, ...
+ * are less than key, or not greater than key if or_equal is set. The integers
+ * must be sorted.
+ */
+auto CountKeysBelow(const char *base, size_t stride, int n, int32_t key, bool or_equal) -> int;
+auto CountKeysBelow(const char *base, size_t stride, int n, int64_t key, bool or_equal) -> int;
+
+/**
+ * @brief Find the first pair in array[begin, end) whose key is not less than
+ * key, or greater than key if upper is set.
+ * @return the index of that pair, end if there is none
+ */
+template <typename PairType, typename KeyType, typename KeyComparator>
+auto KeySearch(const PairType *array, int begin, int end, const KeyType &key, const KeyComparator &comparator,
+               bool upper = false) -> int {
+  if (begin >= end) {
+    return begin;
+  }
+  const auto *base = reinterpret_cast<const char *>(&array[begin].first);
+  switch (comparator.GetIntegerKeyType()) {
+    case TypeId::INTEGER: {
+      int32_t int_key;
+      memcpy(&int_key, &key, sizeof(int_key));
+      return begin + CountKeysBelow(base, sizeof(PairType), end - begin, int_key, upper);
+    }
+    case TypeId::BIGINT:
+      if constexpr (sizeof(KeyType) >= sizeof(int64_t)) {
+        int64_t int_key;
+        memcpy(&int_key, &key, sizeof(int_key));
+        return begin + CountKeysBelow(base, sizeof(PairType), end - begin, int_key, upper);
+      }
+      break;
+    default:
+      break;
+  }
+  // Invariant: array[lo - 1] is below key, array[hi] is not.
+  auto lo = begin;
+  auto hi = end;
+  while (lo < hi) {
+    auto mid = lo + (hi - lo) / 2;
+    auto cmp = comparator(array[mid].first, key);
+    if (cmp < 0 || (upper && cmp == 0)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+}  // namespace bustub
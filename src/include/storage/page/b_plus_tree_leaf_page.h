@@ -13,12 +13,13 @@
 #include <utility>
 #include <vector>
 
+#include "storage/page/b_plus_tree_compressed_pairs.h"
 #include "storage/page/b_plus_tree_page.h"
 
 namespace bustub {
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
-#define LEAF_PAGE_HEADER_SIZE 28
+#define LEAF_PAGE_HEADER_SIZE (32 + sizeof(KeyType))
 #define LEAF_PAGE_SIZE ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
 
 /**
@@ -26,33 +27,57 @@ namespace bustub {
  * see include/common/rid.h for detailed implementation) together within leaf
  * page. Only support unique key.
  *
+ * The high key bounds the keys of the page from above, and is the first key of
+ * the next page as far as the parent knows. It is only valid when there is a
+ * next page.
+ *
  * Leaf page format (keys are stored in order):
  *  ----------------------------------------------------------------------
  * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
  *  ----------------------------------------------------------------------
  *
- *  Header format (size in byte, 28 bytes in total):
+ *  Header format (size in byte, 32 bytes plus the key size in total):
  *  ---------------------------------------------------------------------
  * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
  *  ---------------------------------------------------------------------
- *  -----------------------------------------------
- * | ParentPageId (4) | PageId (4) | NextPageId (4)
- *  -----------------------------------------------
+ *  -------------------------------------------------------------------------------
+ * | ParentPageId (4) | PageId (4) | KeyFormat (4) | NextPageId (4) | HighKey (key)
+ *  -------------------------------------------------------------------------------
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeLeafPage : public BPlusTreePage {
  public:
+  using CompressedPairs = CompressedPairArray<KeyType, ValueType, LEAF_PAGE_SIZE * sizeof(MappingType)>;
+  // The max size of compressed pages. The halves of a full page fit in a page even if their keys do not compress.
+  static constexpr int COMPRESSED_MAX_SIZE = 2 * CompressedPairs::Capacity(sizeof(KeyType));
+
   // After creating a new leaf page from buffer pool, must call initialize
   // method to set default values
-  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = LEAF_PAGE_SIZE);
+  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = LEAF_PAGE_SIZE,
+            IndexKeyFormat key_format = IndexKeyFormat::PLAIN);
   // helper methods
   auto GetNextPageId() const -> page_id_t;
   void SetNextPageId(page_id_t next_page_id);
+  auto GetHighKey() const -> const KeyType &;
+  void SetHighKey(const KeyType &high_key);
   auto KeyAt(int index) const -> KeyType;
   auto ValueAt(int index) const -> ValueType;
 
+  /**
+   * @brief Binary search the page for a key.
+   *
+   * @return The index of the first key that is not less than key, the size if there is none.
+   */
+  auto KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int;
+
   auto Contain(const KeyType &key, const KeyComparator &comparator) -> bool;
 
+  /**
+   * @return Whether the key can be inserted without the page reaching its max size, or running out of space if it
+   * is compressed.
+   */
+  auto CanInsert(const KeyType &key) const -> bool;
+
   /**
    * @brife Insert the new kv pair in the proper position of the array and size will increase if size<=max_size .
    * Otherwise, the function just returns.
@@ -91,11 +116,18 @@ class BPlusTreeLeafPage : public BPlusTreePage {
 
   auto PopFront() -> MappingType;
 
+  // The pairs of a plain page.
   inline auto Get() -> MappingType * { return array_; }
 
  private:
+  inline auto Compressed() const -> const CompressedPairs * {
+    return reinterpret_cast<const CompressedPairs *>(array_);
+  }
+  inline auto Compressed() -> CompressedPairs * { return reinterpret_cast<CompressedPairs *>(array_); }
+
   page_id_t next_page_id_;
+  KeyType high_key_;
   // Flexible array member for page data.
-  MappingType array_[(LEAF_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType)];
+  MappingType array_[LEAF_PAGE_SIZE];
 };
 }  // namespace bustub
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstring>
 #include <iostream>
 
@@ -52,10 +53,17 @@ class Page {
   inline auto IsDirty() -> bool { return is_dirty_; }
 
   /** Acquire the page write latch. */
-  inline void WLatch() { rwlatch_.WLock(); }
+  inline void WLatch() {
+    rwlatch_.WLock();
+    version_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
 
   /** Release the page write latch. */
-  inline void WUnlatch() { rwlatch_.WUnlock(); }
+  inline void WUnlatch() {
+    version_.fetch_add(1, std::memory_order_release);
+    rwlatch_.WUnlock();
+  }
 
   /** Acquire the page read latch. */
   inline void RLatch() { rwlatch_.RLock(); }
@@ -63,6 +71,27 @@ class Page {
   /** Release the page read latch. */
   inline void RUnlatch() { rwlatch_.RUnlock(); }
 
+  /**
+   * Start an optimistic read, which takes no latch: read the version, read the page, then check with
+   * ValidateVersion() that no writer got in between. The page must stay pinned meanwhile.
+   * @return the version of the page, after waiting for the current writer if there is one
+   */
+  inline auto ReadVersion() -> uint64_t {
+    auto version = version_.load(std::memory_order_acquire);
+    while ((version & 1) != 0) {
+      rwlatch_.RLock();
+      rwlatch_.RUnlock();
+      version = version_.load(std::memory_order_acquire);
+    }
+    return version;
+  }
+
+  /** @return true if the page has not been write latched since ReadVersion() returned version */
+  inline auto ValidateVersion(uint64_t version) const -> bool {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return version_.load(std::memory_order_relaxed) == version;
+  }
+
   /** @return the page LSN. */
   inline auto GetLSN() -> lsn_t { return *reinterpret_cast<lsn_t *>(GetData() + OFFSET_LSN); }
 
@@ -81,8 +110,9 @@ class Page {
   /** Zeroes out the data that is held within the page. */
   inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, BUSTUB_PAGE_SIZE); }
 
-  /** The actual data that is stored within a page. */
-  char data_[BUSTUB_PAGE_SIZE]{};
+  /** The actual data that is stored within a page. It must stay the first member, and it is aligned so frames can be
+   * handed to a DiskManager opened with O_DIRECT. */
+  alignas(BUSTUB_PAGE_ALIGNMENT) char data_[BUSTUB_PAGE_SIZE]{};
   /** The ID of this page. */
   page_id_t page_id_ = INVALID_PAGE_ID;
   /** The pin count of this page. */
@@ -92,6 +122,8 @@ class Page {
   bool is_dirty_ = false;
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
+  /** Bumped when the write latch is taken and when it is released, so it is odd while a writer holds it. */
+  std::atomic<uint64_t> version_{0};
 };
 
 }  // namespace bustub
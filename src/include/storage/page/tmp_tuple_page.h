@@ -6,12 +6,9 @@
 
 namespace bustub {
 
-// To pass the test cases for this class, you must follow the existing
-// TmpTuplePage format and implement the existing functions exactly as they are!
-// It may be helpful to look at TablePage. Remember that this task is optional,
-// you get full credit if you finish the next task.
-
 /**
+ * TmpTuplePage holds tuples operators spill out of memory, see SpillFile.
+ *
  * TmpTuplePage format:
  *
  * Sizes are in bytes.
@@ -25,15 +22,57 @@ class TmpTuplePage : public Page {
  public:
   void Init(page_id_t page_id, uint32_t page_size) {
     memcpy(GetData(), &page_id, sizeof(page_id_t));
-    memcpy(GetData() + sizeof(page_id_t), &page_size, sizeof(uint32_t));
+    SetLSN(INVALID_LSN);
+    SetFreeSpacePointer(page_size);
+  }
+
+  auto GetTablePageId() -> page_id_t { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  /**
+   * Insert a tuple in front of the ones inserted before.
+   * @param tuple the tuple to insert
+   * @param[out] out where the tuple was stored
+   * @return false if the tuple does not fit in the free space
+   */
+  auto Insert(const Tuple &tuple, TmpTuple *out) -> bool {
+    const auto size = static_cast<uint32_t>(sizeof(uint32_t) + tuple.GetLength());
+    auto free_space_pointer = GetFreeSpacePointer();
+    if (free_space_pointer < SIZE_TMP_TUPLE_PAGE_HEADER + size) {
+      return false;
+    }
+    free_space_pointer -= size;
+    tuple.SerializeTo(GetData() + free_space_pointer);
+    SetFreeSpacePointer(free_space_pointer);
+    *out = TmpTuple(GetTablePageId(), free_space_pointer);
+    return true;
   }
 
-  auto GetTablePageId() -> page_id_t { return INVALID_PAGE_ID; }
+  /**
+   * Read a tuple. The tuple inserted last is at the free space pointer, and every tuple is followed by the one
+   * inserted before it, up to the end of the page.
+   * @param offset the offset of the tuple
+   * @param[out] tuple the tuple read
+   * @return the offset of the tuple following it
+   */
+  auto Get(uint32_t offset, Tuple *tuple) -> uint32_t {
+    tuple->DeserializeFrom(GetData() + offset);
+    return offset + sizeof(uint32_t) + tuple->GetLength();
+  }
 
-  auto Insert(const Tuple &tuple, TmpTuple *out) -> bool { return false; }
+  /** @return the offset of the start of the tuples, the end of the free space */
+  auto GetFreeSpacePointer() -> uint32_t {
+    return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TMP_TUPLE_FREE_SPACE);
+  }
 
  private:
   static_assert(sizeof(page_id_t) == 4);
+
+  static constexpr size_t OFFSET_TMP_TUPLE_FREE_SPACE = sizeof(page_id_t) + sizeof(lsn_t);
+  static constexpr size_t SIZE_TMP_TUPLE_PAGE_HEADER = OFFSET_TMP_TUPLE_FREE_SPACE + sizeof(uint32_t);
+
+  void SetFreeSpacePointer(uint32_t free_space_pointer) {
+    memcpy(GetData() + OFFSET_TMP_TUPLE_FREE_SPACE, &free_space_pointer, sizeof(uint32_t));
+  }
 };
 
 }  // namespace bustub
@@ -0,0 +1,106 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.h
+//
+// Identification: src/include/storage/table/tuple_batch.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * TupleBatch holds up to a fixed number of rows of one schema column by column, the unit executors exchange
+ * through AbstractExecutor::NextBatch().
+ *
+ * Rows are only ever appended. Which of them are part of the batch is decided by the selection vector, the
+ * ascending indexes of the selected rows, so that a filter drops rows without moving any values. Appending a row
+ * selects it.
+ */
+class TupleBatch {
+ public:
+  /**
+   * Create an empty batch.
+   * @param schema the schema of the rows, which has to outlive the batch
+   * @param capacity the number of rows the batch holds at most
+   */
+  explicit TupleBatch(const Schema *schema, uint32_t capacity = TUPLE_BATCH_SIZE);
+
+  /**
+   * Drop all rows, keeping the memory of the columns if the schema does not change.
+   * @param schema the schema of the rows appended from now on
+   */
+  void Reset(const Schema *schema);
+
+  /** @return the schema of the rows */
+  auto GetSchema() const -> const Schema & { return *schema_; }
+
+  /** @return the number of rows the batch holds at most */
+  auto GetCapacity() const -> uint32_t { return capacity_; }
+
+  /** @return the number of rows appended, selected or not */
+  auto GetRowCount() const -> uint32_t { return static_cast<uint32_t>(rids_.size()); }
+
+  /** @return whether no more rows can be appended */
+  auto IsFull() const -> bool { return GetRowCount() >= capacity_; }
+
+  /** @return the ascending indexes of the selected rows */
+  auto GetSelection() const -> const std::vector<uint32_t> & { return selection_; }
+
+  /** @return whether no row is selected */
+  auto IsEmpty() const -> bool { return selection_.empty(); }
+
+  /** Replace the selection vector, which has to hold ascending indexes of appended rows. */
+  void SetSelection(std::vector<uint32_t> selection);
+
+  /** @return the values of every appended row in the column_idx'th column */
+  auto GetColumn(uint32_t column_idx) const -> const std::vector<Value> & { return columns_[column_idx]; }
+
+  /** @return the value of the row in the column_idx'th column */
+  auto GetValue(uint32_t row, uint32_t column_idx) const -> const Value & { return columns_[column_idx][row]; }
+
+  /** @return the RID of the row */
+  auto GetRid(uint32_t row) const -> RID { return rids_[row]; }
+
+  /** Append the values of a tuple of the batch's schema. */
+  void Append(const Tuple &tuple, RID rid);
+
+  /** Append a row given one value per column. */
+  void Append(std::vector<Value> values, RID rid);
+
+  /**
+   * Replace the content of the batch with whole columns, every row of them selected.
+   * @param columns one vector of values per column of the schema, all of the same length
+   * @param rids the RID of every row
+   */
+  void SetColumns(std::vector<std::vector<Value>> columns, std::vector<RID> rids);
+
+  /** @return the values of the row, one per column */
+  auto GetRowValues(uint32_t row) const -> std::vector<Value>;
+
+  /** @return the row serialized as a tuple of the batch's schema */
+  auto GetTuple(uint32_t row) const -> Tuple;
+
+ private:
+  const Schema *schema_;
+  uint32_t capacity_;
+  /** One vector of values per column, each holding a value of every appended row. */
+  std::vector<std::vector<Value>> columns_;
+  std::vector<RID> rids_;
+  std::vector<uint32_t> selection_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,164 @@
+#include <memory>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "common/macros.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+#include "type/type_id.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return whether values of type can bound keys of column_type, which they are cast to without loss */
+auto CanBoundColumn(TypeId type, TypeId column_type) -> bool {
+  if (type == column_type) {
+    return true;
+  }
+  const auto is_integer = [](TypeId t) {
+    return t == TypeId::TINYINT || t == TypeId::SMALLINT || t == TypeId::INTEGER || t == TypeId::BIGINT;
+  };
+  // The integer types are declared from the narrowest to the widest.
+  return is_integer(type) && is_integer(column_type) && type < column_type;
+}
+
+/** @return the comparison with its operands swapped, `a < b` for `b > a` */
+auto FlipComparison(ComparisonType comp_type) -> ComparisonType {
+  switch (comp_type) {
+    case ComparisonType::LessThan:
+      return ComparisonType::GreaterThan;
+    case ComparisonType::LessThanOrEqual:
+      return ComparisonType::GreaterThanOrEqual;
+    case ComparisonType::GreaterThan:
+      return ComparisonType::LessThan;
+    case ComparisonType::GreaterThanOrEqual:
+      return ComparisonType::LessThanOrEqual;
+    default:
+      return comp_type;
+  }
+}
+
+}  // namespace
+
+auto Optimizer::CollectIndexRange(const AbstractExpression &expr, uint32_t column_id, TypeId column_type,
+                                  IndexRange &range) -> bool {
+  if (const auto *logic_expr = dynamic_cast<const LogicExpression *>(&expr); logic_expr != nullptr) {
+    if (logic_expr->logic_type_ != LogicType::And) {
+      return false;
+    }
+    // Both sides have to be evaluated, either may bound the range.
+    const auto left = CollectIndexRange(*logic_expr->GetChildAt(0), column_id, column_type, range);
+    const auto right = CollectIndexRange(*logic_expr->GetChildAt(1), column_id, column_type, range);
+    return left || right;
+  }
+  const auto *cmp_expr = dynamic_cast<const ComparisonExpression *>(&expr);
+  if (cmp_expr == nullptr) {
+    return false;
+  }
+  auto comp_type = cmp_expr->comp_type_;
+  const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(cmp_expr->children_[0].get());
+  const auto *constant_expr = dynamic_cast<const ConstantValueExpression *>(cmp_expr->children_[1].get());
+  if (column_expr == nullptr || constant_expr == nullptr) {
+    column_expr = dynamic_cast<const ColumnValueExpression *>(cmp_expr->children_[1].get());
+    constant_expr = dynamic_cast<const ConstantValueExpression *>(cmp_expr->children_[0].get());
+    comp_type = FlipComparison(comp_type);
+  }
+  if (column_expr == nullptr || constant_expr == nullptr || column_expr->GetTupleIdx() != 0 ||
+      column_expr->GetColIdx() != column_id) {
+    return false;
+  }
+  const auto &value = constant_expr->val_;
+  // Nothing compares true with NULL, the filter keeps no tuple, but leave that to it.
+  if (value.IsNull() || !CanBoundColumn(value.GetTypeId(), column_type)) {
+    return false;
+  }
+
+  // Keep the tighter of two bounds, of two equal ones the exclusive.
+  const auto tighten_lower = [&](bool inclusive) {
+    if (!range.lower_.has_value() || value.CompareGreaterThan(*range.lower_) == CmpBool::CmpTrue ||
+        (value.CompareEquals(*range.lower_) == CmpBool::CmpTrue && !inclusive)) {
+      range.lower_ = value;
+      range.lower_inclusive_ = inclusive;
+    }
+  };
+  const auto tighten_upper = [&](bool inclusive) {
+    if (!range.upper_.has_value() || value.CompareLessThan(*range.upper_) == CmpBool::CmpTrue ||
+        (value.CompareEquals(*range.upper_) == CmpBool::CmpTrue && !inclusive)) {
+      range.upper_ = value;
+      range.upper_inclusive_ = inclusive;
+    }
+  };
+  switch (comp_type) {
+    case ComparisonType::Equal:
+      tighten_lower(true);
+      tighten_upper(true);
+      return true;
+    case ComparisonType::GreaterThan:
+      tighten_lower(false);
+      return true;
+    case ComparisonType::GreaterThanOrEqual:
+      tighten_lower(true);
+      return true;
+    case ComparisonType::LessThan:
+      tighten_upper(false);
+      return true;
+    case ComparisonType::LessThanOrEqual:
+      tighten_upper(true);
+      return true;
+    default:
+      return false;
+  }
+}
+
+auto Optimizer::OptimizeFilterAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  // Writers modify the indexes of the table they read, which an index scan below them would be walking.
+  if (plan->GetType() == PlanType::Insert || plan->GetType() == PlanType::Update ||
+      plan->GetType() == PlanType::Delete) {
+    return plan;
+  }
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeFilterAsIndexScan(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() == PlanType::Filter) {
+    const auto &filter_plan = dynamic_cast<const FilterPlanNode &>(*optimized_plan);
+    BUSTUB_ENSURE(filter_plan.children_.size() == 1, "Filter with multiple children?? Impossible!");
+    const auto &child_plan = filter_plan.children_[0];
+    if (child_plan->GetType() != PlanType::SeqScan) {
+      return optimized_plan;
+    }
+    const auto &seq_scan = dynamic_cast<const SeqScanPlanNode &>(*child_plan);
+    if (seq_scan.filter_predicate_ != nullptr) {
+      return optimized_plan;
+    }
+    const auto &table_schema = seq_scan.OutputSchema();
+    for (const auto *index : catalog_.GetTableIndexes(seq_scan.table_name_)) {
+      // The index is sorted by its first key column before the others, only that one can bound a range scan.
+      const auto column_id = index->index_->GetKeyAttrs()[0];
+      IndexRange range;
+      if (!CollectIndexRange(*filter_plan.GetPredicate(), column_id, table_schema.GetColumn(column_id).GetType(),
+                             range)) {
+        continue;
+      }
+      // The filter stays, the range only narrows down the tuples it is evaluated on.
+      auto index_scan =
+          std::make_shared<IndexScanPlanNode>(seq_scan.output_schema_, index->index_oid_, std::move(range));
+      return std::make_shared<FilterPlanNode>(filter_plan.output_schema_, filter_plan.GetPredicate(),
+                                              std::move(index_scan));
+    }
+  }
+
+  return optimized_plan;
+}
+
+}  // namespace bustub
@@ -9,6 +9,7 @@
 #include "execution/expressions/column_value_expression.h"
 #include "execution/expressions/comparison_expression.h"
 #include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
 #include "execution/plans/abstract_plan.h"
 #include "execution/plans/filter_plan.h"
 #include "execution/plans/hash_join_plan.h"
@@ -21,15 +22,47 @@
 
 namespace bustub {
 
-auto Optimizer::MatchIndex(const std::string &table_name, uint32_t index_key_idx)
-    -> std::optional<std::tuple<index_oid_t, std::string>> {
-  const auto key_attrs = std::vector{index_key_idx};
+auto Optimizer::MatchIndex(const std::string &table_name, const std::vector<uint32_t> &column_ids)
+    -> const IndexInfo * {
+  auto sorted_column_ids = column_ids;
+  std::sort(sorted_column_ids.begin(), sorted_column_ids.end());
   for (const auto *index_info : catalog_.GetTableIndexes(table_name)) {
-    if (key_attrs == index_info->index_->GetKeyAttrs()) {
-      return std::make_optional(std::make_tuple(index_info->index_oid_, index_info->name_));
+    auto key_attrs = index_info->index_->GetKeyAttrs();
+    std::sort(key_attrs.begin(), key_attrs.end());
+    if (key_attrs == sorted_column_ids) {
+      return index_info;
     }
   }
-  return std::nullopt;
+  return nullptr;
+}
+
+auto Optimizer::CollectEquiJoinKeys(const AbstractExpression &expr, std::vector<AbstractExpressionRef> &outer_keys,
+                                    std::vector<uint32_t> &inner_column_ids) -> bool {
+  if (const auto *logic_expr = dynamic_cast<const LogicExpression *>(&expr); logic_expr != nullptr) {
+    return logic_expr->logic_type_ == LogicType::And &&
+           CollectEquiJoinKeys(*logic_expr->GetChildAt(0), outer_keys, inner_column_ids) &&
+           CollectEquiJoinKeys(*logic_expr->GetChildAt(1), outer_keys, inner_column_ids);
+  }
+  const auto *cmp_expr = dynamic_cast<const ComparisonExpression *>(&expr);
+  if (cmp_expr == nullptr || cmp_expr->comp_type_ != ComparisonType::Equal) {
+    return false;
+  }
+  const auto *left_expr = dynamic_cast<const ColumnValueExpression *>(cmp_expr->children_[0].get());
+  const auto *right_expr = dynamic_cast<const ColumnValueExpression *>(cmp_expr->children_[1].get());
+  if (left_expr == nullptr || right_expr == nullptr || left_expr->GetTupleIdx() == right_expr->GetTupleIdx()) {
+    return false;
+  }
+  const auto *outer_expr = left_expr->GetTupleIdx() == 0 ? left_expr : right_expr;
+  const auto *inner_expr = left_expr->GetTupleIdx() == 0 ? right_expr : left_expr;
+  // Both join sides may constrain the same inner column, which a single index key cannot express.
+  if (std::find(inner_column_ids.begin(), inner_column_ids.end(), inner_expr->GetColIdx()) != inner_column_ids.end()) {
+    return false;
+  }
+  // The key is evaluated against the outer tuple alone, so it has to read tuple 0.
+  outer_keys.emplace_back(
+      std::make_shared<ColumnValueExpression>(0, outer_expr->GetColIdx(), outer_expr->GetReturnType()));
+  inner_column_ids.push_back(inner_expr->GetColIdx());
+  return true;
 }
 
 auto Optimizer::OptimizeNLJAsIndexJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
@@ -43,50 +76,30 @@ auto Optimizer::OptimizeNLJAsIndexJoin(const AbstractPlanNodeRef &plan) -> Abstr
     const auto &nlj_plan = dynamic_cast<const NestedLoopJoinPlanNode &>(*optimized_plan);
     // Has exactly two children
     BUSTUB_ENSURE(nlj_plan.children_.size() == 2, "NLJ should have exactly 2 children.");
-    // Check if expr is equal condition where one is for the left table, and one
-    // is for the right table.
-    if (const auto *expr = dynamic_cast<const ComparisonExpression *>(&nlj_plan.Predicate()); expr != nullptr) {
-      if (expr->comp_type_ == ComparisonType::Equal) {
-        if (const auto *left_expr = dynamic_cast<const ColumnValueExpression *>(expr->children_[0].get());
-            left_expr != nullptr) {
-          if (const auto *right_expr = dynamic_cast<const ColumnValueExpression *>(expr->children_[1].get());
-              right_expr != nullptr) {
-            // Ensure both exprs have tuple_id == 0
-            auto left_expr_tuple_0 =
-                std::make_shared<ColumnValueExpression>(0, left_expr->GetColIdx(), left_expr->GetReturnType());
-            auto right_expr_tuple_0 =
-                std::make_shared<ColumnValueExpression>(0, right_expr->GetColIdx(), right_expr->GetReturnType());
-            // Now it's in form of <column_expr> = <column_expr>. Let's match an
-            // index for them.
-
-            // Ensure right child is table scan
-            if (nlj_plan.GetRightPlan()->GetType() == PlanType::SeqScan) {
-              const auto &right_seq_scan = dynamic_cast<const SeqScanPlanNode &>(*nlj_plan.GetRightPlan());
-              if (left_expr->GetTupleIdx() == 0 && right_expr->GetTupleIdx() == 1) {
-                if (auto index = MatchIndex(right_seq_scan.table_name_, right_expr->GetColIdx());
-                    index != std::nullopt) {
-                  auto [index_oid, index_name] = *index;
-                  return std::make_shared<NestedIndexJoinPlanNode>(
-                      nlj_plan.output_schema_, nlj_plan.GetLeftPlan(), std::move(left_expr_tuple_0),
-                      right_seq_scan.GetTableOid(), index_oid, std::move(index_name), right_seq_scan.table_name_,
-                      right_seq_scan.output_schema_, nlj_plan.GetJoinType());
-                }
-              }
-              if (left_expr->GetTupleIdx() == 1 && right_expr->GetTupleIdx() == 0) {
-                if (auto index = MatchIndex(right_seq_scan.table_name_, left_expr->GetColIdx());
-                    index != std::nullopt) {
-                  auto [index_oid, index_name] = *index;
-                  return std::make_shared<NestedIndexJoinPlanNode>(
-                      nlj_plan.output_schema_, nlj_plan.GetLeftPlan(), std::move(right_expr_tuple_0),
-                      right_seq_scan.GetTableOid(), index_oid, std::move(index_name), right_seq_scan.table_name_,
-                      right_seq_scan.output_schema_, nlj_plan.GetJoinType());
-                }
-              }
-            }
+    // Ensure right child is table scan
+    if (nlj_plan.GetRightPlan()->GetType() != PlanType::SeqScan) {
+      return optimized_plan;
+    }
+    const auto &right_seq_scan = dynamic_cast<const SeqScanPlanNode &>(*nlj_plan.GetRightPlan());
 
-          }
-        }
+    // The predicate must be a conjunction of <outer column> = <inner column>, whose inner columns are exactly the
+    // key of an index on the right table. Probing with a key prefix would need a range scan.
+    std::vector<AbstractExpressionRef> outer_keys;
+    std::vector<uint32_t> inner_column_ids;
+    if (!CollectEquiJoinKeys(nlj_plan.Predicate(), outer_keys, inner_column_ids)) {
+      return optimized_plan;
+    }
+    if (const auto *index_info = MatchIndex(right_seq_scan.table_name_, inner_column_ids); index_info != nullptr) {
+      // Line the key predicates up with the index key columns.
+      std::vector<AbstractExpressionRef> key_predicates;
+      for (auto key_attr : index_info->index_->GetKeyAttrs()) {
+        auto pos = std::find(inner_column_ids.begin(), inner_column_ids.end(), key_attr) - inner_column_ids.begin();
+        key_predicates.push_back(outer_keys[pos]);
       }
+      return std::make_shared<NestedIndexJoinPlanNode>(
+          nlj_plan.output_schema_, nlj_plan.GetLeftPlan(), std::move(key_predicates), right_seq_scan.GetTableOid(),
+          index_info->index_oid_, index_info->name_, right_seq_scan.table_name_, right_seq_scan.output_schema_,
+          nlj_plan.GetJoinType());
     }
   }
 
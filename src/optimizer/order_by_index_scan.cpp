@@ -32,42 +32,74 @@ auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> A
     const auto &sort_plan = dynamic_cast<const SortPlanNode &>(*optimized_plan);
     const auto &order_bys = sort_plan.GetOrderBy();
 
-    // Has exactly one order by column
-    if (order_bys.size() != 1) {
-      return optimized_plan;
-    }
-
-    // Order type is asc or default
-    const auto &[order_type, expr] = order_bys[0];
-    if (!(order_type == OrderByType::ASC || order_type == OrderByType::DEFAULT)) {
-      return optimized_plan;
-    }
-
-    // Order expression is a column value expression
-    const auto *column_value_expr = dynamic_cast<ColumnValueExpression *>(expr.get());
-    if (column_value_expr == nullptr) {
-      return optimized_plan;
+    // Every order by is a column, all ascending (or default), or all descending for a reverse scan
+    std::vector<uint32_t> order_by_column_ids;
+    const bool reverse = !order_bys.empty() && order_bys[0].first == OrderByType::DESC;
+    for (const auto &[order_type, expr] : order_bys) {
+      if ((order_type == OrderByType::DESC) != reverse || order_type == OrderByType::INVALID) {
+        return optimized_plan;
+      }
+      const auto *column_value_expr = dynamic_cast<ColumnValueExpression *>(expr.get());
+      if (column_value_expr == nullptr) {
+        return optimized_plan;
+      }
+      order_by_column_ids.push_back(column_value_expr->GetColIdx());
     }
 
-    auto order_by_column_id = column_value_expr->GetColIdx();
-
     // Has exactly one child
     BUSTUB_ENSURE(optimized_plan->children_.size() == 1, "Sort with multiple children?? Impossible!");
     const auto &child_plan = optimized_plan->children_[0];
 
-    if (child_plan->GetType() == PlanType::SeqScan) {
-      const auto &seq_scan = dynamic_cast<const SeqScanPlanNode &>(*child_plan);
-      const auto *table_info = catalog_.GetTable(seq_scan.GetTableOid());
-      const auto indices = catalog_.GetTableIndexes(table_info->name_);
-
-      for (const auto *index : indices) {
-        const auto &columns = index->key_schema_.GetColumns();
-        if (columns.size() == 1 &&
-            columns[0].GetName() == table_info->schema_.GetColumn(order_by_column_id).GetName()) {
-          // Index matched, return index scan instead
-          return std::make_shared<IndexScanPlanNode>(optimized_plan->output_schema_, index->index_oid_);
+    // The index is sorted by its key columns in order, so the order bys have to be a prefix of them.
+    const auto sorts_by = [&](const IndexInfo *index) {
+      const auto &key_attrs = index->index_->GetKeyAttrs();
+      return order_by_column_ids.size() <= key_attrs.size() &&
+             std::equal(order_by_column_ids.begin(), order_by_column_ids.end(), key_attrs.begin());
+    };
+    // An index scan in the order of the sort in place of scan, a seq scan without a predicate or an index scan, or
+    // nullptr.
+    const auto ordered_scan = [&](const AbstractPlanNodeRef &scan) -> AbstractPlanNodeRef {
+      if (scan->GetType() == PlanType::IndexScan) {
+        const auto &index_scan = dynamic_cast<const IndexScanPlanNode &>(*scan);
+        if (index_scan.GetRange().reverse_ || !sorts_by(catalog_.GetIndex(index_scan.GetIndexOid()))) {
+          return nullptr;
+        }
+        auto range = index_scan.GetRange();
+        range.reverse_ = reverse;
+        return std::make_shared<IndexScanPlanNode>(optimized_plan->output_schema_, index_scan.GetIndexOid(),
+                                                   std::move(range));
+      }
+      if (scan->GetType() != PlanType::SeqScan) {
+        return nullptr;
+      }
+      const auto &seq_scan = dynamic_cast<const SeqScanPlanNode &>(*scan);
+      // The index scan has no filter to carry over.
+      if (seq_scan.filter_predicate_ != nullptr) {
+        return nullptr;
+      }
+      for (const auto *index : catalog_.GetTableIndexes(seq_scan.table_name_)) {
+        if (sorts_by(index)) {
+          IndexRange range;
+          range.reverse_ = reverse;
+          return std::make_shared<IndexScanPlanNode>(optimized_plan->output_schema_, index->index_oid_,
+                                                     std::move(range));
         }
       }
+      return nullptr;
+    };
+
+    if (child_plan->GetType() == PlanType::Filter) {
+      // A filter keeps the order of its input, the index scan goes below it.
+      const auto &filter_plan = dynamic_cast<const FilterPlanNode &>(*child_plan);
+      if (auto scan = ordered_scan(filter_plan.children_[0]); scan != nullptr) {
+        return std::make_shared<FilterPlanNode>(filter_plan.output_schema_, filter_plan.GetPredicate(),
+                                                std::move(scan));
+      }
+      return optimized_plan;
+    }
+    if (auto scan = ordered_scan(child_plan); scan != nullptr) {
+      // Index matched, return index scan instead
+      return scan;
     }
   }
 
@@ -10,8 +10,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #include <cassert>
+#include <cerrno>
+#include <cstdint>
 #include <cstring>
 #include <iostream>
 #include <mutex>  // NOLINT
@@ -26,11 +30,19 @@ namespace bustub {
 
 static char *buffer_used;
 
+/**
+ * Private helper: O_DIRECT needs the user buffer aligned, so unaligned callers go through a bounce buffer
+ */
+static auto NeedsBounceBuffer(bool direct_io, const char *page_data) -> bool {
+  return direct_io && reinterpret_cast<uintptr_t>(page_data) % BUSTUB_PAGE_ALIGNMENT != 0;
+}
+
 /**
  * Constructor: open/create a single database file & log file
  * @input db_file: database file name
+ * @input direct_io: whether the database file should bypass the kernel page cache
  */
-DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
+DiskManager::DiskManager(const std::string &db_file, bool direct_io) : file_name_(db_file) {
   std::string::size_type n = file_name_.rfind('.');
   if (n == std::string::npos) {
     // LOG_DEBUG("wrong file format");
@@ -49,16 +61,19 @@ DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
     }
   }
 
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out | std::ios::in);
-    if (!db_io_.is_open()) {
-      throw Exception("can't open db file");
-    }
+  int flags = O_RDWR | O_CREAT;
+#ifdef O_DIRECT
+  if (direct_io) {
+    db_fd_ = open(db_file.c_str(), flags | O_DIRECT, 0644);
+    // some file systems (e.g. older tmpfs) reject O_DIRECT, keep going with buffered I/O there
+    direct_io_ = db_fd_ >= 0;
+  }
+#endif
+  if (db_fd_ < 0) {
+    db_fd_ = open(db_file.c_str(), flags, 0644);
+  }
+  if (db_fd_ < 0) {
+    throw Exception("can't open db file");
   }
   buffer_used = nullptr;
 }
@@ -67,58 +82,73 @@ DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
  * Close all file streams
  */
 void DiskManager::ShutDown() {
-  {
-    std::scoped_lock scoped_db_io_latch(db_io_latch_);
-    db_io_.close();
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+    db_fd_ = -1;
   }
   log_io_.close();
 }
 
+DiskManager::~DiskManager() {
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+  }
+}
+
 /**
  * Write the contents of the specified page into disk file
+ * Positional write, so writers of different pages never wait for each other
  */
 void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  size_t offset = static_cast<size_t>(page_id) * BUSTUB_PAGE_SIZE;
-  // set write cursor to offset
+  auto offset = static_cast<off_t>(page_id) * BUSTUB_PAGE_SIZE;
+  alignas(BUSTUB_PAGE_ALIGNMENT) char bounce[BUSTUB_PAGE_SIZE];
+  if (NeedsBounceBuffer(direct_io_, page_data)) {
+    memcpy(bounce, page_data, BUSTUB_PAGE_SIZE);
+    page_data = bounce;
+  }
   num_writes_ += 1;
-  db_io_.seekp(offset);
-  db_io_.write(page_data, BUSTUB_PAGE_SIZE);
-  // check for I/O error
-  if (db_io_.bad()) {
-    // LOG_DEBUG("I/O error while writing");
-    return;
+  size_t written = 0;
+  while (written < BUSTUB_PAGE_SIZE) {
+    auto ret = pwrite(db_fd_, page_data + written, BUSTUB_PAGE_SIZE - written, offset + written);
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    // check for I/O error
+    if (ret <= 0) {
+      // LOG_DEBUG("I/O error while writing");
+      return;
+    }
+    written += ret;
   }
-  // needs to flush to keep disk file in sync
-  db_io_.flush();
 }
 
 /**
  * Read the contents of the specified page into the given memory area
+ * Positional read, so readers of different pages never wait for each other
  */
 void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  int offset = page_id * BUSTUB_PAGE_SIZE;
-  // check if read beyond file length
-  if (offset > GetFileSize(file_name_)) {
-    // LOG_DEBUG("I/O error reading past end of file");
-    // std::cerr << "I/O error while reading" << std::endl;
-  } else {
-    // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, BUSTUB_PAGE_SIZE);
-    if (db_io_.bad()) {
+  auto offset = static_cast<off_t>(page_id) * BUSTUB_PAGE_SIZE;
+  alignas(BUSTUB_PAGE_ALIGNMENT) char bounce[BUSTUB_PAGE_SIZE];
+  char *buf = NeedsBounceBuffer(direct_io_, page_data) ? bounce : page_data;
+  size_t read_count = 0;
+  while (read_count < BUSTUB_PAGE_SIZE) {
+    auto ret = pread(db_fd_, buf + read_count, BUSTUB_PAGE_SIZE - read_count, offset + read_count);
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret < 0) {
       // LOG_DEBUG("I/O error while reading");
       return;
     }
-    // if file ends before reading BUSTUB_PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < BUSTUB_PAGE_SIZE) {
-      // LOG_DEBUG("Read less than a page");
-      db_io_.clear();
-      // std::cerr << "Read less than a page" << std::endl;
-      memset(page_data + read_count, 0, BUSTUB_PAGE_SIZE - read_count);
+    // end of file, never written pages read back as zeros
+    if (ret == 0) {
+      memset(buf + read_count, 0, BUSTUB_PAGE_SIZE - read_count);
+      break;
     }
+    read_count += ret;
+  }
+  if (buf != page_data) {
+    memcpy(page_data, buf, BUSTUB_PAGE_SIZE);
   }
 }
 
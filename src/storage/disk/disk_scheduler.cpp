@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler.cpp
+//
+// Identification: src/storage/disk/disk_scheduler.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_scheduler.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+DiskScheduler::DiskScheduler(DiskManager *disk_manager, size_t num_workers) : disk_manager_(disk_manager) {
+  BUSTUB_ASSERT(num_workers > 0, "disk scheduler needs at least one worker");
+  workers_.reserve(num_workers);
+  for (size_t i = 0; i < num_workers; ++i) {
+    workers_.emplace_back([this] { StartWorkerThread(); });
+  }
+}
+
+DiskScheduler::~DiskScheduler() {
+  // Put a `std::nullopt` per worker in the queue to signal to exit the loop
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    request_queue_.Put(std::nullopt);
+  }
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+void DiskScheduler::Schedule(DiskRequest r) { request_queue_.Put(std::make_optional(std::move(r))); }
+
+void DiskScheduler::Schedule(std::vector<DiskRequest> requests) {
+  std::vector<std::optional<DiskRequest>> batch;
+  batch.reserve(requests.size());
+  for (auto &r : requests) {
+    batch.emplace_back(std::move(r));
+  }
+  request_queue_.PutBatch(std::move(batch));
+}
+
+void DiskScheduler::StartWorkerThread() {
+  while (true) {
+    auto request = request_queue_.Get();
+    if (!request.has_value()) {
+      return;
+    }
+    if (request->is_write_) {
+      disk_manager_->WritePage(request->page_id_, request->data_);
+    } else {
+      disk_manager_->ReadPage(request->page_id_, request->data_);
+    }
+    request->callback_.set_value(true);
+  }
+}
+
+}  // namespace bustub
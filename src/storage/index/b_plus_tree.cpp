@@ -1,7 +1,11 @@
 
 #include <algorithm>
+#include <deque>
+#include <numeric>
 #include <string>
+#include <thread>  // NOLINT
 
+#include "buffer/buffer_access_strategy.h"
 #include "common/exception.h"
 #include "common/logger.h"
 #include "common/rid.h"
@@ -30,14 +34,22 @@ namespace bustub {
 
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_TYPE::BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                          int leaf_max_size, int internal_max_size)
+                          int leaf_max_size, int internal_max_size, bool b_link, IndexKeyFormat key_format)
     : index_name_(std::move(name)),
       root_page_id_(INVALID_PAGE_ID),
       buffer_pool_manager_(buffer_pool_manager),
       comparator_(comparator),
-      leaf_max_size_(leaf_max_size),
-      internal_max_size_(internal_max_size),
+      // Sizes that do not fit in a page are taken down to what does.
+      leaf_max_size_(std::min<int>(leaf_max_size, key_format == IndexKeyFormat::COMPRESSED
+                                                      ? LeafPage::COMPRESSED_MAX_SIZE
+                                                      : LEAF_PAGE_SIZE)),
+      internal_max_size_(std::min<int>(internal_max_size, key_format == IndexKeyFormat::COMPRESSED
+                                                              ? InternalPage::COMPRESSED_MAX_SIZE
+                                                              : INTERNAL_PAGE_SIZE)),
+      b_link_(b_link),
+      key_format_(key_format),
       root_page_id_page_(new Page) {
+  BUSTUB_ASSERT(b_link_ || key_format_ == IndexKeyFormat::PLAIN, "compressed pages need B-link mode");
   THREAD_DEBUG_LOG("Tree scale: leaf_max_size=%d,internal_max_size=%d", leaf_max_size, internal_max_size);
 }
 
@@ -62,22 +74,129 @@ auto BPLUSTREE_TYPE::IsEmpty() const -> bool { return root_page_id_ == INVALID_P
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) -> bool {
   THREAD_DEBUG_LOG("Enter | Parameter: key=%s", KeyToString(key).c_str());
-  bool optimistic_success;
-  const auto leaf = OptimisticSearch(key, SearchMode::Find, transaction, optimistic_success);
-  if (leaf == nullptr) {
-    return false;
+  while (true) {
+    uint64_t version;
+    const auto leaf = OptimisticSearch(&key, &version);
+    if (leaf == nullptr) {
+      return false;
+    }
+    const auto i = leaf->KeyIndex(key, comparator_);
+    const auto found = i != leaf->GetSize() && comparator_(leaf->KeyAt(i), key) == 0;
+    const auto value = found ? leaf->ValueAt(i) : ValueType{};
+    const auto valid = ToRawPage(leaf)->ValidateVersion(version);
+    buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
+    if (valid) {
+      if (found) {
+        result->emplace_back(value);
+      }
+      return found;
+    }
   }
-  const auto size = leaf->GetSize();
-  auto i = 0;
-  for (i = 0; i < size; ++i) {
-    const auto value = leaf->KeyAt(i);
-    if (comparator_(value, key) == 0) {
-      result->emplace_back(leaf->ValueAt(i));
-      break;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results,
+                               Transaction *transaction,
+                               const std::function<bool(const KeyType &, const KeyType &)> &in_range) {
+  results->assign(keys.size(), {});
+  std::vector<size_t> order(keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [this, &keys](size_t a, size_t b) { return comparator_(keys[a], keys[b]) < 0; });
+  std::vector<std::pair<size_t, ValueType>> found;
+  size_t next = 0;
+  LeafPage *leaf = nullptr;
+  uint64_t version;
+  // The smallest key of the leaf if a range went on into it, the next keys may lie before it.
+  std::optional<KeyType> low_key;
+  while (next < order.size()) {
+    if (leaf == nullptr) {
+      // A range found in part before the lookup restarted is looked up again as a whole.
+      (*results)[order[next]].clear();
+      low_key.reset();
+      leaf = OptimisticSearch(&keys[order[next]], &version);
+      if (leaf == nullptr) {
+        return;
+      }
+    }
+    // The first key belongs to the leaf, and the keys after it are not less, so they belong to it too until one is
+    // not less than the high key.
+    found.clear();
+    auto end = next;
+    // Set if the range of the last key looked up may go on in the next leaf.
+    auto range_continues = false;
+    do {
+      const auto &key = keys[order[end]];
+      auto i = leaf->KeyIndex(key, comparator_);
+      if (in_range) {
+        for (; i != leaf->GetSize() && in_range(leaf->KeyAt(i), key); i++) {
+          found.emplace_back(order[end], leaf->ValueAt(i));
+        }
+        range_continues = i == leaf->GetSize();
+      } else if (i != leaf->GetSize() && comparator_(leaf->KeyAt(i), key) == 0) {
+        found.emplace_back(order[end], leaf->ValueAt(i));
+      }
+      end++;
+    } while (end < order.size() && !range_continues && RightLinkFor(leaf, keys[order[end]]) == INVALID_PAGE_ID &&
+             (!low_key.has_value() || comparator_(keys[order[end]], *low_key) >= 0));
+    // A key before the leaf is looked up from the root.
+    const auto before_leaf = end < order.size() && !range_continues && low_key.has_value() &&
+                             comparator_(keys[order[end]], *low_key) < 0;
+    // The key is looked up again in the next leaf, where all entries are greater than it.
+    if (range_continues) {
+      end--;
+    }
+    // Couple the next leaf like OptimisticSearch() couples a child: its id is only used once the leaf has been
+    // validated, and it is pinned and its version read before the leaf is validated again.
+    Page *next_page = nullptr;
+    uint64_t next_version;
+    std::optional<KeyType> next_low_key;
+    auto valid = true;
+    if (end < order.size() && !before_leaf) {
+      const auto next_page_id = leaf->GetNextPageId();
+      if (range_continues && next_page_id != INVALID_PAGE_ID) {
+        next_low_key = leaf->GetHighKey();
+      }
+      valid = ToRawPage(leaf)->ValidateVersion(version);
+      if (valid && next_page_id != INVALID_PAGE_ID) {
+        next_page = buffer_pool_manager_->FetchPage(next_page_id);
+        // A leaf that cannot be fetched right now, e.g. because the pool is full, restarts the lookup.
+        valid = next_page != nullptr;
+        if (valid) {
+          next_version = next_page->ReadVersion();
+        }
+      }
+    }
+    valid = valid && ToRawPage(leaf)->ValidateVersion(version);
+    buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
+    leaf = nullptr;
+    if (!valid) {
+      if (next_page != nullptr) {
+        buffer_pool_manager_->UnpinPage(next_page->GetPageId(), false);
+      }
+      continue;
+    }
+    for (const auto &[index, value] : found) {
+      (*results)[index].push_back(value);
+    }
+    next = end;
+    if (next_page == nullptr) {
+      // A range ends with the last leaf.
+      if (range_continues) {
+        next++;
+      }
+      continue;
+    }
+    // Go on along the chain if the next key belongs to the next leaf, or its range goes on there, and from the root if
+    // it lies further right. A torn read of the next leaf here is caught when it is validated.
+    if (range_continues || RightLinkFor(ToTreePage(next_page), keys[order[next]]) == INVALID_PAGE_ID) {
+      leaf = ToLeaf(ToTreePage(next_page));
+      version = next_version;
+      low_key = next_low_key;
+    } else {
+      buffer_pool_manager_->UnpinPage(next_page->GetPageId(), false);
     }
   }
-  DisusePage(ToRawPage(leaf), UseMode::Read);
-  return (i != size);
 }
 
 /*****************************************************************************
@@ -94,6 +213,9 @@ INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) -> bool {
   THREAD_DEBUG_LOG("(thread %ld) Enter | Parameters: key=%s,value=%s", DEBUG_THREAD_ID, KeyToString(key).c_str(),
                    ValueToString(value).c_str());
+  if (b_link_) {
+    return BLinkInsert(key, value);
+  }
   auto latched_pages = std::unique_ptr<LatchedPageContainer, std::function<void(LatchedPageContainer *)>>(
       new LatchedPageContainer, [this](LatchedPageContainer *object) {
         for (auto &page : *object) {
@@ -101,15 +223,8 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
         }
         delete object;
       });
-  bool optimistic_success;
-  LeafPage *leaf = OptimisticSearch(key, SearchMode::Insert, transaction, optimistic_success);
-  if (!optimistic_success) {
-    if (leaf != nullptr) {
-      ToRawPage(leaf)->WUnlatch();
-      buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
-    }
-    leaf = PessimisticSearch(key, SearchMode::Insert, transaction, latched_pages.get());
-  } else if (leaf != nullptr) {
+  LeafPage *leaf = OptimisticLatchLeaf(key, SearchMode::Insert, transaction);
+  if (leaf != nullptr) {
     latched_pages->push_back(ToRawPage(leaf));
     if (leaf->Contain(key, comparator_)) {
       return false;
@@ -117,35 +232,18 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
     leaf->Insert(key, value, comparator_);
     return true;
   }
+  leaf = PessimisticSearch(key, SearchMode::Insert, transaction, latched_pages.get());
   if (leaf == nullptr) {
-    page_id_t new_page_id;
-    auto new_page = buffer_pool_manager_->NewPage(&new_page_id);
-    leaf = ToLeaf(ToTreePage(new_page));
-    leaf->Init(new_page_id, INVALID_PAGE_ID, leaf_max_size_);
-    leaf->SetPageType(IndexPageType::LEAF_PAGE);
-    leaf->Insert(key, value, comparator_);
-    buffer_pool_manager_->UnpinPage(new_page_id, true);
-    root_page_id_ = new_page_id;
-    UpdateRootPageId(new_page_id);
+    StartNewTree(key, value);
     return true;
   }
   if (leaf->Contain(key, comparator_)) {
     return false;
   }
   if ((leaf->GetSize() + 1) == leaf->GetMaxSize()) {
-    BUSTUB_ASSERT(optimistic_success == false, "unreasonable case");
     THREAD_DEBUG_LOG("(thread %ld) Enter case 3", DEBUG_THREAD_ID);
-    leaf->Insert(key, value, comparator_);
-    auto last_half = leaf->ExtractHalf();
-    page_id_t new_page_id;
-    auto new_page = buffer_pool_manager_->NewPage(&new_page_id);
-    auto new_leaf = reinterpret_cast<LeafPage *>(new_page);
-    new_leaf->Init(new_page_id, INVALID_PAGE_ID, leaf_max_size_);
-    new_leaf->SetPageType(IndexPageType::LEAF_PAGE);
-    new_leaf->SetNextPageId(leaf->GetNextPageId());
-    new_leaf->EmplaceBack(last_half);
-    leaf->SetNextPageId(new_leaf->GetPageId());
-    InsertInParent(leaf, last_half.front().first, new_leaf, latched_pages.get(), transaction);
+    auto new_leaf = SplitLeaf(leaf, key, value);
+    InsertInParent(leaf, leaf->GetHighKey(), new_leaf, latched_pages.get(), transaction);
   } else {
     leaf->Insert(key, value, comparator_);
   }
@@ -160,7 +258,7 @@ void BPLUSTREE_TYPE::InsertInParent(LeafPage *node, const KeyType &key, BPlusTre
   if (node->GetPageId() == GetRootPageId()) {
     page_id_t new_root_id;
     auto new_root = reinterpret_cast<InternalPage *>(buffer_pool_manager_->NewPage(&new_root_id));
-    new_root->Init(new_root_id, INVALID_PAGE_ID, internal_max_size_);
+    new_root->Init(new_root_id, INVALID_PAGE_ID, internal_max_size_, key_format_);
     new_root->Put(node->GetPageId(), key, value);
     new_root->SetPageType(IndexPageType::INTERNAL_PAGE);
     node->SetParentPageId(new_root_id);
@@ -175,26 +273,18 @@ void BPLUSTREE_TYPE::InsertInParent(LeafPage *node, const KeyType &key, BPlusTre
     return page->GetPageId() == node->GetParentPageId();
   })));
   if (parent->GetSize() == parent->GetMaxSize()) {
-    page_id_t new_internal_id;
-    auto new_internal = reinterpret_cast<InternalPage *>(buffer_pool_manager_->NewPage(&new_internal_id));
     auto pairs = parent->ExtractAll();
     pairs.insert(std::find_if(pairs.cbegin(), pairs.cend(),
                               [val = node->GetPageId()](const auto &pair) { return pair.second == val; }) +
                      1,
                  std::make_pair(key, value));
-    auto right_first_index = parent->GetMinSize();
-    auto right_first_key = pairs[right_first_index].first;
-    std::vector<std::pair<KeyType, page_id_t>> left_pairs{pairs.cbegin(), pairs.cbegin() + right_first_index};
-    std::vector<std::pair<KeyType, page_id_t>> right_pairs{pairs.cbegin() + right_first_index, pairs.cend()};
-    parent->EmplaceBack(left_pairs);
-    new_internal->Init(new_internal_id, INVALID_PAGE_ID, internal_max_size_);
-    new_internal->SetPageType(IndexPageType::INTERNAL_PAGE);
-    new_internal->EmplaceBack(right_pairs);
+    auto new_internal = SplitInternal(parent, pairs);
+    auto right_first_key = new_internal->KeyAt(0);
     if (comparator_(key, right_first_key) < 0) {
       NodeChangeParent(value, parent->GetPageId(), latched_pages);
     }
-    for (const auto &[_, page_id] : right_pairs) {
-      NodeChangeParent(page_id, new_internal->GetPageId(), latched_pages);
+    for (int i = 0; i < new_internal->GetSize(); i++) {
+      NodeChangeParent(new_internal->ValueAt(i), new_internal->GetPageId(), latched_pages);
     }
     buffer_pool_manager_->UnpinPage(value, true);
     InsertInParent(reinterpret_cast<LeafPage *>(parent), right_first_key, new_internal, latched_pages, transaction);
@@ -205,6 +295,230 @@ void BPLUSTREE_TYPE::InsertInParent(LeafPage *node, const KeyType &key, BPlusTre
   }
 }
 
+/*****************************************************************************
+ * BULK LOADING
+ *****************************************************************************/
+/*
+ * BulkLoader writes the tree level by level from the bottom while the sorted
+ * pairs stream in. Every level buffers the entries of its rightmost nodes and
+ * writes a node of target entries once more than target + min are buffered.
+ * So every node but the last two is packed to target, and at the end the
+ * buffer holds between min and target + min - 1 entries, which fit in one
+ * node or split into two halves that are at least half full.
+ *
+ * A node needs the page ids of its parent and, for leaves, of its right
+ * sibling when it is written, before those are. They are reserved ahead
+ * instead: child i of a level goes into node i / target of the level above.
+ * Only children of the last nodes of a level can end up elsewhere, and they
+ * are moved to their actual parent when it is written.
+ *
+ * A compressed node takes fewer entries than it is given when they do not
+ * fit, the rest stays buffered for the next node. Its level has no min size
+ * to keep, see the B-link mode.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BPLUSTREE_TYPE::BulkLoader {
+ public:
+  BulkLoader(BPlusTree *tree, double fill_factor)
+      : tree_(tree),
+        bpm_(tree->buffer_pool_manager_),
+        strategy_(bpm_->GetPoolSize()),
+        // Leaves split when they reach their max size, internal pages when they exceed it.
+        leaf_{tree->leaf_max_size_ - 1, tree->leaf_max_size_ / 2, fill_factor},
+        internal_{tree->internal_max_size_, (tree->internal_max_size_ + 1) / 2, fill_factor},
+        levels_(1) {}
+
+  void Add(const MappingType &pair) {
+    BUSTUB_ASSERT(pairs_.empty() || tree_->comparator_(pairs_.back().first, pair.first) < 0,
+                  "bulk loaded keys must be strictly increasing");
+    pairs_.push_back(pair);
+    if (static_cast<int>(pairs_.size()) >= leaf_.target_ + leaf_.min_) {
+      WriteNode(0, leaf_.target_, false);
+    }
+  }
+
+  /** @return the page id of the root, INVALID_PAGE_ID if no pairs were added */
+  auto Finish() -> page_id_t {
+    if (pairs_.empty()) {
+      return INVALID_PAGE_ID;
+    }
+    for (size_t level = 0;; level++) {
+      const auto &capacity = level == 0 ? leaf_ : internal_;
+      const auto size = Buffered(level);
+      if (size <= capacity.max_) {
+        if (levels_[level].num_nodes_ == 0 && FitCount(level, size) == size) {
+          return WriteNode(level, size, true);
+        }
+        WriteNode(level, size, false);
+      } else {
+        WriteNode(level, size / 2, false);
+        WriteNode(level, size - size / 2, false);
+      }
+      while (Buffered(level) > 0) {
+        WriteNode(level, std::min(Buffered(level), capacity.max_), false);
+      }
+      // Reserved for a node the level did not need after all.
+      for (auto page_id : levels_[level].reserved_) {
+        bpm_->DeletePage(page_id);
+      }
+      levels_[level].reserved_.clear();
+    }
+  }
+
+ private:
+  /** How many entries the nodes of a level hold. */
+  struct Capacity {
+    Capacity(int max, int min, double fill_factor)
+        : max_(max), min_(min), target_(std::clamp(static_cast<int>(max * fill_factor), min, max)) {}
+    int max_;
+    int min_;
+    int target_;
+  };
+
+  struct Level {
+    // Entries not written to a node yet, for internal levels. Leaves buffer pairs_ instead.
+    std::vector<std::pair<KeyType, page_id_t>> children_;
+    // Page ids of the next nodes of this level, the front one is written next.
+    std::deque<page_id_t> reserved_;
+    int num_nodes_{0};
+    // Children written to a node so far, and received at all.
+    int num_written_children_{0};
+    int num_children_{0};
+  };
+
+  /** @return the number of entries of a level not written to a node yet */
+  auto Buffered(size_t level) -> int {
+    return level == 0 ? static_cast<int>(pairs_.size()) : static_cast<int>(levels_[level].children_.size());
+  }
+
+  /** @return how many of the first count buffered entries of a level fit in a node */
+  auto FitCount(size_t level, int count) -> int {
+    if (tree_->key_format_ != IndexKeyFormat::COMPRESSED) {
+      return count;
+    }
+    return level == 0 ? LeafPage::CompressedPairs::FitCount(pairs_.data(), count)
+                      : InternalPage::CompressedPairs::FitCount(levels_[level].children_.data(), count);
+  }
+
+  /** @return the page id of node `node` of `level`, reserved if it was not yet */
+  auto Reserve(size_t level, int node) -> page_id_t {
+    auto &reserved = levels_[level].reserved_;
+    while (static_cast<int>(reserved.size()) <= node - levels_[level].num_nodes_) {
+      page_id_t page_id;
+      auto *page = bpm_->NewPage(&page_id, level == 0 ? &strategy_ : nullptr);
+      BUSTUB_ENSURE(page != nullptr, "no free frame to bulk load the B+ tree");
+      bpm_->UnpinPage(page_id, false);
+      reserved.push_back(page_id);
+    }
+    return reserved[node - levels_[level].num_nodes_];
+  }
+
+  /**
+   * Write the first count buffered entries of a level, or as many of them as fit, as its next node, and hand it to
+   * the level above.
+   */
+  auto WriteNode(size_t level, int count, bool is_root) -> page_id_t {
+    count = FitCount(level, count);
+    const auto node = levels_[level].num_nodes_;
+    const auto page_id = Reserve(level, node);
+    auto parent_page_id = INVALID_PAGE_ID;
+    if (!is_root) {
+      if (levels_.size() == level + 1) {
+        levels_.emplace_back();
+      }
+      // Nodes of the level above that took fewer children than planned may have been written already.
+      parent_page_id = Reserve(level + 1, std::max(levels_[level + 1].num_children_ / internal_.target_,
+                                                   levels_[level + 1].num_nodes_));
+    }
+    auto *page = bpm_->FetchPage(page_id, level == 0 ? &strategy_ : nullptr);
+    KeyType first_key;
+    if (level == 0) {
+      auto *leaf = tree_->ToLeaf(tree_->ToTreePage(page));
+      leaf->Init(page_id, parent_page_id, tree_->leaf_max_size_, tree_->key_format_);
+      leaf->EmplaceBack({pairs_.begin(), pairs_.begin() + count});
+      // The parent tells the leaf from the previous one by the high key of that one.
+      first_key = node == 0 ? pairs_.front().first : leaf_high_key_;
+      if (static_cast<int>(pairs_.size()) > count) {
+        leaf->SetNextPageId(Reserve(0, node + 1));
+        leaf_high_key_ = tree_->key_format_ == IndexKeyFormat::COMPRESSED
+                             ? tree_->comparator_.Separator(pairs_[count - 1].first, pairs_[count].first)
+                             : pairs_[count].first;
+        leaf->SetHighKey(leaf_high_key_);
+      }
+      pairs_.erase(pairs_.begin(), pairs_.begin() + count);
+    } else {
+      auto &children = levels_[level].children_;
+      auto *internal = tree_->ToInternal(tree_->ToTreePage(page));
+      internal->Init(page_id, parent_page_id, tree_->internal_max_size_, tree_->key_format_);
+      internal->EmplaceBack({children.begin(), children.begin() + count});
+      if (static_cast<int>(children.size()) > count) {
+        internal->SetNextPageId(Reserve(level, node + 1));
+        internal->SetHighKey(children[count].first);
+      }
+      // The children were written expecting node i / target as their parent.
+      for (int i = 0; i < count; i++) {
+        if ((levels_[level].num_written_children_ + i) / internal_.target_ != node) {
+          auto *child = bpm_->FetchPage(children[i].second);
+          tree_->ToTreePage(child)->SetParentPageId(page_id);
+          bpm_->UnpinPage(children[i].second, true);
+        }
+      }
+      first_key = children.front().first;
+      children.erase(children.begin(), children.begin() + count);
+      levels_[level].num_written_children_ += count;
+    }
+    bpm_->UnpinPage(page_id, true);
+    levels_[level].reserved_.pop_front();
+    levels_[level].num_nodes_++;
+    if (!is_root) {
+      AddChild(level + 1, first_key, page_id);
+    }
+    return page_id;
+  }
+
+  void AddChild(size_t level, const KeyType &key, page_id_t page_id) {
+    auto &children = levels_[level].children_;
+    children.emplace_back(key, page_id);
+    levels_[level].num_children_++;
+    if (static_cast<int>(children.size()) >= internal_.target_ + internal_.min_) {
+      WriteNode(level, internal_.target_, false);
+    }
+  }
+
+  BPlusTree *tree_;
+  BufferPoolManager *bpm_;
+  // Leaves are written once and not touched again, keep them from flooding the pool.
+  BufferAccessStrategy strategy_;
+  Capacity leaf_;
+  Capacity internal_;
+  std::vector<MappingType> pairs_;
+  // The high key of the last leaf written.
+  KeyType leaf_high_key_;
+  std::vector<Level> levels_;
+};
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::BulkLoad(const std::function<bool(MappingType *)> &next, double fill_factor,
+                              Transaction *transaction) -> bool {
+  // Hold the root id latch throughout, the tree is not usable before it is complete.
+  auto root_id_page = UsePage(INVALID_PAGE_ID, UseMode::Write, transaction);
+  if (!IsEmpty()) {
+    DisusePage(root_id_page, UseMode::Write);
+    return false;
+  }
+  BulkLoader loader(this, fill_factor);
+  MappingType pair;
+  while (next(&pair)) {
+    loader.Add(pair);
+  }
+  root_page_id_ = loader.Finish();
+  if (root_page_id_ != INVALID_PAGE_ID) {
+    UpdateRootPageId(1);
+  }
+  DisusePage(root_id_page, UseMode::Write);
+  return true;
+}
+
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
@@ -219,6 +533,15 @@ void BPLUSTREE_TYPE::InsertInParent(LeafPage *node, const KeyType &key, BPlusTre
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
   THREAD_DEBUG_LOG("(thread %ld) Enter | Parameters: key=%s", DEBUG_THREAD_ID, KeyToString(key).c_str());
+  if (b_link_) {
+    // Underfull leaves are left as they are, see the class comment.
+    auto leaf = BLinkLatchLeaf(key, nullptr);
+    if (leaf != nullptr) {
+      leaf->Remove(key, comparator_);
+      DisusePage(ToRawPage(leaf), UseMode::Write);
+    }
+    return;
+  }
   auto latched_pages = std::unique_ptr<LatchedPageContainer, std::function<void(LatchedPageContainer *)>>(
       new LatchedPageContainer, [this](LatchedPageContainer *object) {
         for (auto &page : *object) {
@@ -226,19 +549,13 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
         }
         delete object;
       });
-  bool optimistic_success;
-  LeafPage *leaf = OptimisticSearch(key, SearchMode::Delete, transaction, optimistic_success);
-  if (!optimistic_success) {
-    if (leaf != nullptr) {
-      ToRawPage(leaf)->WUnlatch();
-      buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
-    }
-    leaf = PessimisticSearch(key, SearchMode::Delete, transaction, latched_pages.get());
-  } else if (leaf != nullptr) {
+  LeafPage *leaf = OptimisticLatchLeaf(key, SearchMode::Delete, transaction);
+  if (leaf != nullptr) {
     latched_pages->push_back(ToRawPage(leaf));
     leaf->Remove(key, comparator_);
     return;
   }
+  leaf = PessimisticSearch(key, SearchMode::Delete, transaction, latched_pages.get());
   if (leaf == nullptr) {
     return;
   }
@@ -331,22 +648,26 @@ void BPLUSTREE_TYPE::RemoveEntry(BPlusTreePage *node, const KeyType &key, Latche
           ToInternal(node)->Get()[0].first = between_key;
           ToInternal(node)->PushFront(pair.second);
           parent_node->SetKeyAt(between_key_index, pair.first);
+          ToInternal(adjacent_node)->SetHighKey(pair.first);
           NodeChangeParent(pair.second, node->GetPageId(), latched_pages);
         } else {
           auto pair = ToLeaf(adjacent_node)->PopBack();
           ToLeaf(node)->Insert(pair.first, pair.second, comparator_);
           parent_node->SetKeyAt(between_key_index, pair.first);
+          ToLeaf(adjacent_node)->SetHighKey(pair.first);
         }
       } else /* Symmetric case*/ {
         if (!node->IsLeafPage()) {
           auto pair = ToInternal(adjacent_node)->PopFront();
           ToInternal(node)->PushBack(pair.first, pair.second);
           parent_node->SetKeyAt(between_key_index, ToInternal(adjacent_node)->Get()[0].first);
+          ToInternal(node)->SetHighKey(ToInternal(adjacent_node)->Get()[0].first);
           NodeChangeParent(pair.second, node->GetPageId(), latched_pages);
         } else {
           auto pair = ToLeaf(adjacent_node)->PopFront();
           ToLeaf(node)->Insert(pair.first, pair.second, comparator_);
           parent_node->SetKeyAt(between_key_index, ToLeaf(adjacent_node)->KeyAt(0));
+          ToLeaf(node)->SetHighKey(ToLeaf(adjacent_node)->KeyAt(0));
         }
       }
     }
@@ -363,6 +684,8 @@ void BPLUSTREE_TYPE::Coalesce(bustub::BPlusTreePage *predecessor, bustub::BPlusT
     auto pairs = ToInternal(node)->ExtractAll();
     pairs[0].first = between_key;
     ToInternal(predecessor)->EmplaceBack(pairs);
+    ToInternal(predecessor)->SetNextPageId(ToInternal(node)->GetNextPageId());
+    ToInternal(predecessor)->SetHighKey(ToInternal(node)->GetHighKey());
     for (const auto &[_, page_id] : pairs) {
       NodeChangeParent(page_id, predecessor->GetPageId(), latched_pages);
     }
@@ -370,6 +693,7 @@ void BPLUSTREE_TYPE::Coalesce(bustub::BPlusTreePage *predecessor, bustub::BPlusT
     auto pairs = ToLeaf(node)->ExtractAll();
     ToLeaf(predecessor)->EmplaceBack(pairs);
     ToLeaf(predecessor)->SetNextPageId(ToLeaf(node)->GetNextPageId());
+    ToLeaf(predecessor)->SetHighKey(ToLeaf(node)->GetHighKey());
   }
   latched_pages->erase(
       std::remove_if(latched_pages->begin(), latched_pages->end(),
@@ -402,52 +726,46 @@ void BPLUSTREE_TYPE::NodeChangeParent(page_id_t page_id, page_id_t parent_id, La
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
-  // TODO(hoo): Implementation for concurrent correctness after finishing project 2.
   THREAD_DEBUG_LOG("Enters");
-  if (GetRootPageId() == INVALID_PAGE_ID) {
-    return End();
-  }
-  auto page = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(root_page_id_));
-  BUSTUB_ASSERT(page != nullptr, "unexpected case");
-  while (!page->IsLeafPage()) {
-    auto internal_page = static_cast<InternalPage *>(page);
-    BUSTUB_ASSERT(internal_page->GetSize() != 0, "unexpected size");
-    auto next_page_id = internal_page->ValueAt(0);
-    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
-    page = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(next_page_id));
-    THREAD_DEBUG_LOG("next page id = %d, page_id=%d", next_page_id, page->GetPageId());
-    BUSTUB_ASSERT(next_page_id == page->GetPageId(), "unexpected case");
+  while (true) {
+    uint64_t version;
+    auto leaf = OptimisticSearch(nullptr, &version);
+    if (leaf == nullptr) {
+      return End();
+    }
+    auto itr_page_id = leaf->GetPageId();
+    const auto valid = ToRawPage(leaf)->ValidateVersion(version);
+    buffer_pool_manager_->UnpinPage(itr_page_id, false);
+    if (valid) {
+      return INDEXITERATOR_TYPE(itr_page_id, 0, buffer_pool_manager_);
+    }
   }
-  auto itr_page_id = page->GetPageId();
-  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
-  return INDEXITERATOR_TYPE(itr_page_id, 0, buffer_pool_manager_);
 }
 
 /*
  * Input parameter is low-key, find the leaf page that contains the input key
- * first, then construct index iterator
+ * first, then construct index iterator on the first entry whose key is not
+ * less than it
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
-  // TODO(hoo): Implementation for concurrent correctness after finishing project 2.
   THREAD_DEBUG_LOG("enters");
-  bool success;
-  auto leaf = OptimisticSearch(key, SearchMode::Find, nullptr, success);
-  const auto size = leaf->GetSize();
-  int i;
-  for (i = 0; i < size; ++i) {
-    if (comparator_(key, leaf->KeyAt(i)) == 0) {
-      break;
+  while (true) {
+    uint64_t version;
+    auto leaf = OptimisticSearch(&key, &version);
+    if (leaf == nullptr) {
+      return End();
+    }
+    // Past the last entry of the leaf, the iterator moves on to the next one.
+    auto itr_page_id = leaf->GetPageId();
+    auto itr_index = leaf->KeyIndex(key, comparator_);
+    const auto valid = ToRawPage(leaf)->ValidateVersion(version);
+    buffer_pool_manager_->UnpinPage(itr_page_id, false);
+    if (valid) {
+      return INDEXITERATOR_TYPE(itr_page_id, itr_index, buffer_pool_manager_);
     }
   }
-  auto itr_page_id = (i == size) ? INVALID_PAGE_ID : leaf->GetPageId();
-  auto itr_index = i;
-  auto itr_buffer_pool_manager = (i == size) ? nullptr : buffer_pool_manager_;
-  ToRawPage(leaf)->RUnlatch();
-  buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
-  THREAD_DEBUG_LOG("return valid pointer ? %s", (i == size) ? "invalid" : "valid");
-  return INDEXITERATOR_TYPE(itr_page_id, itr_index, itr_buffer_pool_manager);
 }
 
 /*
@@ -458,6 +776,61 @@ auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE(INVALID_PAGE_ID, 0, nullptr); }
 
+/*
+ * There are no left sibling pointers, a reverse iterator finds the leaf
+ * before the current one by a descent for the keys below its first key.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RBegin() -> INDEXITERATOR_TYPE {
+  auto [page_id, index] = PositionBefore(nullptr, true);
+  return INDEXITERATOR_TYPE(page_id, index, page_id == INVALID_PAGE_ID ? nullptr : buffer_pool_manager_,
+                            [this](const KeyType &key) { return PositionBefore(&key, false); });
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RBegin(const KeyType &key) -> INDEXITERATOR_TYPE {
+  auto [page_id, index] = PositionBefore(&key, true);
+  return INDEXITERATOR_TYPE(page_id, index, page_id == INVALID_PAGE_ID ? nullptr : buffer_pool_manager_,
+                            [this](const KeyType &key) { return PositionBefore(&key, false); });
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::PositionBefore(const KeyType *key, bool inclusive) -> std::pair<page_id_t, int> {
+  KeyType low_key;
+  while (true) {
+    uint64_t version;
+    std::optional<KeyType> low;
+    auto leaf = OptimisticSearchBefore(key, inclusive, &version, &low);
+    if (leaf == nullptr) {
+      return {INVALID_PAGE_ID, 0};
+    }
+    const auto size = leaf->GetSize();
+    auto i = size - 1;
+    if (key != nullptr) {
+      i = leaf->KeyIndex(*key, comparator_);
+      if (!inclusive || i == size || comparator_(leaf->KeyAt(i), *key) != 0) {
+        i--;
+      }
+    }
+    const auto page_id = leaf->GetPageId();
+    const auto valid = ToRawPage(leaf)->ValidateVersion(version);
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    if (!valid) {
+      continue;
+    }
+    if (i >= 0) {
+      return {page_id, i};
+    }
+    if (!low.has_value()) {
+      return {INVALID_PAGE_ID, 0};
+    }
+    // No entry of the leaf is before key, the ones that are come before the leaf.
+    low_key = *low;
+    key = &low_key;
+    inclusive = false;
+  }
+}
+
 /**
  * @return Page id of the root of this tree
  */
@@ -520,7 +893,7 @@ void BPLUSTREE_TYPE::DeletePage(Page *page, UseMode mode, bustub::Transaction *t
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::PessimisticSearch(const KeyType &key, SearchMode mode, Transaction *transaction,
                                        LatchedPageContainer *latched_pages) -> LeafPage * {
-  const auto use_mode = UseMode::Write;
+  constexpr auto use_mode = UseMode::Write;
   // This would add the page to latched_pages automatically if insert or delete.
   const auto smart_use = [this, transaction, latched_pages](page_id_t page_id) -> Page * {
     Page *page;
@@ -529,12 +902,10 @@ auto BPLUSTREE_TYPE::PessimisticSearch(const KeyType &key, SearchMode mode, Tran
     return page;
   };
   const auto reset_latched_pages = [this, latched_pages](BPlusTreePage *tree_page) {
-    auto num_remove_items = latched_pages->size() - 1;
-    for (auto iter = latched_pages->begin(); num_remove_items != 0; --num_remove_items) {
+    for (auto iter = latched_pages->begin(); iter + 1 != latched_pages->end(); ++iter) {
       DisusePage(*iter, use_mode);
-      ++iter;
-      latched_pages->pop_front();
     }
+    latched_pages->erase(latched_pages->begin(), latched_pages->end() - 1);
   };
   const auto is_safe_predicate = (mode == SearchMode::Insert)
       ? [](BPlusTreePage *tree_page, int cur_size_for_insert, int cur_size_for_delete) -> bool {
@@ -556,14 +927,7 @@ auto BPLUSTREE_TYPE::PessimisticSearch(const KeyType &key, SearchMode mode, Tran
     if (!tree_page->IsRootPage() && is_safe_predicate(tree_page, tree_page->GetSize(), tree_page->GetSize())) {
       reset_latched_pages(tree_page);
     }
-    const auto size = ToInternal(tree_page)->GetSize();
-    page_id_t next_page_id = ToInternal(tree_page)->ValueAt(0);
-    for (int i = 0; i < size; ++i) {
-      if ((i == (size - 1)) || (comparator_(ToInternal(tree_page)->KeyAt(i + 1), key) > 0)) {
-        next_page_id = ToInternal(tree_page)->ValueAt(i);
-        break;
-      }
-    }
+    page_id_t next_page_id = ToInternal(tree_page)->Lookup(key, comparator_);
     tree_page = ToTreePage(smart_use(next_page_id));
   }
   if (!tree_page->IsRootPage() && is_safe_predicate(tree_page, tree_page->GetSize() + 1, tree_page->GetSize())) {
@@ -573,9 +937,142 @@ auto BPLUSTREE_TYPE::PessimisticSearch(const KeyType &key, SearchMode mode, Tran
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::OptimisticSearch(const KeyType &key, SearchMode mode, bustub::Transaction *transaction,
-                                      bool &success) -> LeafPage * {
-  const auto use_mode = UseMode::Read;
+auto BPLUSTREE_TYPE::OptimisticSearch(const KeyType *key, uint64_t *version, std::vector<page_id_t> *path)
+    -> LeafPage * {
+  Page *root_id_page = root_page_id_page_.get();
+  const auto release = [this, root_id_page](Page *page) {
+    if (page != root_id_page) {
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    }
+  };
+  while (true) {
+    if (path != nullptr) {
+      path->clear();
+    }
+    auto parent = root_id_page;
+    auto parent_version = parent->ReadVersion();
+    page_id_t page_id = root_page_id_;
+    if (page_id == INVALID_PAGE_ID) {
+      if (parent->ValidateVersion(parent_version)) {
+        return nullptr;
+      }
+      continue;
+    }
+    while (true) {
+      // page_id was read from a validated parent. The child is pinned and its version read before the parent is
+      // validated again, so that no writer can have moved it out of the parent meanwhile.
+      auto page = buffer_pool_manager_->FetchPage(page_id);
+      auto page_version = page->ReadVersion();
+      const auto valid = parent->ValidateVersion(parent_version);
+      release(parent);
+      if (!valid) {
+        release(page);
+        break;
+      }
+      // Sizes stay within the page while a writer changes it, and the comparator stays within the keys, so a
+      // torn read here yields a wrong page id at worst, which the validation that follows catches.
+      auto tree_page = ToTreePage(page);
+      auto right_id = (key == nullptr) ? INVALID_PAGE_ID : RightLinkFor(tree_page, *key);
+      if (right_id != INVALID_PAGE_ID) {
+        // A split moved the key to the right after the parent was read: follow the link, coupled the same way.
+        if (!page->ValidateVersion(page_version)) {
+          release(page);
+          break;
+        }
+        parent = page;
+        parent_version = page_version;
+        page_id = right_id;
+        continue;
+      }
+      if (tree_page->IsLeafPage()) {
+        *version = page_version;
+        return ToLeaf(tree_page);
+      }
+      page_id = (key == nullptr) ? ToInternal(tree_page)->ValueAt(0) : ToInternal(tree_page)->Lookup(*key, comparator_);
+      if (!page->ValidateVersion(page_version)) {
+        release(page);
+        break;
+      }
+      if (path != nullptr) {
+        path->push_back(page->GetPageId());
+      }
+      parent = page;
+      parent_version = page_version;
+    }
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::OptimisticSearchBefore(const KeyType *key, bool inclusive, uint64_t *version,
+                                            std::optional<KeyType> *low) -> LeafPage * {
+  Page *root_id_page = root_page_id_page_.get();
+  const auto release = [this, root_id_page](Page *page) {
+    if (page != root_id_page) {
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    }
+  };
+  while (true) {
+    low->reset();
+    auto parent = root_id_page;
+    auto parent_version = parent->ReadVersion();
+    page_id_t page_id = root_page_id_;
+    if (page_id == INVALID_PAGE_ID) {
+      if (parent->ValidateVersion(parent_version)) {
+        return nullptr;
+      }
+      continue;
+    }
+    while (true) {
+      // Coupled like in OptimisticSearch().
+      auto page = buffer_pool_manager_->FetchPage(page_id);
+      auto page_version = page->ReadVersion();
+      const auto valid = parent->ValidateVersion(parent_version);
+      release(parent);
+      if (!valid) {
+        release(page);
+        break;
+      }
+      auto tree_page = ToTreePage(page);
+      const auto is_leaf = tree_page->IsLeafPage();
+      const auto next_page_id = is_leaf ? ToLeaf(tree_page)->GetNextPageId() : ToInternal(tree_page)->GetNextPageId();
+      const auto high_key = is_leaf ? ToLeaf(tree_page)->GetHighKey() : ToInternal(tree_page)->GetHighKey();
+      // The keys of the next page are not less than the high key, some are before key if it is greater.
+      const auto cmp = (key == nullptr || next_page_id == INVALID_PAGE_ID) ? 1 : comparator_(*key, high_key);
+      if (next_page_id != INVALID_PAGE_ID && (cmp > 0 || (inclusive && cmp == 0))) {
+        if (!page->ValidateVersion(page_version)) {
+          release(page);
+          break;
+        }
+        *low = high_key;
+        parent = page;
+        parent_version = page_version;
+        page_id = next_page_id;
+        continue;
+      }
+      if (is_leaf) {
+        *version = page_version;
+        return ToLeaf(tree_page);
+      }
+      auto internal = ToInternal(tree_page);
+      const auto i = key == nullptr ? internal->GetSize() - 1 : internal->ChildIndex(*key, comparator_, inclusive);
+      const auto child_low = i > 0 ? std::make_optional(internal->KeyAt(i)) : std::nullopt;
+      page_id = internal->ValueAt(i);
+      if (!page->ValidateVersion(page_version)) {
+        release(page);
+        break;
+      }
+      if (child_low.has_value()) {
+        *low = child_low;
+      }
+      parent = page;
+      parent_version = page_version;
+    }
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::OptimisticLatchLeaf(const KeyType &key, SearchMode mode, Transaction *transaction)
+    -> LeafPage * {
   const auto is_safe_predicate = (mode == SearchMode::Insert)
       ? [](BPlusTreePage *tree_page, int cur_size_for_insert, int cur_size_for_delete) -> bool {
     return cur_size_for_insert < tree_page->GetMaxSize();
@@ -585,42 +1082,220 @@ auto BPLUSTREE_TYPE::OptimisticSearch(const KeyType &key, SearchMode mode, bustu
              (cur_size_for_delete > ((tree_page->IsLeafPage() ? tree_page->GetMaxSize() - 1 : tree_page->GetMaxSize()) -
                                      tree_page->GetMinSize() + 1));
     };
-  const auto smart_latch = [this, transaction](BPlusTreePage *tree_page) {
-    tree_page->IsLeafPage() ? ToRawPage(tree_page)->WLatch() : ToRawPage(tree_page)->RLatch();
+  while (true) {
+    uint64_t version;
+    auto leaf = OptimisticSearch(&key, &version);
+    if (leaf == nullptr) {
+      return nullptr;
+    }
+    auto page = ToRawPage(leaf);
+    page->WLatch();
+    // Latching bumped the version once: any other change means the leaf may no longer be the one for the key.
+    if (!page->ValidateVersion(version + 1)) {
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
+      continue;
+    }
+    if (!is_safe_predicate(leaf, leaf->GetSize() + 1, leaf->GetSize())) {
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
+      return nullptr;
+    }
     if (transaction != nullptr) {
-      transaction->AddIntoPageSet(ToRawPage(tree_page));
+      transaction->AddIntoPageSet(page);
     }
-  };
-  auto root_id_page = UsePage(INVALID_PAGE_ID, use_mode, transaction);
-  auto root_id = root_page_id_;
-  success = true;
-  if (root_page_id_ == INVALID_PAGE_ID) {
-    DisusePage(root_id_page, use_mode);
-    success = false;
+    return leaf;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RightLinkFor(BPlusTreePage *tree_page, const KeyType &key) -> page_id_t {
+  if (tree_page->IsLeafPage()) {
+    auto leaf = ToLeaf(tree_page);
+    auto next_page_id = leaf->GetNextPageId();
+    return (next_page_id != INVALID_PAGE_ID && comparator_(key, leaf->GetHighKey()) >= 0) ? next_page_id
+                                                                                          : INVALID_PAGE_ID;
+  }
+  auto internal = ToInternal(tree_page);
+  auto next_page_id = internal->GetNextPageId();
+  return (next_page_id != INVALID_PAGE_ID && comparator_(key, internal->GetHighKey()) >= 0) ? next_page_id
+                                                                                            : INVALID_PAGE_ID;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::MoveRight(BPlusTreePage *tree_page, const KeyType &key) -> BPlusTreePage * {
+  for (auto right_id = RightLinkFor(tree_page, key); right_id != INVALID_PAGE_ID;
+       right_id = RightLinkFor(tree_page, key)) {
+    auto right_page = UsePage(right_id, UseMode::Write, nullptr);
+    ToRawPage(tree_page)->WUnlatch();
+    buffer_pool_manager_->UnpinPage(tree_page->GetPageId(), false);
+    tree_page = ToTreePage(right_page);
+  }
+  return tree_page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
+  page_id_t new_page_id;
+  auto new_page = buffer_pool_manager_->NewPage(&new_page_id);
+  auto leaf = ToLeaf(ToTreePage(new_page));
+  leaf->Init(new_page_id, INVALID_PAGE_ID, leaf_max_size_, key_format_);
+  leaf->SetPageType(IndexPageType::LEAF_PAGE);
+  leaf->Insert(key, value, comparator_);
+  buffer_pool_manager_->UnpinPage(new_page_id, true);
+  root_page_id_ = new_page_id;
+  UpdateRootPageId(new_page_id);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::SplitLeaf(LeafPage *leaf, const KeyType &key, const ValueType &value) -> LeafPage * {
+  // A compressed leaf may have no room left for a key that does not compress, so the pairs are shared out of the page.
+  auto pairs = leaf->ExtractAll();
+  pairs.insert(std::upper_bound(
+                   pairs.cbegin(), pairs.cend(), key,
+                   [this](const KeyType &key, const auto &pair) { return comparator_(key, pair.first) < 0; }),
+               std::make_pair(key, value));
+  const auto right_first = pairs.cbegin() + pairs.size() / 2;
+  page_id_t new_page_id;
+  auto new_leaf = ToLeaf(ToTreePage(buffer_pool_manager_->NewPage(&new_page_id)));
+  new_leaf->Init(new_page_id, INVALID_PAGE_ID, leaf_max_size_, key_format_);
+  new_leaf->SetPageType(IndexPageType::LEAF_PAGE);
+  new_leaf->SetNextPageId(leaf->GetNextPageId());
+  new_leaf->SetHighKey(leaf->GetHighKey());
+  new_leaf->EmplaceBack({right_first, pairs.cend()});
+  leaf->EmplaceBack({pairs.cbegin(), right_first});
+  leaf->SetNextPageId(new_page_id);
+  leaf->SetHighKey(key_format_ == IndexKeyFormat::COMPRESSED ? comparator_.Separator((right_first - 1)->first,
+                                                                                    right_first->first)
+                                                             : right_first->first);
+  return new_leaf;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::SplitInternal(InternalPage *page, const std::vector<std::pair<KeyType, page_id_t>> &pairs)
+    -> InternalPage * {
+  auto right_first_index = pairs.size() / 2;
+  std::vector<std::pair<KeyType, page_id_t>> left_pairs{pairs.cbegin(), pairs.cbegin() + right_first_index};
+  std::vector<std::pair<KeyType, page_id_t>> right_pairs{pairs.cbegin() + right_first_index, pairs.cend()};
+  page_id_t new_page_id;
+  auto new_internal = ToInternal(ToTreePage(buffer_pool_manager_->NewPage(&new_page_id)));
+  new_internal->Init(new_page_id, INVALID_PAGE_ID, internal_max_size_, key_format_);
+  new_internal->SetPageType(IndexPageType::INTERNAL_PAGE);
+  new_internal->SetNextPageId(page->GetNextPageId());
+  new_internal->SetHighKey(page->GetHighKey());
+  new_internal->EmplaceBack(right_pairs);
+  page->SetSize(0);
+  page->EmplaceBack(left_pairs);
+  page->SetNextPageId(new_page_id);
+  page->SetHighKey(right_pairs.front().first);
+  return new_internal;
+}
+
+/*****************************************************************************
+ * B-LINK MODE
+ *****************************************************************************/
+/*
+ * In B-link mode pages are never merged or deleted, and their key ranges only
+ * shrink from the right, when they split. A page that held the key when it
+ * was read therefore still holds it, or one of the pages to its right does.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::BLinkLatchLeaf(const KeyType &key, std::vector<page_id_t> *path) -> LeafPage * {
+  uint64_t version;
+  auto leaf = OptimisticSearch(&key, &version, path);
+  if (leaf == nullptr) {
     return nullptr;
   }
-  auto tree_page = ToTreePage(buffer_pool_manager_->FetchPage(root_id));
-  smart_latch(tree_page);
-  DisusePage(root_id_page, use_mode);
-  while (!tree_page->IsLeafPage()) {
-    const auto size = ToInternal(tree_page)->GetSize();
-    page_id_t next_page_id = ToInternal(tree_page)->ValueAt(0);
-    for (int i = 0; i < size; ++i) {
-      if ((i == (size - 1)) || (comparator_(ToInternal(tree_page)->KeyAt(i + 1), key) > 0)) {
-        next_page_id = ToInternal(tree_page)->ValueAt(i);
-        break;
-      }
+  ToRawPage(leaf)->WLatch();
+  return ToLeaf(MoveRight(leaf, key));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::BLinkInsert(const KeyType &key, const ValueType &value) -> bool {
+  std::vector<page_id_t> path;
+  auto leaf = BLinkLatchLeaf(key, &path);
+  while (leaf == nullptr) {
+    auto root_id_page = UsePage(INVALID_PAGE_ID, UseMode::Write, nullptr);
+    if (root_page_id_ == INVALID_PAGE_ID) {
+      StartNewTree(key, value);
+      DisusePage(root_id_page, UseMode::Write);
+      return true;
     }
-    auto next_page = ToTreePage(buffer_pool_manager_->FetchPage(next_page_id));
-    smart_latch(next_page);
-    ToRawPage(tree_page)->RUnlatch();
-    buffer_pool_manager_->UnpinPage(tree_page->GetPageId(), false);
-    tree_page = next_page;
+    DisusePage(root_id_page, UseMode::Write);
+    leaf = BLinkLatchLeaf(key, &path);
   }
-  if (mode != SearchMode::Find && !is_safe_predicate(tree_page, tree_page->GetSize() + 1, tree_page->GetSize())) {
-    success = false;
+  if (leaf->Contain(key, comparator_)) {
+    ToRawPage(leaf)->WUnlatch();
+    buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
+    return false;
+  }
+  if (leaf->CanInsert(key)) {
+    leaf->Insert(key, value, comparator_);
+    DisusePage(ToRawPage(leaf), UseMode::Write);
+    return true;
+  }
+  // Split, and release the leaf before going up: until the parent knows the new leaf, it is reached through the
+  // right link of the old one.
+  auto new_leaf = SplitLeaf(leaf, key, value);
+  const auto left_id = leaf->GetPageId();
+  const auto right_id = new_leaf->GetPageId();
+  const auto separator = leaf->GetHighKey();
+  buffer_pool_manager_->UnpinPage(right_id, true);
+  DisusePage(ToRawPage(leaf), UseMode::Write);
+  BLinkInsertInParent(&path, 0, left_id, separator, right_id);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::BLinkInsertInParent(std::vector<page_id_t> *path, int level, page_id_t left_id, KeyType key,
+                                         page_id_t right_id) {
+  while (true) {
+    if (path->empty()) {
+      // The split page was the root when the search went down.
+      auto root_id_page = UsePage(INVALID_PAGE_ID, UseMode::Write, nullptr);
+      if (root_page_id_ == left_id) {
+        page_id_t new_root_id;
+        auto new_root = ToInternal(ToTreePage(buffer_pool_manager_->NewPage(&new_root_id)));
+        new_root->Init(new_root_id, INVALID_PAGE_ID, internal_max_size_, key_format_);
+        new_root->Put(left_id, key, right_id);
+        buffer_pool_manager_->UnpinPage(new_root_id, true);
+        root_page_id_ = new_root_id;
+        UpdateRootPageId(new_root_id);
+        DisusePage(root_id_page, UseMode::Write);
+        return;
+      }
+      DisusePage(root_id_page, UseMode::Write);
+      // Another split made a new root since: search again for the pages above the level of the split page. The
+      // tree never shrinks, so levels stay where they are. A root split that is not published yet leaves no page
+      // above that level, so wait for it and check the root again.
+      uint64_t version;
+      auto leaf = OptimisticSearch(&key, &version, path);
+      buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
+      if (path->size() <= static_cast<size_t>(level)) {
+        path->clear();
+        std::this_thread::yield();
+        continue;
+      }
+      path->resize(path->size() - level);
+    }
+    auto parent = ToInternal(MoveRight(ToTreePage(UsePage(path->back(), UseMode::Write, nullptr)), key));
+    path->pop_back();
+    if (parent->CanInsert(key)) {
+      parent->Insert(key, right_id, comparator_);
+      DisusePage(ToRawPage(parent), UseMode::Write);
+      return;
+    }
+    auto pairs = parent->ExtractAll();
+    auto key_less = [this](const KeyType &key, const auto &pair) { return comparator_(key, pair.first) < 0; };
+    pairs.insert(std::upper_bound(pairs.cbegin() + 1, pairs.cend(), key, key_less), std::make_pair(key, right_id));
+    auto new_internal = SplitInternal(parent, pairs);
+    left_id = parent->GetPageId();
+    right_id = new_internal->GetPageId();
+    key = new_internal->KeyAt(0);
+    buffer_pool_manager_->UnpinPage(right_id, true);
+    DisusePage(ToRawPage(parent), UseMode::Write);
+    level++;
   }
-  return static_cast<LeafPage *>(tree_page);
 }
 
 /*
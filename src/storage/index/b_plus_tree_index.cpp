@@ -11,41 +11,207 @@
 
 #include "storage/index/b_plus_tree_index.h"
 
+#include "storage/index/external_sorter.h"
+#include "type/value_factory.h"
+
 namespace bustub {
+
+namespace {
+
+/** @return the key schema, followed by a BIGINT column for the RID if the index is not unique */
+auto MakeTreeKeySchema(const IndexMetadata &metadata) -> Schema {
+  auto columns = metadata.GetKeySchema()->GetColumns();
+  if (!metadata.IsUnique()) {
+    columns.emplace_back("__rid", TypeId::BIGINT);
+  }
+  return Schema(columns);
+}
+
+}  // namespace
+
 /*
  * Constructor
  */
 INDEX_TEMPLATE_ARGUMENTS
-BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager)
+BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager,
+                                     IndexKeyFormat key_format, bool b_link)
     : Index(std::move(metadata)),
-      comparator_(GetMetadata()->GetKeySchema()),
-      container_(GetMetadata()->GetName(), buffer_pool_manager, comparator_) {}
+      tree_key_schema_(MakeTreeKeySchema(*GetMetadata())),
+      comparator_(&tree_key_schema_),
+      key_comparator_(GetMetadata()->GetKeySchema()),
+      container_(GetMetadata()->GetName(), buffer_pool_manager, comparator_,
+                 key_format == IndexKeyFormat::COMPRESSED
+                     ? BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>::COMPRESSED_MAX_SIZE
+                     : LEAF_PAGE_SIZE,
+                 key_format == IndexKeyFormat::COMPRESSED
+                     ? BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>::COMPRESSED_MAX_SIZE
+                     : INTERNAL_PAGE_SIZE,
+                 b_link || key_format == IndexKeyFormat::COMPRESSED, key_format),
+      first_column_schema_(Schema::CopySchema(GetMetadata()->GetKeySchema(), {0})),
+      first_column_comparator_(&first_column_schema_) {}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::TreeKey(const Tuple &key, const RID *rid) const -> KeyType {
+  KeyType tree_key;
+  if (IsUnique()) {
+    tree_key.SetFromKey(key);
+    return tree_key;
+  }
+  const auto *key_schema = GetKeySchema();
+  std::vector<Value> values;
+  values.reserve(tree_key_schema_.GetColumnCount());
+  for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+    values.push_back(key.GetValue(key_schema, i));
+  }
+  // Page ids are not negative, RIDs order like their 64-bit encoding.
+  values.push_back(rid == nullptr ? ValueFactory::GetNullValueByType(TypeId::BIGINT)
+                                 : ValueFactory::GetBigIntValue(rid->Get()));
+  tree_key.SetFromKey(Tuple(values, &tree_key_schema_));
+  return tree_key;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
   // construct insert index key
-  KeyType index_key;
-  index_key.SetFromKey(key);
+  container_.Insert(TreeKey(key, &rid), rid, transaction);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::BulkLoad(const std::function<bool(Tuple *, RID *)> &next, Transaction *transaction,
+                                    double fill_factor) {
+  // Ties are broken by RID, so that the first entry of every key is the one to keep.
+  auto less = [this](const MappingType &a, const MappingType &b) {
+    auto cmp = comparator_(a.first, b.first);
+    return cmp < 0 || (cmp == 0 && a.second.Get() < b.second.Get());
+  };
+  ExternalSorter<MappingType, decltype(less)> sorter(less, INDEX_BUILD_SORT_MEMORY);
+  Tuple key;
+  RID rid;
+  while (next(&key, &rid)) {
+    sorter.Add({TreeKey(key, &rid), rid});
+  }
+  sorter.Sort();
 
-  container_.Insert(index_key, rid, transaction);
+  bool has_last = false;
+  KeyType last_key;
+  container_.BulkLoad(
+      [&](MappingType *pair) {
+        while (sorter.Next(pair)) {
+          if (!has_last || comparator_(last_key, pair->first) != 0) {
+            has_last = true;
+            last_key = pair->first;
+            return true;
+          }
+        }
+        return false;
+      },
+      fill_factor, transaction);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
   // construct delete index key
-  KeyType index_key;
-  index_key.SetFromKey(key);
-
-  container_.Remove(index_key, transaction);
+  container_.Remove(TreeKey(key, &rid), transaction);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
   // construct scan index key
-  KeyType index_key;
-  index_key.SetFromKey(key);
+  auto index_key = TreeKey(key, nullptr);
+  if (IsUnique()) {
+    container_.GetValue(index_key, result, transaction);
+    return;
+  }
+  for (auto iterator = container_.Begin(index_key);
+       !iterator.IsEnd() && key_comparator_((*iterator).first, index_key) == 0; ++iterator) {
+    result->push_back((*iterator).second);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                                    Transaction *transaction) {
+  std::vector<KeyType> index_keys;
+  index_keys.reserve(keys.size());
+  for (const auto &key : keys) {
+    index_keys.push_back(TreeKey(key, nullptr));
+  }
+  if (IsUnique()) {
+    container_.GetValues(index_keys, results, transaction);
+    return;
+  }
+  // The NULL RID sorts before every entry of a key, which are all looked up like in ScanKey().
+  container_.GetValues(index_keys, results, transaction, [this](const KeyType &entry_key, const KeyType &index_key) {
+    return key_comparator_(entry_key, index_key) == 0;
+  });
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::BoundKey(const Value &value) const -> KeyType {
+  // NULL sorts before any value, the key is not greater than any key whose first column is value.
+  std::vector<Value> values;
+  values.reserve(tree_key_schema_.GetColumnCount());
+  for (const auto &column : tree_key_schema_.GetColumns()) {
+    values.push_back(ValueFactory::GetNullValueByType(column.GetType()));
+  }
+  values[0] = value.CastAs(tree_key_schema_.GetColumn(0).GetType());
+  KeyType key;
+  key.SetFromKey(Tuple(values, &tree_key_schema_));
+  return key;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::Scan(const IndexRange &range, Transaction *transaction) -> std::unique_ptr<IndexCursor> {
+  using Cursor = BPlusTreeIndexCursor<KeyType, ValueType, KeyComparator>;
+  if (range.IsFull()) {
+    return std::make_unique<Cursor>(container_.Begin());
+  }
+  const auto lower = range.lower_.has_value() ? std::make_optional(BoundKey(*range.lower_)) : std::nullopt;
+  const auto upper = range.upper_.has_value() ? std::make_optional(BoundKey(*range.upper_)) : std::nullopt;
+  // Unset for a missing bound.
+  std::function<bool(const KeyType &)> above_lower;
+  std::function<bool(const KeyType &)> below_upper;
+  if (lower.has_value()) {
+    above_lower = [this, lower, inclusive = range.lower_inclusive_](const KeyType &key) {
+      const auto cmp = first_column_comparator_(key, *lower);
+      return cmp > 0 || (cmp == 0 && inclusive);
+    };
+  }
+  if (upper.has_value()) {
+    below_upper = [this, upper, inclusive = range.upper_inclusive_](const KeyType &key) {
+      const auto cmp = first_column_comparator_(key, *upper);
+      return cmp < 0 || (cmp == 0 && inclusive);
+    };
+  }
+
+  if (!range.reverse_) {
+    // The iterator starts on the first key whose first column is the lower bound, skip them if it is exclusive.
+    auto iterator = lower.has_value() ? container_.Begin(*lower) : container_.Begin();
+    while (lower.has_value() && !iterator.IsEnd() && !above_lower((*iterator).first)) {
+      ++iterator;
+    }
+    return std::make_unique<Cursor>(std::move(iterator), below_upper);
+  }
 
-  container_.GetValue(index_key, result, transaction);
+  auto iterator = container_.RBegin();
+  if (upper.has_value()) {
+    if (tree_key_schema_.GetColumnCount() == 1) {
+      iterator = container_.RBegin(*upper);
+    } else {
+      // Keys whose first column is the upper bound sort after the bound key, start from the first key past them.
+      auto past_upper = container_.Begin(*upper);
+      while (!past_upper.IsEnd() && first_column_comparator_((*past_upper).first, *upper) == 0) {
+        ++past_upper;
+      }
+      if (!past_upper.IsEnd()) {
+        iterator = container_.RBegin((*past_upper).first);
+      }
+    }
+    while (!iterator.IsEnd() && !below_upper((*iterator).first)) {
+      ++iterator;
+    }
+  }
+  return std::make_unique<Cursor>(std::move(iterator), above_lower);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -14,7 +14,24 @@ namespace bustub {
  */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::IndexIterator(page_id_t begin_page_id, int begin_index, BufferPoolManager *buffer_pool_manager)
-    : page_id_(begin_page_id), index_(begin_index), buffer_pool_manager_(buffer_pool_manager) {}
+    : page_id_(begin_page_id),
+      index_(begin_index),
+      buffer_pool_manager_(buffer_pool_manager),
+      read_ahead_(buffer_pool_manager,
+                  [](Page *page) { return reinterpret_cast<LeafPage *>(page->GetData())->GetNextPageId(); }) {
+  read_ahead_.Advance(page_id_);
+  SkipExhaustedLeaves();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::IndexIterator(page_id_t begin_page_id, int begin_index, BufferPoolManager *buffer_pool_manager,
+                                  PositionBefore position_before)
+    : page_id_(begin_page_id),
+      index_(begin_index),
+      buffer_pool_manager_(buffer_pool_manager),
+      position_before_(std::move(position_before)),
+      // There is no chain to read ahead along in reverse.
+      read_ahead_(buffer_pool_manager, nullptr, 0) {}
 
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::~IndexIterator() = default;  // NOLINT
@@ -32,19 +49,42 @@ auto INDEXITERATOR_TYPE::operator*() -> const MappingType & {
 }
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
-  auto page = reinterpret_cast<LeafPage *>(buffer_pool_manager_->FetchPage(page_id_));
-  if ((index_ + 1) < page->GetSize()) {
-    ++index_;
-  } else if (page->GetNextPageId() != INVALID_PAGE_ID) {
-    page_id_ = page->GetNextPageId();
-    index_ = 0;
-  } else {
-    page_id_ = INVALID_PAGE_ID;
-    index_ = 0;
+  if (position_before_) {
+    if (index_ > 0) {
+      --index_;
+      return *this;
+    }
+    // The entry before the first one of a leaf is in some leaf before it, look it up by key.
+    auto page = reinterpret_cast<LeafPage *>(buffer_pool_manager_->FetchPage(page_id_));
+    const auto key = page->KeyAt(index_);
+    buffer_pool_manager_->UnpinPage(page_id_, false);
+    std::tie(page_id_, index_) = position_before_(key);
+    if (page_id_ == INVALID_PAGE_ID) {
+      index_ = 0;
+    }
+    return *this;
   }
-  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  ++index_;
+  SkipExhaustedLeaves();
   return *this;
 }
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::SkipExhaustedLeaves() {
+  // Leaves emptied in a B-link tree stay in the chain, there may be several in a row.
+  while (page_id_ != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<LeafPage *>(buffer_pool_manager_->FetchPage(page_id_));
+    const auto size = page->GetSize();
+    const auto next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id_, false);
+    if (index_ < size) {
+      return;
+    }
+    page_id_ = next_page_id;
+    index_ = 0;
+    read_ahead_.Advance(page_id_);
+  }
+}
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::operator!=(const IndexIterator<KeyType, ValueType, KeyComparator> &itr) const -> bool {
   return (page_id_ != itr.page_id_) || (index_ != itr.index_);
@@ -13,6 +13,7 @@
 
 #include "common/logger.h"
 #include "storage/page/b_plus_tree_internal_page.h"
+#include "storage/page/b_plus_tree_key_search.h"
 
 namespace bustub {
 /*****************************************************************************
@@ -26,13 +27,29 @@ namespace bustub {
  * [IMPLEMENTATION] Status: DONE
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size,
+                                          IndexKeyFormat key_format) {
+  static_assert(sizeof(CompressedPairs) <= sizeof(array_));
+  SetKeyFormat(key_format);
   SetPageType(IndexPageType::INTERNAL_PAGE);
   SetMaxSize(max_size);
   SetPageId(page_id);
   SetParentPageId(parent_id);
   SetSize(0);
+  SetNextPageId(INVALID_PAGE_ID);
 }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetHighKey() const -> const KeyType & { return high_key_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetHighKey(const KeyType &high_key) { high_key_ = high_key; }
 /*
  * Helper method to get/set the key associated with input "index"(a.k.a
  * array offset)
@@ -40,10 +57,18 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id
  * [IMPLEMENTATION] Status: DONE
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType { return array_[index].first; }
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType {
+  return IsCompressed() ? Compressed()->KeyAt(index) : array_[index].first;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) { array_[index].first = key; }
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {
+  if (IsCompressed()) {
+    Recode([&](auto *pairs) { (*pairs)[index].first = key; });
+    return;
+  }
+  array_[index].first = key;
+}
 
 /*
  * Helper method to get the value associated with input "index"(a.k.a array
@@ -52,7 +77,25 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) { a
  * [IMPLEMENTATION] Status: DONE
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { return array_[index].second; }
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType {
+  return IsCompressed() ? Compressed()->ValueAt(index) : array_[index].second;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator) const -> ValueType {
+  return ValueAt(ChildIndex(key, comparator));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ChildIndex(const KeyType &key, const KeyComparator &comparator,
+                                                bool inclusive) const -> int {
+  // The first key is invalid, the child to follow is the one before the first key greater than key, or not less than
+  // key if it is not inclusive.
+  if (IsCompressed()) {
+    return Compressed()->Search(1, GetSize(), key, comparator, inclusive) - 1;
+  }
+  return KeySearch(array_, 1, GetSize(), key, comparator, inclusive) - 1;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Adjacent(const ValueType &value) -> ValueType {
@@ -61,8 +104,8 @@ auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Adjacent(const ValueType &value) -> ValueTy
   BUSTUB_ASSERT(size > 1, "B_PLUS_TREE_INTERNAL_PAGE_TYPE::Adjacent - Unexpected case.");
   ValueType res = INVALID_PAGE_ID;
   for (int i = 0; i < size; ++i) {
-    if (value == array_[i].second) {
-      res = (i == (size - 1)) ? array_[i - 1].second : array_[i + 1].second;
+    if (value == ValueAt(i)) {
+      res = (i == (size - 1)) ? ValueAt(i - 1) : ValueAt(i + 1);
       break;
     }
   }
@@ -74,12 +117,12 @@ INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::IsPredecessor(const ValueType &v, const ValueType &v_other) -> bool {
   const auto size = GetSize();
   for (int i = 0; i < size; ++i) {
-    if (array_[i].second == v) {
-      BUSTUB_ASSERT(array_[i + 1].second == v_other, "unexpected case");
+    if (ValueAt(i) == v) {
+      BUSTUB_ASSERT(ValueAt(i + 1) == v_other, "unexpected case");
       return false;
     }
-    if (array_[i].second == v_other) {
-      BUSTUB_ASSERT(array_[i + 1].second == v, "unexpected case");
+    if (ValueAt(i) == v_other) {
+      BUSTUB_ASSERT(ValueAt(i + 1) == v, "unexpected case");
       return true;
     }
   }
@@ -92,11 +135,11 @@ auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::BetweenKeyIndex(const ValueType &va, const
   const auto size = GetSize();
   int i;
   for (i = 0; i < size; ++i) {
-    if (array_[i].second == va || array_[i].second == vb) {
+    if (ValueAt(i) == va || ValueAt(i) == vb) {
       break;
     }
   }
-  BUSTUB_ASSERT(array_[i + 1].second == vb || array_[i + 1].second == va,
+  BUSTUB_ASSERT(ValueAt(i + 1) == vb || ValueAt(i + 1) == va,
                 "B_PLUS_TREE_INTERNAL_PAGE_TYPE::BetweenKeyIndex - Unexpected case.");
   return i + 1;
 }
@@ -114,11 +157,15 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertAfter(const ValueType &value, const K
   auto index = 0;
   const auto size = this->GetSize();
   for (; index < size; ++index) {
-    if (array_[index].second == value) {
+    if (ValueAt(index) == value) {
       ++index;
       break;
     }
   }
+  if (IsCompressed()) {
+    Recode([&](auto *pairs) { pairs->insert(pairs->begin() + index, std::make_pair(new_key, new_value)); });
+    return;
+  }
   for (auto move_index = size; move_index > index; --move_index) {
     array_[move_index] = std::move(array_[move_index - 1]);
   }
@@ -126,8 +173,34 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertAfter(const ValueType &value, const K
   IncreaseSize(1);
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::CanInsert(const KeyType &key) const -> bool {
+  return GetSize() < GetMaxSize() && (!IsCompressed() || Compressed()->Fits(GetSize(), key));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value,
+                                            const KeyComparator &comparator) {
+  const auto size = GetSize();
+  if (IsCompressed()) {
+    Compressed()->Insert(Compressed()->Search(1, size, key, comparator, true), size, std::make_pair(key, value));
+    IncreaseSize(1);
+    return;
+  }
+  const auto index = KeySearch(array_, 1, size, key, comparator, true);
+  for (auto move_index = size; move_index > index; --move_index) {
+    array_[move_index] = array_[move_index - 1];
+  }
+  array_[index] = std::make_pair(key, value);
+  IncreaseSize(1);
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::PushBack(const KeyType &key, const ValueType &value) {
+  if (IsCompressed()) {
+    Recode([&](auto *pairs) { pairs->emplace_back(key, value); });
+    return;
+  }
   auto index = GetSize();
   array_[index].first = key;
   array_[index].second = value;
@@ -136,6 +209,11 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::PushBack(const KeyType &key, const ValueTyp
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::PushFront(const ValueType &value) {
+  if (IsCompressed()) {
+    // The first key is invalid, take the one that follows so that it widens no pair.
+    Recode([&](auto *pairs) { pairs->insert(pairs->begin(), std::make_pair(pairs->front().first, value)); });
+    return;
+  }
   for (int index = GetSize(); index > 0; --index) {
     array_[index] = array_[index - 1];
   }
@@ -145,6 +223,10 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::PushFront(const ValueType &value) {
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::EmplaceBack(const std::vector<std::pair<KeyType, ValueType>> &pairs) {
+  if (IsCompressed()) {
+    Recode([&](auto *all_pairs) { all_pairs->insert(all_pairs->end(), pairs.begin(), pairs.end()); });
+    return;
+  }
   const auto pairs_size = static_cast<int>(pairs.size());
   const auto array_size = GetSize();
   for (int i = 0; i < pairs_size; ++i) {
@@ -155,6 +237,13 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::EmplaceBack(const std::vector<std::pair<Key
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Put(const ValueType &left, const KeyType &key, const ValueType &right) {
+  if (IsCompressed()) {
+    // The first key is invalid, repeat the separator there so that it widens no pair.
+    const MappingType pairs[] = {{key, left}, {key, right}};
+    Compressed()->Encode(pairs, 2);
+    SetSize(2);
+    return;
+  }
   array_[0].second = left;
   array_[1].first = key;
   array_[1].second = right;
@@ -168,13 +257,15 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Put(const ValueType &left, const KeyType &k
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Remove(const KeyType &key, const KeyComparator &comparator) {
   const auto size = GetSize();
-  auto i = 1;
-  for (; i < size; ++i) {
-    if (comparator(key, array_[i].first) == 0) {
-      break;
-    }
+  auto i =
+      IsCompressed() ? Compressed()->Search(1, size, key, comparator) : KeySearch(array_, 1, size, key, comparator);
+  BUSTUB_ASSERT(i != size && comparator(key, KeyAt(i)) == 0,
+                "B_PLUS_TREE_INTERNAL_PAGE_TYPE::Remove - i should not be identical with size");
+  if (IsCompressed()) {
+    Compressed()->Remove(i, size);
+    SetSize(size - 1);
+    return;
   }
-  BUSTUB_ASSERT(i != size, "B_PLUS_TREE_INTERNAL_PAGE_TYPE::Remove - i should not be identical with size");
   for (; i < (size - 1); ++i) {
     array_[i] = array_[i + 1];
   }
@@ -183,6 +274,11 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Remove(const KeyType &key, const KeyCompara
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ExtractHalf() -> std::vector<std::pair<KeyType, ValueType>> {
+  if (IsCompressed()) {
+    auto pairs = ExtractAll();
+    EmplaceBack({pairs.begin(), pairs.begin() + GetMinSize()});
+    return {pairs.begin() + GetMinSize(), pairs.end()};
+  }
   auto size = GetSize();
   auto res = std::vector<MappingType>{};
   res.reserve(size - GetMinSize());
@@ -196,8 +292,12 @@ auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ExtractHalf() -> std::vector<std::pair<KeyT
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ExtractAll() -> std::vector<std::pair<KeyType, ValueType>> {
   BUSTUB_ASSERT(GetSize() != 0, "B_PLUS_TREE_INTERNAL_PAGE_TYPE::ExtractAll() - Unexpected case");
-  auto res = std::vector<MappingType>{};
   auto size = GetSize();
+  if (IsCompressed()) {
+    SetSize(0);
+    return Compressed()->Decode(size);
+  }
+  auto res = std::vector<MappingType>{};
   for (int i = 0; i < size; ++i) {
     res.emplace_back(array_[i]);
   }
@@ -207,15 +307,20 @@ auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ExtractAll() -> std::vector<std::pair<KeyTy
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::PopBack() -> std::pair<KeyType, ValueType> {
-  auto res = array_[GetSize() - 1];
+  auto res = std::make_pair(KeyAt(GetSize() - 1), ValueAt(GetSize() - 1));
   SetSize(GetSize() - 1);
   return std::move(res);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::PopFront() -> std::pair<KeyType, ValueType> {
-  auto res = array_[0];
+  auto res = std::make_pair(KeyAt(0), ValueAt(0));
   const auto size = GetSize();
+  if (IsCompressed()) {
+    Compressed()->Remove(0, size);
+    SetSize(size - 1);
+    return res;
+  }
   for (int i = 1; i < size; ++i) {
     array_[i - 1] = array_[i];
   }
@@ -227,6 +332,15 @@ auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::PopFront() -> std::pair<KeyType, ValueType>
  * Helper function family
  */
 
+INDEX_TEMPLATE_ARGUMENTS
+template <typename Change>
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Recode(Change change) {
+  auto pairs = Compressed()->Decode(GetSize());
+  change(&pairs);
+  Compressed()->Encode(pairs.data(), static_cast<int>(pairs.size()));
+  SetSize(static_cast<int>(pairs.size()));
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyToString(const KeyType &key) const -> std::string {
   std::stringstream buf;
@@ -0,0 +1,174 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_key_search.cpp
+//
+// Identification: src/storage/page/b_plus_tree_key_search.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/b_plus_tree_key_search.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define BUSTUB_KEY_SEARCH_X86
+#endif
+
+namespace bustub {
+
+namespace {
+
+/** Below this many keys the binary search stops and the rest is counted with SIMD compares. */
+constexpr int SIMD_WINDOW = 32;
+
+template <typename T>
+inline auto LoadKey(const char *base, size_t stride, int i) -> T {
+  T key;
+  memcpy(&key, base + i * stride, sizeof(T));
+  return key;
+}
+
+template <typename T>
+inline auto IsBelow(T k, T key, bool or_equal) -> bool {
+  return or_equal ? k <= key : k < key;
+}
+
+template <typename T>
+auto CountScalar(const char *base, size_t stride, int n, T key, bool or_equal) -> int {
+  int count = 0;
+  for (int i = 0; i < n; ++i) {
+    count += static_cast<int>(IsBelow(LoadKey<T>(base, stride, i), key, or_equal));
+  }
+  return count;
+}
+
+#ifdef BUSTUB_KEY_SEARCH_X86
+
+/*
+ * The kernels compare a vector of keys against the search key. With or_equal
+ * they count the keys greater than it and return the complement, so only a
+ * signed greater-than is needed.
+ */
+
+__attribute__((target("avx2"))) auto CountAvx2(const char *base, size_t stride, int n, int32_t key, bool or_equal)
+    -> int {
+  const auto s = static_cast<int>(stride);
+  const auto offsets = _mm256_setr_epi32(0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s);
+  const auto needle = _mm256_set1_epi32(key);
+  int count = 0;
+  int i = 0;
+  for (; i + 8 <= n; i += 8) {
+    auto keys = _mm256_i32gather_epi32(reinterpret_cast<const int *>(base + i * stride), offsets, 1);
+    auto mask = or_equal ? _mm256_cmpgt_epi32(keys, needle) : _mm256_cmpgt_epi32(needle, keys);
+    auto bits = __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(mask)));
+    count += or_equal ? 8 - bits : bits;
+  }
+  return count + CountScalar(base + i * stride, stride, n - i, key, or_equal);
+}
+
+__attribute__((target("avx2"))) auto CountAvx2(const char *base, size_t stride, int n, int64_t key, bool or_equal)
+    -> int {
+  const auto s = static_cast<int>(stride);
+  const auto offsets = _mm_setr_epi32(0, s, 2 * s, 3 * s);
+  const auto needle = _mm256_set1_epi64x(key);
+  int count = 0;
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    auto keys = _mm256_i32gather_epi64(reinterpret_cast<const long long *>(base + i * stride),  // NOLINT
+                                       offsets, 1);
+    auto mask = or_equal ? _mm256_cmpgt_epi64(keys, needle) : _mm256_cmpgt_epi64(needle, keys);
+    auto bits = __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(mask)));
+    count += or_equal ? 4 - bits : bits;
+  }
+  return count + CountScalar(base + i * stride, stride, n - i, key, or_equal);
+}
+
+/** SSE2 is part of x86-64, no dispatch needed. */
+auto CountSse(const char *base, size_t stride, int n, int32_t key, bool or_equal) -> int {
+  const auto needle = _mm_set1_epi32(key);
+  int count = 0;
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    auto keys = _mm_setr_epi32(LoadKey<int32_t>(base, stride, i), LoadKey<int32_t>(base, stride, i + 1),
+                               LoadKey<int32_t>(base, stride, i + 2), LoadKey<int32_t>(base, stride, i + 3));
+    auto mask = or_equal ? _mm_cmpgt_epi32(keys, needle) : _mm_cmpgt_epi32(needle, keys);
+    auto bits = __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(mask)));
+    count += or_equal ? 4 - bits : bits;
+  }
+  return count + CountScalar(base + i * stride, stride, n - i, key, or_equal);
+}
+
+__attribute__((target("sse4.2"))) auto CountSse(const char *base, size_t stride, int n, int64_t key, bool or_equal)
+    -> int {
+  const auto needle = _mm_set1_epi64x(key);
+  int count = 0;
+  int i = 0;
+  for (; i + 2 <= n; i += 2) {
+    auto keys = _mm_set_epi64x(LoadKey<int64_t>(base, stride, i + 1), LoadKey<int64_t>(base, stride, i));
+    auto mask = or_equal ? _mm_cmpgt_epi64(keys, needle) : _mm_cmpgt_epi64(needle, keys);
+    auto bits = __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(mask)));
+    count += or_equal ? 2 - bits : bits;
+  }
+  return count + CountScalar(base + i * stride, stride, n - i, key, or_equal);
+}
+
+auto HasAvx2() -> bool {
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  return has_avx2;
+}
+
+auto HasSse42() -> bool {
+  static const bool has_sse42 = __builtin_cpu_supports("sse4.2");
+  return has_sse42;
+}
+
+auto CountWindow(const char *base, size_t stride, int n, int32_t key, bool or_equal) -> int {
+  return HasAvx2() ? CountAvx2(base, stride, n, key, or_equal) : CountSse(base, stride, n, key, or_equal);
+}
+
+auto CountWindow(const char *base, size_t stride, int n, int64_t key, bool or_equal) -> int {
+  if (HasAvx2()) {
+    return CountAvx2(base, stride, n, key, or_equal);
+  }
+  return HasSse42() ? CountSse(base, stride, n, key, or_equal) : CountScalar(base, stride, n, key, or_equal);
+}
+
+#else
+
+template <typename T>
+auto CountWindow(const char *base, size_t stride, int n, T key, bool or_equal) -> int {
+  return CountScalar(base, stride, n, key, or_equal);
+}
+
+#endif
+
+template <typename T>
+auto CountKeysBelowImpl(const char *base, size_t stride, int n, T key, bool or_equal) -> int {
+  // Every key before lo is below the search key, none from hi on is.
+  int lo = 0;
+  int hi = n;
+  while (hi - lo > SIMD_WINDOW) {
+    auto mid = lo + (hi - lo) / 2;
+    if (IsBelow(LoadKey<T>(base, stride, mid), key, or_equal)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo + CountWindow(base + lo * stride, stride, hi - lo, key, or_equal);
+}
+
+}  // namespace
+
+auto CountKeysBelow(const char *base, size_t stride, int n, int32_t key, bool or_equal) -> int {
+  return CountKeysBelowImpl(base, stride, n, key, or_equal);
+}
+
+auto CountKeysBelow(const char *base, size_t stride, int n, int64_t key, bool or_equal) -> int {
+  return CountKeysBelowImpl(base, stride, n, key, or_equal);
+}
+
+}  // namespace bustub
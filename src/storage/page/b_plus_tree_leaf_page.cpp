@@ -14,6 +14,7 @@
 #include "common/exception.h"
 #include "common/logger.h"
 #include "common/rid.h"
+#include "storage/page/b_plus_tree_key_search.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 
 namespace bustub {
@@ -30,13 +31,16 @@ namespace bustub {
  * [IMPEMENTATION] Status: DONE
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size,
+                                      IndexKeyFormat key_format) {
+  static_assert(sizeof(CompressedPairs) <= sizeof(array_));
   SetNextPageId(INVALID_PAGE_ID);
   SetPageType(IndexPageType::LEAF_PAGE);
   SetMaxSize(max_size);
   SetPageId(page_id);
   SetParentPageId(parent_id);
   SetSize(0);
+  SetKeyFormat(key_format);
 }
 
 /**
@@ -50,6 +54,12 @@ auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetNextPageId() const -> page_id_t { return nex
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
 
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetHighKey() const -> const KeyType & { return high_key_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetHighKey(const KeyType &high_key) { high_key_ = high_key; }
+
 /*
  * Helper method to find and return the key associated with input "index"(a.k.a
  * array offset)
@@ -57,24 +67,40 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_pa
  * [IMPLEMENTATION] Status: DONE
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const -> KeyType { return array_[index].first; }
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const -> KeyType {
+  return IsCompressed() ? Compressed()->KeyAt(index) : array_[index].first;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::ValueAt(int index) const -> ValueType { return array_[index].second; }
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::ValueAt(int index) const -> ValueType {
+  return IsCompressed() ? Compressed()->ValueAt(index) : array_[index].second;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int {
+  if (IsCompressed()) {
+    return Compressed()->Search(0, GetSize(), key, comparator);
+  }
+  return KeySearch(array_, 0, GetSize(), key, comparator);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::CanInsert(const KeyType &key) const -> bool {
+  return GetSize() + 1 < GetMaxSize() && (!IsCompressed() || Compressed()->Fits(GetSize(), key));
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator) {
   if (GetSize() == GetMaxSize()) {
     return;
   }
-  auto index = 0;
   auto size = this->GetSize();
-  for (; index < size; ++index) {
-    const auto &k = array_[index].first;
-    if (comparator(key, k) < 0) {
-      break;
-    }
+  if (IsCompressed()) {
+    Compressed()->Insert(Compressed()->Search(0, size, key, comparator, true), size, std::make_pair(key, value));
+    IncreaseSize(1);
+    return;
   }
+  auto index = KeySearch(array_, 0, size, key, comparator, true);
   for (auto move_index = size; move_index > index; --move_index) {
     array_[move_index] = array_[move_index - 1];
   }
@@ -86,13 +112,13 @@ INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::Remove(const KeyType &key, const KeyComparator &comparator) {
   const auto size = GetSize();
   BUSTUB_ASSERT(size != 0, "unexpected size");
-  auto i = 0;
-  for (; i < size; ++i) {
-    if (comparator(key, array_[i].first) == 0) {
-      break;
-    }
+  auto i = KeyIndex(key, comparator);
+  if (i == size || comparator(key, KeyAt(i)) != 0) {
+    return;
   }
-  if (i == size) {
+  if (IsCompressed()) {
+    Compressed()->Remove(i, size);
+    SetSize(size - 1);
     return;
   }
   for (; i < (size - 1); ++i) {
@@ -105,6 +131,13 @@ INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::EmplaceBack(const std::vector<std::pair<KeyType, ValueType>> &paris) {
   const auto pairs_size = static_cast<int>(paris.size());
   const auto array_size = GetSize();
+  if (IsCompressed()) {
+    auto pairs = Compressed()->Decode(array_size);
+    pairs.insert(pairs.end(), paris.begin(), paris.end());
+    Compressed()->Encode(pairs.data(), array_size + pairs_size);
+    IncreaseSize(pairs_size);
+    return;
+  }
   for (int i = 0; i < pairs_size; ++i) {
     array_[i + array_size] = paris[i];
   }
@@ -113,8 +146,12 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::EmplaceBack(const std::vector<std::pair<KeyType
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::ExtractAll() -> std::vector<std::pair<KeyType, ValueType>> {
-  auto res = std::vector<MappingType>{};
   auto size = GetSize();
+  if (IsCompressed()) {
+    SetSize(0);
+    return Compressed()->Decode(size);
+  }
+  auto res = std::vector<MappingType>{};
   for (int i = 0; i < size; ++i) {
     res.emplace_back(array_[i]);
   }
@@ -125,6 +162,11 @@ auto B_PLUS_TREE_LEAF_PAGE_TYPE::ExtractAll() -> std::vector<std::pair<KeyType,
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::ExtractHalf() -> std::vector<MappingType> {
   auto size = GetSize();
+  if (IsCompressed()) {
+    auto pairs = ExtractAll();
+    EmplaceBack({pairs.begin(), pairs.begin() + GetMinSize()});
+    return {pairs.begin() + GetMinSize(), pairs.end()};
+  }
   auto res = std::vector<MappingType>{};
   for (int i = GetMinSize(); i < size; ++i) {
     res.emplace_back(array_[i]);
@@ -135,26 +177,26 @@ auto B_PLUS_TREE_LEAF_PAGE_TYPE::ExtractHalf() -> std::vector<MappingType> {
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::Contain(const KeyType &key, const KeyComparator &comparator) -> bool {
-  const auto size = GetSize();
-  for (int i = 0; i < size; ++i) {
-    if (comparator(array_[i].first, key) == 0) {
-      return true;
-    }
-  }
-  return false;
+  auto i = KeyIndex(key, comparator);
+  return i != GetSize() && comparator(KeyAt(i), key) == 0;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::PopBack() -> std::pair<KeyType, ValueType> {
-  auto res = array_[GetSize() - 1];
+  auto res = std::make_pair(KeyAt(GetSize() - 1), ValueAt(GetSize() - 1));
   SetSize(GetSize() - 1);
   return std::move(res);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::PopFront() -> std::pair<KeyType, ValueType> {
-  auto res = array_[0];
+  auto res = std::make_pair(KeyAt(0), ValueAt(0));
   const auto size = GetSize();
+  if (IsCompressed()) {
+    Compressed()->Remove(0, size);
+    IncreaseSize(-1);
+    return res;
+  }
   for (int i = 1; i < size; ++i) {
     array_[i - 1] = array_[i];
   }
@@ -78,4 +78,10 @@ void BPlusTreePage::SetPageId(page_id_t page_id) { page_id_ = page_id; }
  */
 void BPlusTreePage::SetLSN(lsn_t lsn) { lsn_ = lsn; }
 
+/*
+ * Helper methods to get/set how the pairs of the page are stored
+ */
+auto BPlusTreePage::IsCompressed() const -> bool { return key_format_ == IndexKeyFormat::COMPRESSED; }
+void BPlusTreePage::SetKeyFormat(IndexKeyFormat key_format) { key_format_ = key_format; }
+
 }  // namespace bustub
@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.cpp
+//
+// Identification: src/storage/table/tuple_batch.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+#include "storage/table/tuple_batch.h"
+
+namespace bustub {
+
+TupleBatch::TupleBatch(const Schema *schema, uint32_t capacity) : schema_(schema), capacity_(capacity) {
+  BUSTUB_ASSERT(capacity_ > 0, "a batch has to hold at least one row");
+  Reset(schema);
+}
+
+void TupleBatch::Reset(const Schema *schema) {
+  schema_ = schema;
+  columns_.resize(schema_->GetColumnCount());
+  for (auto &column : columns_) {
+    column.clear();
+    column.reserve(capacity_);
+  }
+  rids_.clear();
+  selection_.clear();
+}
+
+void TupleBatch::SetSelection(std::vector<uint32_t> selection) {
+  BUSTUB_ASSERT(selection.empty() || selection.back() < GetRowCount(), "selected row does not exist");
+  selection_ = std::move(selection);
+}
+
+void TupleBatch::Append(const Tuple &tuple, RID rid) {
+  BUSTUB_ASSERT(!IsFull(), "batch is full");
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    columns_[i].emplace_back(tuple.GetValue(schema_, i));
+  }
+  selection_.emplace_back(GetRowCount());
+  rids_.emplace_back(rid);
+}
+
+void TupleBatch::Append(std::vector<Value> values, RID rid) {
+  BUSTUB_ASSERT(!IsFull(), "batch is full");
+  BUSTUB_ASSERT(values.size() == columns_.size(), "one value per column is needed");
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    columns_[i].emplace_back(std::move(values[i]));
+  }
+  selection_.emplace_back(GetRowCount());
+  rids_.emplace_back(rid);
+}
+
+void TupleBatch::SetColumns(std::vector<std::vector<Value>> columns, std::vector<RID> rids) {
+  BUSTUB_ASSERT(columns.size() == schema_->GetColumnCount(), "one vector of values per column is needed");
+  BUSTUB_ASSERT(rids.size() <= capacity_, "too many rows for the batch");
+  for (const auto &column : columns) {
+    BUSTUB_ASSERT(column.size() == rids.size(), "one value per row is needed");
+  }
+  columns_ = std::move(columns);
+  rids_ = std::move(rids);
+  selection_.resize(rids_.size());
+  std::iota(selection_.begin(), selection_.end(), 0);
+}
+
+auto TupleBatch::GetRowValues(uint32_t row) const -> std::vector<Value> {
+  std::vector<Value> values;
+  values.reserve(columns_.size());
+  for (const auto &column : columns_) {
+    values.emplace_back(column[row]);
+  }
+  return values;
+}
+
+auto TupleBatch::GetTuple(uint32_t row) const -> Tuple { return Tuple{GetRowValues(row), schema_}; }
+
+}  // namespace bustub
@@ -13,12 +13,18 @@
 #include "buffer/buffer_pool_manager_instance.h"
 
 #include <array>
+#include <atomic>
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <future>  // NOLINT
 #include <random>
 #include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "common/logger.h"
+#include "storage/disk/disk_manager_memory.h"
 #include "gtest/gtest.h"
 
 [[maybe_unused]] static void STOP_TEST() {
@@ -28,6 +34,51 @@
 
 namespace bustub {
 
+/** An in-memory disk for tests that watch the I/O of a buffer pool. */
+class CountingDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  void ReadPage(page_id_t page_id, char *page_data) override {
+    num_reads_++;
+    if (page_id == blocking_page_id_) {
+      read_started_.set_value();
+      release_.get_future().wait();
+    }
+    DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+  }
+
+  void WritePage(page_id_t page_id, const char *page_data) override {
+    num_writes_++;
+    DiskManagerUnlimitedMemory::WritePage(page_id, page_data);
+  }
+
+  std::atomic<int> num_reads_{0};
+  std::atomic<int> num_writes_{0};
+  /** Reads of this page signal read_started_, then block until release_ is set. */
+  page_id_t blocking_page_id_{INVALID_PAGE_ID};
+  std::promise<void> read_started_;
+  std::promise<void> release_;
+};
+
+/** Create `num_pages` pages holding "page <id>" and unpin them dirty. */
+static void WritePages(BufferPoolManager *bpm, int num_pages) {
+  page_id_t page_id;
+  for (int i = 0; i < num_pages; ++i) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+}
+
+/** Fetch an otherwise unpinned page written by WritePages, check it and unpin it. */
+static void CheckPage(BufferPoolManager *bpm, page_id_t page_id) {
+  auto *page = bpm->FetchPage(page_id);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+  EXPECT_EQ(1, page->GetPinCount());
+  ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+}
+
 // NOLINTNEXTLINE
 // Check whether pages containing terminal characters can be recovered
 TEST(BufferPoolManagerInstanceTest, BinaryDataTest) {
@@ -327,4 +378,221 @@ TEST(BufferPoolManagerInstanceTest, BenchmarkTest) {
   delete bpm;
   delete disk_manager;
 }
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, FetchDuringDiskIOTest) {
+  const size_t buffer_pool_size = 3;
+  const size_t k = 2;
+  auto *disk_manager = new CountingDiskManager();
+  disk_manager->blocking_page_id_ = 1;
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, k);
+
+  // Scenario: page 0 stays cached, page 1 is written out and evicted.
+  page_id_t page_id_temp;
+  for (int i = 0; i < 3; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+  }
+  ASSERT_TRUE(bpm->UnpinPage(1, true));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  ASSERT_TRUE(bpm->UnpinPage(2, true));
+
+  // Scenario: while page 1 is being read from disk, a hit on page 0 must not
+  // wait for that read, and a second fetcher of page 1 waits for the same read.
+  auto read_started = disk_manager->read_started_.get_future();
+  auto first_fetcher = std::async(std::launch::async, [bpm] { return bpm->FetchPage(1); });
+  read_started.wait();
+  auto *page0 = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, strcmp(page0->GetData(), "page 0"));
+  auto second_fetcher = std::async(std::launch::async, [bpm] { return bpm->FetchPage(1); });
+  disk_manager->release_.set_value();
+
+  auto *page1 = first_fetcher.get();
+  ASSERT_NE(nullptr, page1);
+  EXPECT_EQ(page1, second_fetcher.get());
+  EXPECT_EQ(0, strcmp(page1->GetData(), "page 1"));
+  EXPECT_EQ(2, page1->GetPinCount());
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, PrefetchPagesTest) {
+  const size_t buffer_pool_size = 4;
+  const size_t k = 2;
+  auto *disk_manager = new CountingDiskManager();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, k);
+
+  // Scenario: write out eight pages, only the last four stay cached.
+  WritePages(bpm, 8);
+
+  // Scenario: prefetched pages are read once, and fetching them afterwards
+  // does not go to the disk again. Cached pages are not read at all.
+  bpm->PrefetchPages({0, 1, 7});
+  for (page_id_t page_id : {0, 1, 7}) {
+    CheckPage(bpm, page_id);
+  }
+  EXPECT_EQ(2, disk_manager->num_reads_);
+
+  // Scenario: unfetched read-ahead does not hold on to its frames, and a
+  // prefetched page can be deleted.
+  bpm->PrefetchPages({2, 3, 4});
+  EXPECT_TRUE(bpm->DeletePage(4));
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, BufferAccessStrategyTest) {
+  const size_t buffer_pool_size = 16;
+  const int num_scanned_pages = 64;
+  const int num_hot_pages = 4;
+  auto *disk_manager = new CountingDiskManager();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, LRUK_REPLACER_K);
+
+  // Scenario: a large table is written out, then a small working set is
+  // touched a few times, fewer than k, so LRU-K alone would not protect it.
+  WritePages(bpm, num_scanned_pages + num_hot_pages);
+  for (int round = 0; round < 2; ++round) {
+    for (page_id_t page_id = num_scanned_pages; page_id < num_scanned_pages + num_hot_pages; ++page_id) {
+      CheckPage(bpm, page_id);
+    }
+  }
+
+  // Scenario: a scan through a strategy only recycles its ring.
+  BufferAccessStrategy strategy(buffer_pool_size);
+  EXPECT_EQ(buffer_pool_size / 4, strategy.GetRingSize());
+  for (page_id_t page_id = 0; page_id < num_scanned_pages; ++page_id) {
+    auto *page = bpm->FetchPage(page_id, &strategy);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, strcmp(page->GetData(), ("page " + std::to_string(page_id)).c_str()));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_TRUE(strategy.IsActive());
+
+  // Scenario: the working set survived the scan.
+  auto num_reads = disk_manager->num_reads_.load();
+  for (page_id_t page_id = num_scanned_pages; page_id < num_scanned_pages + num_hot_pages; ++page_id) {
+    CheckPage(bpm, page_id);
+  }
+  EXPECT_EQ(num_reads, disk_manager->num_reads_);
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, PageCleanerTest) {
+  const size_t buffer_pool_size = 16;
+  const int num_pages = 64;
+  auto *disk_manager = new CountingDiskManager();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, 2);
+
+  // Scenario: every frame holds a dirty page.
+  WritePages(bpm, buffer_pool_size);
+  EXPECT_EQ(0, bpm->GetNumCleanFrames());
+
+  // Scenario: the cleaner writes back pages until half of the frames are clean, and stops there.
+  bpm->RunPageCleaner(0.5);
+  // Frames count as clean as soon as their copies are taken, the writes land a bit later.
+  for (int i = 0; i < 500 && (bpm->GetNumCleanFrames() < buffer_pool_size / 2 ||
+                              disk_manager->num_writes_ < static_cast<int>(buffer_pool_size / 2));
+       ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(buffer_pool_size / 2, bpm->GetNumCleanFrames());
+  EXPECT_EQ(buffer_pool_size / 2, disk_manager->num_writes_);
+
+  // Scenario: pages are modified and evicted while the cleaner runs, no update gets lost.
+  std::vector<std::thread> threads;
+  for (int thread_id = 0; thread_id < 4; ++thread_id) {
+    threads.emplace_back([bpm, thread_id] {
+      page_id_t page_id;
+      for (int i = 0; i < num_pages / 4; ++i) {
+        auto *page = bpm->NewPage(&page_id);
+        while (page == nullptr) {
+          page = bpm->NewPage(&page_id);
+        }
+        snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+        bpm->UnpinPage(page_id, true);
+      }
+      for (int round = 0; round < 3; ++round) {
+        for (page_id = thread_id; page_id < static_cast<page_id_t>(buffer_pool_size); page_id += 4) {
+          auto *page = bpm->FetchPage(page_id);
+          while (page == nullptr) {
+            page = bpm->FetchPage(page_id);
+          }
+          page->WLatch();
+          snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d round %d", page_id, round);
+          page->WUnlatch();
+          bpm->UnpinPage(page_id, true);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  bpm->StopPageCleaner();
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(buffer_pool_size + num_pages); ++page_id) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    auto expected = page_id < static_cast<page_id_t>(buffer_pool_size)
+                        ? "page " + std::to_string(page_id) + " round 2"
+                        : "page " + std::to_string(page_id);
+    EXPECT_EQ(expected, std::string(page->GetData()));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, ConcurrentHitAndEvictTest) {
+  const size_t buffer_pool_size = 8;
+  const int num_pages = 32;
+  auto *disk_manager = new CountingDiskManager();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, 2);
+  WritePages(bpm, num_pages);
+
+  // Scenario: hits on a few hot pages race with misses evicting the frames around them.
+  std::vector<std::thread> threads;
+  for (int thread_id = 0; thread_id < 8; ++thread_id) {
+    threads.emplace_back([bpm, thread_id] {
+      std::mt19937 gen(thread_id);
+      for (int i = 0; i < 5000; ++i) {
+        auto page_id = static_cast<page_id_t>(gen() % (thread_id % 2 == 0 ? 2 : num_pages));
+        auto *page = bpm->FetchPage(page_id);
+        if (page == nullptr) {
+          continue;
+        }
+        page->RLatch();
+        EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+        page->RUnlatch();
+        EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // Scenario: every pin was released, so every frame can be reused.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
 }  // namespace bustub
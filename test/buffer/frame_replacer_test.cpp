@@ -0,0 +1,246 @@
+/**
+ * frame_replacer_test.cpp
+ */
+
+#include "buffer/frame_replacer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "buffer/arc_replacer.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/clock_pro_replacer.h"
+#include "buffer/two_queue_replacer.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+static const std::vector<ReplacerPolicy> ALL_POLICIES = {ReplacerPolicy::LRU_K, ReplacerPolicy::TWO_Q,
+                                                         ReplacerPolicy::ARC, ReplacerPolicy::CLOCK_PRO};
+
+TEST(FrameReplacerTest, SharedSemanticsTest) {
+  for (auto policy : ALL_POLICIES) {
+    SCOPED_TRACE(ReplacerPolicyToString(policy));
+    auto replacer = MakeFrameReplacer(policy, 7, 2);
+
+    // New frames start out evictable, frame 6 is pinned.
+    for (frame_id_t frame_id = 1; frame_id <= 6; ++frame_id) {
+      replacer->RecordAccess(frame_id, frame_id);
+    }
+    ASSERT_EQ(6, replacer->Size());
+    replacer->SetEvictable(6, false);
+    replacer->SetEvictable(6, false);
+    ASSERT_EQ(5, replacer->Size());
+    // Untracked frames are ignored.
+    replacer->SetEvictable(0, true);
+    ASSERT_EQ(5, replacer->Size());
+
+    ASSERT_THROW(replacer->RecordAccess(7, 7), std::out_of_range);
+    ASSERT_THROW(replacer->RecordAccess(-1, 7), std::out_of_range);
+    ASSERT_THROW(replacer->Remove(6), std::runtime_error);
+    replacer->Remove(0);
+
+    replacer->Remove(5);
+    ASSERT_EQ(4, replacer->Size());
+
+    // Hits must not change the set of tracked frames.
+    replacer->RecordAccess(2, 2);
+    replacer->RecordAccess(2, 2);
+    replacer->RecordAccess(6, 6);
+
+    std::set<frame_id_t> evicted;
+    frame_id_t frame_id;
+    while (replacer->Evict(&frame_id)) {
+      ASSERT_TRUE(evicted.insert(frame_id).second);
+    }
+    ASSERT_EQ((std::set<frame_id_t>{1, 2, 3, 4}), evicted);
+    ASSERT_EQ(0, replacer->Size());
+
+    // The pinned frame becomes the only victim once unpinned.
+    replacer->SetEvictable(6, true);
+    ASSERT_EQ(1, replacer->Size());
+    ASSERT_TRUE(replacer->Evict(&frame_id));
+    ASSERT_EQ(6, frame_id);
+    ASSERT_FALSE(replacer->Evict(&frame_id));
+  }
+}
+
+/** Load page_id into a pool of replacer->num_frames frames, evicting if needed. @return the frame */
+static auto LoadPage(FrameReplacer *replacer, std::vector<page_id_t> *frame_pages, page_id_t page_id) -> frame_id_t {
+  for (size_t i = 0; i < frame_pages->size(); ++i) {
+    if ((*frame_pages)[i] == page_id) {
+      replacer->RecordAccess(static_cast<frame_id_t>(i), page_id);
+      return static_cast<frame_id_t>(i);
+    }
+  }
+  frame_id_t frame_id = -1;
+  for (size_t i = 0; i < frame_pages->size(); ++i) {
+    if ((*frame_pages)[i] == INVALID_PAGE_ID) {
+      frame_id = static_cast<frame_id_t>(i);
+      break;
+    }
+  }
+  if (frame_id < 0) {
+    EXPECT_TRUE(replacer->Evict(&frame_id));
+  }
+  (*frame_pages)[frame_id] = page_id;
+  replacer->RecordAccess(frame_id, page_id);
+  return frame_id;
+}
+
+TEST(FrameReplacerTest, ScanResistanceTest) {
+  // A hot set of 4 pages, touched twice, then a scan over 64 pages seen once.
+  // Every policy but plain recency keeps the hot set resident.
+  const size_t num_frames = 8;
+  for (auto policy : {ReplacerPolicy::LRU_K, ReplacerPolicy::TWO_Q, ReplacerPolicy::ARC}) {
+    SCOPED_TRACE(ReplacerPolicyToString(policy));
+    auto replacer = MakeFrameReplacer(policy, num_frames, 2);
+    std::vector<page_id_t> frame_pages(num_frames, INVALID_PAGE_ID);
+    // 2Q only admits pages to its main queue after they were evicted from A1in once.
+    for (int round = 0; round < 3; ++round) {
+      for (page_id_t page_id = 0; page_id < 4; ++page_id) {
+        LoadPage(replacer.get(), &frame_pages, page_id);
+        LoadPage(replacer.get(), &frame_pages, page_id);
+      }
+      for (page_id_t page_id = 100; page_id < 108; ++page_id) {
+        LoadPage(replacer.get(), &frame_pages, page_id + round * 8);
+      }
+    }
+    for (page_id_t page_id = 1000; page_id < 1064; ++page_id) {
+      LoadPage(replacer.get(), &frame_pages, page_id);
+    }
+    for (page_id_t page_id = 0; page_id < 4; ++page_id) {
+      ASSERT_NE(frame_pages.end(), std::find(frame_pages.begin(), frame_pages.end(), page_id));
+    }
+  }
+}
+
+TEST(FrameReplacerTest, ARCGhostHitTest) {
+  ARCReplacer replacer(4);
+  std::vector<page_id_t> frame_pages(4, INVALID_PAGE_ID);
+  // T1 = [1, 0], T2 = [2]
+  LoadPage(&replacer, &frame_pages, 0);
+  LoadPage(&replacer, &frame_pages, 1);
+  LoadPage(&replacer, &frame_pages, 2);
+  LoadPage(&replacer, &frame_pages, 2);
+  LoadPage(&replacer, &frame_pages, 3);
+  ASSERT_EQ(0, replacer.GetTargetRecentSize());
+  // Page 4 evicts page 0 from T1 into B1.
+  LoadPage(&replacer, &frame_pages, 4);
+  ASSERT_EQ(frame_pages.end(), std::find(frame_pages.begin(), frame_pages.end(), 0));
+  // Reloading page 0 evicts page 1 and is a B1 ghost hit: T1 deserves more
+  // room, and page 0 goes to T2 right away.
+  LoadPage(&replacer, &frame_pages, 0);
+  ASSERT_EQ(1, replacer.GetTargetRecentSize());
+
+  // T1 = [4, 3] is above its target, so it gives up its LRU page first. Then
+  // T2 = [0, 2] does.
+  frame_id_t frame_id;
+  for (page_id_t page_id : {3, 2, 0, 4}) {
+    ASSERT_TRUE(replacer.Evict(&frame_id));
+    ASSERT_EQ(page_id, frame_pages[frame_id]);
+  }
+}
+
+TEST(FrameReplacerTest, TwoQueueCorrelatedReferenceTest) {
+  // 8 frames: Kin = 2, Kout = 4.
+  TwoQueueReplacer replacer(8);
+  std::vector<page_id_t> frame_pages(8, INVALID_PAGE_ID);
+  for (page_id_t page_id = 0; page_id < 8; ++page_id) {
+    LoadPage(&replacer, &frame_pages, page_id);
+  }
+  // Repeated hits in A1in do not save page 0, A1in is FIFO.
+  LoadPage(&replacer, &frame_pages, 0);
+  LoadPage(&replacer, &frame_pages, 0);
+  frame_id_t frame_id;
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  ASSERT_EQ(0, frame_pages[frame_id]);
+  frame_pages[frame_id] = INVALID_PAGE_ID;
+  // Page 0 is remembered in A1out, so loading it again puts it into Am. Am is
+  // only evicted from once A1in is down to Kin.
+  LoadPage(&replacer, &frame_pages, 0);
+  for (page_id_t page_id = 1; page_id <= 5; ++page_id) {
+    ASSERT_TRUE(replacer.Evict(&frame_id));
+    ASSERT_EQ(page_id, frame_pages[frame_id]);
+    frame_pages[frame_id] = INVALID_PAGE_ID;
+  }
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  ASSERT_EQ(0, frame_pages[frame_id]);
+}
+
+TEST(FrameReplacerTest, ClockProTestPeriodTest) {
+  ClockProReplacer replacer(4);
+  std::vector<page_id_t> frame_pages(4, INVALID_PAGE_ID);
+  for (page_id_t page_id = 0; page_id < 4; ++page_id) {
+    LoadPage(&replacer, &frame_pages, page_id);
+  }
+  ASSERT_EQ(1, replacer.GetColdTarget());
+  // Page 4 evicts the oldest cold page while it is still in its test period.
+  LoadPage(&replacer, &frame_pages, 4);
+  ASSERT_EQ(frame_pages.end(), std::find(frame_pages.begin(), frame_pages.end(), 0));
+  // Faulting page 0 back in during its test period grows the cold target, page 0 is hot now.
+  LoadPage(&replacer, &frame_pages, 0);
+  ASSERT_EQ(2, replacer.GetColdTarget());
+  frame_id_t frame_id;
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(replacer.Evict(&frame_id));
+    ASSERT_NE(0, frame_pages[frame_id]);
+    frame_pages[frame_id] = INVALID_PAGE_ID;
+  }
+}
+
+TEST(FrameReplacerTest, BufferPoolPolicyTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 5;
+  for (auto policy : ALL_POLICIES) {
+    SCOPED_TRACE(ReplacerPolicyToString(policy));
+    auto *disk_manager = new DiskManager(db_name);
+    auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, 2, nullptr, policy);
+
+    std::vector<page_id_t> page_ids;
+    for (int i = 0; i < 20; ++i) {
+      page_id_t page_id;
+      auto *page = bpm->NewPage(&page_id);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+      page_ids.push_back(page_id);
+      ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+    // A skewed reread: the first pages over and over, the others once.
+    for (int round = 0; round < 3; ++round) {
+      for (auto page_id : page_ids) {
+        if (round > 0 && page_id >= 3) {
+          continue;
+        }
+        auto *page = bpm->FetchPage(page_id);
+        ASSERT_NE(nullptr, page);
+        ASSERT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+        ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+      }
+    }
+    // With every frame pinned nothing can be evicted.
+    for (size_t i = 0; i < buffer_pool_size; ++i) {
+      ASSERT_NE(nullptr, bpm->FetchPage(page_ids[i]));
+    }
+    ASSERT_EQ(nullptr, bpm->FetchPage(page_ids[buffer_pool_size]));
+    for (size_t i = 0; i < buffer_pool_size; ++i) {
+      ASSERT_TRUE(bpm->UnpinPage(page_ids[i], false));
+    }
+    ASSERT_TRUE(bpm->DeletePage(page_ids[0]));
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[buffer_pool_size]));
+    ASSERT_TRUE(bpm->UnpinPage(page_ids[buffer_pool_size], false));
+
+    disk_manager->ShutDown();
+    remove("test.db");
+    delete bpm;
+    delete disk_manager;
+  }
+}
+
+}  // namespace bustub
@@ -297,4 +297,52 @@ TEST(LRUKReplacerTest, BenchmarkTest) {
   //  set version:45 in 13,  5512 in 20
 }
 
+// NOLINTNEXTLINE
+TEST(LRUKReplacerTest, BufferedAccessTest) {
+  constexpr size_t nframe = 64;
+  constexpr size_t k = 3;
+  constexpr size_t nthreads = 8;
+  LRUKReplacer replacer(nframe, k);
+
+  // Scenario: first accesses go straight into the history.
+  for (frame_id_t frame_id = 0; frame_id < static_cast<frame_id_t>(nframe); ++frame_id) {
+    replacer.RecordAccess(frame_id);
+  }
+  ASSERT_EQ(nframe, replacer.Size());
+
+  // Scenario: hits from several threads are buffered, but Evict() sees all of
+  // them. Every thread takes frames tid, tid + nthreads, ... to k accesses,
+  // except frame 0 which stays at a single access.
+  std::vector<std::thread> threads;
+  for (size_t tid = 0; tid < nthreads; ++tid) {
+    threads.emplace_back([&replacer, tid] {
+      for (auto frame_id = tid; frame_id < nframe; frame_id += nthreads) {
+        for (size_t i = 1; i < k && frame_id != 0; ++i) {
+          replacer.RecordAccess(frame_id);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  frame_id_t frame_id;
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(0, frame_id);
+
+  // Scenario: a frame that is accessed again moves to the back of the order,
+  // even while its access is only buffered.
+  replacer.SetEvictable(1, false);
+  replacer.RecordAccess(2);
+  replacer.SetEvictable(1, true);
+  std::vector<frame_id_t> evicted;
+  while (replacer.Evict(&frame_id)) {
+    evicted.push_back(frame_id);
+  }
+  ASSERT_EQ(nframe - 1, evicted.size());
+  EXPECT_EQ(2, evicted.back());
+  EXPECT_EQ(0, replacer.Size());
+}
+
 }  // namespace bustub
+
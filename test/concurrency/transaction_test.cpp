@@ -267,4 +267,28 @@ TEST_F(TransactionTest, DISABLED_ABLED_MixTest) {
   delete txn3;
 }
 
+// NOLINTNEXTLINE
+TEST_F(TransactionTest, IndexScanLockTest) {
+  // Indexes keep their root page ids in page 0, which the test tables take like in the sqllogictest driver.
+  bustub_->GenerateTestTable();
+  auto noop_writer = NoopWriter();
+  EXECUTE_SQL("CREATE TABLE index_table (x int, y int)", noop_writer);
+  EXECUTE_SQL("INSERT INTO index_table VALUES (1, 10), (2, 20), (3, 30)", noop_writer);
+  EXECUTE_SQL("CREATE INDEX index_table_x ON index_table(x)", noop_writer);
+  const auto oid = bustub_->catalog_->GetTable("index_table")->oid_;
+
+  // The filter is answered by an index scan, which locks the table and only the rows it reads.
+  for (auto isolation_level : {IsolationLevel::REPEATABLE_READ, IsolationLevel::READ_COMMITTED}) {
+    auto *txn = bustub_->txn_manager_->Begin(nullptr, isolation_level);
+    std::stringstream ss;
+    auto writer = SimpleStreamWriter(ss, true);
+    EXECUTE_SQL_TXN("SELECT * FROM index_table WHERE x = 2", writer, txn);
+    EXPECT_EQ(ss.str(), "2\t20\t\n");
+    EXPECT_EQ(txn->GetIntentionSharedTableLockSet()->count(oid), 1);
+    EXPECT_EQ((*txn->GetSharedRowLockSet())[oid].size(), isolation_level == IsolationLevel::REPEATABLE_READ ? 1 : 0);
+    bustub_->txn_manager_->Commit(txn);
+    delete txn;
+  }
+}
+
 }  // namespace bustub
@@ -0,0 +1,120 @@
+/**
+ * page_table_test.cpp
+ */
+
+#include "container/hash/page_table.h"
+
+#include <atomic>
+#include <memory>
+#include <random>
+#include <thread>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(PageTableTest, SampleTest) {
+  PageTable table(4);
+  ASSERT_EQ(8, table.GetCapacity());
+
+  frame_id_t frame_id;
+  ASSERT_FALSE(table.Find(0, frame_id));
+  table.Insert(0, 3);
+  table.Insert(17, 2);
+  table.Insert(-5, 1);
+  ASSERT_EQ(3, table.Size());
+  ASSERT_TRUE(table.Find(0, frame_id));
+  ASSERT_EQ(3, frame_id);
+  ASSERT_TRUE(table.Find(-5, frame_id));
+  ASSERT_EQ(1, frame_id);
+
+  // Insert overwrites.
+  table.Insert(17, 0);
+  ASSERT_EQ(3, table.Size());
+  ASSERT_TRUE(table.Find(17, frame_id));
+  ASSERT_EQ(0, frame_id);
+
+  ASSERT_TRUE(table.Remove(0));
+  ASSERT_FALSE(table.Remove(0));
+  ASSERT_FALSE(table.Find(0, frame_id));
+  ASSERT_EQ(2, table.Size());
+  ASSERT_TRUE(table.Find(17, frame_id));
+  ASSERT_TRUE(table.Find(-5, frame_id));
+}
+
+TEST(PageTableTest, ChurnTest) {
+  // Random inserts and removes over a small table, so clusters wrap around
+  // the end and removes have to shift entries back.
+  const size_t num_frames = 16;
+  PageTable table(num_frames);
+  std::unordered_map<page_id_t, frame_id_t> expected;
+  std::mt19937 rng(15445);
+  for (int i = 0; i < 100000; ++i) {
+    auto page_id = static_cast<page_id_t>(rng() % 64);
+    if (expected.count(page_id) > 0 || expected.size() == num_frames) {
+      auto victim = expected.count(page_id) > 0 ? page_id : expected.begin()->first;
+      ASSERT_TRUE(table.Remove(victim));
+      expected.erase(victim);
+    } else {
+      auto frame_id = static_cast<frame_id_t>(i % num_frames);
+      table.Insert(page_id, frame_id);
+      expected[page_id] = frame_id;
+    }
+    ASSERT_EQ(expected.size(), table.Size());
+    if (i % 64 == 0) {
+      for (page_id_t probe = 0; probe < 64; ++probe) {
+        frame_id_t frame_id;
+        auto it = expected.find(probe);
+        ASSERT_EQ(it != expected.end(), table.Find(probe, frame_id));
+        if (it != expected.end()) {
+          ASSERT_EQ(it->second, frame_id);
+        }
+      }
+    }
+  }
+}
+
+TEST(PageTableTest, ConcurrentReadTest) {
+  // Readers look up pages that are never removed while a writer churns other
+  // pages sharing their clusters; they must never miss.
+  const size_t num_frames = 64;
+  PageTable table(num_frames);
+  for (page_id_t page_id = 0; page_id < 32; ++page_id) {
+    table.Insert(page_id, page_id);
+  }
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; ++t) {
+    readers.emplace_back([&table, &done] {
+      while (!done.load()) {
+        for (page_id_t page_id = 0; page_id < 32; ++page_id) {
+          frame_id_t frame_id;
+          ASSERT_TRUE(table.Find(page_id, frame_id));
+          ASSERT_EQ(page_id, frame_id);
+        }
+      }
+    });
+  }
+  std::mt19937 rng(15445);
+  std::vector<page_id_t> churned;
+  for (int i = 0; i < 200000; ++i) {
+    if (churned.size() == num_frames - 32 || (!churned.empty() && rng() % 2 == 0)) {
+      auto pos = rng() % churned.size();
+      ASSERT_TRUE(table.Remove(churned[pos]));
+      churned[pos] = churned.back();
+      churned.pop_back();
+    } else {
+      auto page_id = static_cast<page_id_t>(1000 + i);
+      table.Insert(page_id, 0);
+      churned.push_back(page_id);
+    }
+  }
+  done.store(true);
+  for (auto &reader : readers) {
+    reader.join();
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,149 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// expression_program_test.cpp
+//
+// Identification: test/execution/expression_program_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "execution/expressions/arithmetic_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/expression_program.h"
+#include "execution/expressions/logic_expression.h"
+#include "gtest/gtest.h"
+#include "storage/table/tuple_batch.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+auto ColumnExpr(uint32_t col_idx, TypeId type) -> AbstractExpressionRef {
+  return std::make_shared<ColumnValueExpression>(0, col_idx, type);
+}
+
+auto ConstantExpr(const Value &value) -> AbstractExpressionRef {
+  return std::make_shared<ConstantValueExpression>(value);
+}
+
+auto CompareExpr(AbstractExpressionRef lhs, AbstractExpressionRef rhs, ComparisonType comp_type)
+    -> AbstractExpressionRef {
+  return std::make_shared<ComparisonExpression>(std::move(lhs), std::move(rhs), comp_type);
+}
+
+auto LogicExpr(AbstractExpressionRef lhs, AbstractExpressionRef rhs, LogicType logic_type) -> AbstractExpressionRef {
+  return std::make_shared<LogicExpression>(std::move(lhs), std::move(rhs), logic_type);
+}
+
+auto ArithmeticExpr(AbstractExpressionRef lhs, AbstractExpressionRef rhs, ArithmeticType compute_type)
+    -> AbstractExpressionRef {
+  return std::make_shared<ArithmeticExpression>(std::move(lhs), std::move(rhs), compute_type);
+}
+
+/** Whether both values are NULL, or both are not and compare equal. */
+auto SameValue(const Value &lhs, const Value &rhs) -> bool {
+  if (lhs.IsNull() || rhs.IsNull()) {
+    return lhs.IsNull() && rhs.IsNull();
+  }
+  return lhs.CompareEquals(rhs) == CmpBool::CmpTrue;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(ExpressionProgramTest, MatchesTreeEvaluation) {
+  Schema schema{std::vector<bustub::Column>{{"a", TypeId::INTEGER},
+                                            {"b", TypeId::BIGINT},
+                                            {"c", TypeId::VARCHAR, 16},
+                                            {"d", TypeId::BOOLEAN}}};
+  TupleBatch batch{&schema};
+  for (int32_t i = 0; i < 64; i++) {
+    // Every column is NULL in some rows.
+    auto a = i % 7 == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER) : ValueFactory::GetIntegerValue(i - 20);
+    auto b = i % 5 == 0 ? ValueFactory::GetNullValueByType(TypeId::BIGINT) : ValueFactory::GetBigIntValue(40 - i);
+    auto c = i % 11 == 0 ? ValueFactory::GetNullValueByType(TypeId::VARCHAR)
+                         : ValueFactory::GetVarcharValue(std::string(1, static_cast<char>('a' + i % 4)));
+    auto d = i % 3 == 0 ? ValueFactory::GetNullValueByType(TypeId::BOOLEAN) : ValueFactory::GetBooleanValue(i % 2 == 0);
+    batch.Append(std::vector<Value>{a, b, c, d}, RID{});
+  }
+  // Skip some rows, the program only runs on the selected ones.
+  std::vector<uint32_t> selection;
+  for (uint32_t row = 0; row < batch.GetRowCount(); row++) {
+    if (row % 4 != 1) {
+      selection.emplace_back(row);
+    }
+  }
+  batch.SetSelection(selection);
+
+  const auto a = ColumnExpr(0, TypeId::INTEGER);
+  const auto b = ColumnExpr(1, TypeId::BIGINT);
+  const auto c = ColumnExpr(2, TypeId::VARCHAR);
+  const auto d = ColumnExpr(3, TypeId::BOOLEAN);
+  const auto a_plus_one = ArithmeticExpr(a, ConstantExpr(ValueFactory::GetIntegerValue(1)), ArithmeticType::Plus);
+  const std::vector<AbstractExpressionRef> exprs{
+      a,
+      ConstantExpr(ValueFactory::GetIntegerValue(7)),
+      a_plus_one,
+      ArithmeticExpr(a_plus_one, a, ArithmeticType::Minus),
+      CompareExpr(a_plus_one, b, ComparisonType::GreaterThan),
+      CompareExpr(b, ConstantExpr(ValueFactory::GetIntegerValue(10)), ComparisonType::LessThanOrEqual),
+      CompareExpr(a, ConstantExpr(ValueFactory::GetDecimalValue(-3.5)), ComparisonType::NotEqual),
+      CompareExpr(c, ConstantExpr(ValueFactory::GetVarcharValue("b")), ComparisonType::Equal),
+      LogicExpr(CompareExpr(a, b, ComparisonType::LessThan), d, LogicType::And),
+      LogicExpr(CompareExpr(c, ConstantExpr(ValueFactory::GetVarcharValue("c")), ComparisonType::GreaterThanOrEqual),
+                d, LogicType::Or),
+      LogicExpr(
+          LogicExpr(d, CompareExpr(a, ConstantExpr(ValueFactory::GetIntegerValue(0)), ComparisonType::Equal),
+                    LogicType::Or),
+          CompareExpr(b, a, ComparisonType::NotEqual), LogicType::And),
+  };
+
+  for (const auto &expr : exprs) {
+    ExpressionProgram program{*expr};
+    const auto values = program.EvaluateBatch(batch);
+    ASSERT_EQ(values.size(), selection.size()) << expr->ToString();
+    std::vector<uint32_t> expected_selection;
+    for (size_t i = 0; i < selection.size(); i++) {
+      const auto tuple = batch.GetTuple(selection[i]);
+      const auto expected = expr->Evaluate(&tuple, schema);
+      EXPECT_TRUE(SameValue(values[i], expected)) << expr->ToString() << " row " << selection[i];
+      EXPECT_TRUE(SameValue(program.Evaluate(&tuple, schema), expected))
+          << expr->ToString() << " row " << selection[i];
+      if (expr->GetReturnType() == TypeId::BOOLEAN) {
+        const auto holds = !expected.IsNull() && expected.GetAs<bool>();
+        EXPECT_EQ(program.IsTrue(&tuple, schema), holds) << expr->ToString() << " row " << selection[i];
+        if (holds) {
+          expected_selection.emplace_back(selection[i]);
+        }
+      }
+    }
+    if (expr->GetReturnType() == TypeId::BOOLEAN) {
+      EXPECT_EQ(program.Select(batch), expected_selection) << expr->ToString();
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(ExpressionProgramTest, LoadsColumnOnce) {
+  // v1 >= 5 and v1 < 9: one load of v1, one conversion of it, two constants, two comparisons and the and.
+  const auto v1 = ColumnExpr(0, TypeId::INTEGER);
+  const auto expr =
+      LogicExpr(CompareExpr(v1, ConstantExpr(ValueFactory::GetIntegerValue(5)), ComparisonType::GreaterThanOrEqual),
+                CompareExpr(v1, ConstantExpr(ValueFactory::GetIntegerValue(9)), ComparisonType::LessThan),
+                LogicType::And);
+  ExpressionProgram program{*expr};
+  EXPECT_EQ(program.GetInstructionCount(), 7U);
+}
+
+}  // namespace bustub
@@ -0,0 +1,80 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_queue_test.cpp
+//
+// Identification: test/execution/morsel_queue_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "catalog/schema.h"
+#include "execution/morsel_queue.h"
+#include "gtest/gtest.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(MorselQueueTest, ScansEveryTupleOnce) {
+  auto disk_manager = std::make_unique<DiskManager>("morsel_queue_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(50, disk_manager.get());
+  Transaction txn(0);
+  Schema schema{std::vector<Column>{{"a", TypeId::INTEGER}}};
+  // More tuples fit on a page than in a batch, so scanners leave pages half way and come back to them.
+  TableHeap table{bpm.get(), nullptr, nullptr, &txn};
+  const int32_t num_tuples = 10000;
+  std::vector<int32_t> expected;
+  for (int32_t i = 0; i < num_tuples; i++) {
+    RID rid;
+    ASSERT_TRUE(table.InsertTuple(Tuple{{ValueFactory::GetIntegerValue(i)}, &schema}, &rid, &txn));
+    if (i % 7 == 0) {
+      table.ApplyDelete(rid, &txn);
+    } else {
+      expected.emplace_back(i);
+    }
+  }
+
+  const size_t num_threads = 4;
+  MorselQueue queue{bpm.get(), table.GetFirstPageId(), 2};
+  std::vector<std::vector<int32_t>> scanned(num_threads);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < num_threads; i++) {
+    threads.emplace_back([&, i] {
+      MorselScanner scanner{&queue, bpm.get(), &txn, &schema};
+      TupleBatch batch{&schema, 100};
+      while (scanner.NextBatch(&batch)) {
+        for (const auto &value : batch.GetColumn(0)) {
+          scanned[i].emplace_back(value.GetAs<int32_t>());
+        }
+      }
+      // A scanner that ran out of morsels stays exhausted.
+      EXPECT_FALSE(scanner.NextBatch(&batch));
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  std::vector<int32_t> all;
+  for (const auto &values : scanned) {
+    all.insert(all.end(), values.begin(), values.end());
+  }
+  std::sort(all.begin(), all.end());
+  EXPECT_EQ(all, expected);
+
+  disk_manager->ShutDown();
+  remove("morsel_queue_test.db");
+}
+
+}  // namespace bustub
@@ -0,0 +1,93 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// spill_file_test.cpp
+//
+// Identification: test/execution/spill_file_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "catalog/schema.h"
+#include "execution/spill_file.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(SpillFileTest, ReadsBackEveryTuple) {
+  auto disk_manager = std::make_unique<DiskManager>("spill_file_test.db");
+  const size_t pool_size = 10;
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(pool_size, disk_manager.get());
+  Schema schema{std::vector<Column>{{"a", TypeId::INTEGER}, {"b", TypeId::VARCHAR, 32}}};
+
+  // The file takes more pages than the buffer pool holds, so most of them are written to disk and read back.
+  SpillFile file{bpm.get(), &schema};
+  const int32_t num_tuples = 5000;
+  for (int32_t i = 0; i < num_tuples; i++) {
+    file.Append(
+        Tuple{{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::to_string(i * 3))}, &schema});
+  }
+  EXPECT_EQ(file.GetTupleCount(), num_tuples);
+  EXPECT_GT(file.GetPageCount(), pool_size);
+
+  std::vector<int32_t> read;
+  TupleBatch batch{&schema, 128};
+  while (file.NextBatch(&batch)) {
+    for (size_t i = 0; i < batch.GetRowCount(); i++) {
+      auto a = batch.GetColumn(0)[i].GetAs<int32_t>();
+      EXPECT_EQ(batch.GetColumn(1)[i].ToString(), std::to_string(a * 3));
+      read.emplace_back(a);
+    }
+  }
+  EXPECT_FALSE(file.NextBatch(&batch));
+  std::sort(read.begin(), read.end());
+  ASSERT_EQ(read.size(), num_tuples);
+  for (int32_t i = 0; i < num_tuples; i++) {
+    EXPECT_EQ(read[i], i);
+  }
+
+  // Every page was deleted once read, so the whole pool is free again.
+  std::vector<page_id_t> page_ids(pool_size);
+  for (auto &page_id : page_ids) {
+    EXPECT_NE(bpm->NewPage(&page_id), nullptr);
+  }
+
+  disk_manager->ShutDown();
+  remove("spill_file_test.db");
+}
+
+// NOLINTNEXTLINE
+TEST(SpillFileTest, UnreadPagesAreDeleted) {
+  auto disk_manager = std::make_unique<DiskManager>("spill_file_test.db");
+  const size_t pool_size = 5;
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(pool_size, disk_manager.get());
+  Schema schema{std::vector<Column>{{"a", TypeId::INTEGER}}};
+  {
+    SpillFile file{bpm.get(), &schema};
+    for (int32_t i = 0; i < 3000; i++) {
+      file.Append(Tuple{{ValueFactory::GetIntegerValue(i)}, &schema});
+    }
+    TupleBatch batch{&schema, 16};
+    ASSERT_TRUE(file.NextBatch(&batch));
+  }
+  std::vector<page_id_t> page_ids(pool_size);
+  for (auto &page_id : page_ids) {
+    EXPECT_NE(bpm->NewPage(&page_id), nullptr);
+  }
+
+  disk_manager->ShutDown();
+  remove("spill_file_test.db");
+}
+
+}  // namespace bustub
@@ -0,0 +1,117 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_test_util.h
+//
+// Identification: test/include/b_plus_tree_test_util.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+
+namespace bustub {
+
+using TreeType = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+using LeafType = BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
+using InternalType = BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>;
+
+/**
+ * Check the structure of the subtree at page_id: sizes within bounds, keys in [low, high), high keys. Appends the
+ * keys of its leaves to keys, and the page and next page ids of its pages to their level in levels.
+ *
+ * A B-link tree does not maintain parent page ids and leaves pages underfull, so those are only checked if b_link is
+ * false.
+ */
+void CheckSubtree(BufferPoolManager *bpm, page_id_t page_id, page_id_t parent_id, int64_t low, int64_t high,
+                  std::vector<int64_t> *keys, size_t depth,
+                  std::vector<std::vector<std::pair<page_id_t, page_id_t>>> *levels, bool b_link) {
+  auto *page = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(page_id)->GetData());
+  if (!b_link) {
+    ASSERT_EQ(parent_id, page->GetParentPageId());
+    if (parent_id != INVALID_PAGE_ID) {
+      ASSERT_GE(page->GetSize(), page->GetMinSize());
+    }
+  }
+  if (levels->size() == depth) {
+    levels->emplace_back();
+  }
+  if (page->IsLeafPage()) {
+    auto *leaf = reinterpret_cast<LeafType *>(page);
+    ASSERT_LT(leaf->GetSize(), leaf->GetMaxSize());
+    (*levels)[depth].emplace_back(page_id, leaf->GetNextPageId());
+    if (leaf->GetNextPageId() != INVALID_PAGE_ID) {
+      ASSERT_EQ(high, leaf->GetHighKey().ToString());
+    }
+    for (int i = 0; i < leaf->GetSize(); i++) {
+      auto key = leaf->KeyAt(i).ToString();
+      ASSERT_LE(low, key);
+      ASSERT_LT(key, high);
+      keys->push_back(key);
+    }
+  } else {
+    auto *internal = reinterpret_cast<InternalType *>(page);
+    ASSERT_GE(internal->GetSize(), 2);
+    ASSERT_LE(internal->GetSize(), internal->GetMaxSize());
+    (*levels)[depth].emplace_back(page_id, internal->GetNextPageId());
+    if (internal->GetNextPageId() != INVALID_PAGE_ID) {
+      ASSERT_EQ(high, internal->GetHighKey().ToString());
+    }
+    for (int i = 0; i < internal->GetSize(); i++) {
+      auto child_low = i == 0 ? low : internal->KeyAt(i).ToString();
+      auto child_high = i + 1 == internal->GetSize() ? high : internal->KeyAt(i + 1).ToString();
+      CheckSubtree(bpm, internal->ValueAt(i), page_id, child_low, child_high, keys, depth + 1, levels, b_link);
+    }
+  }
+  bpm->UnpinPage(page_id, false);
+}
+
+/**
+ * Check the whole tree against the expected keys, in order, through the structure, the leaf chain, reverse iteration
+ * and point lookups. The value of every key is expected to be a RID with the key as its slot number.
+ */
+void CheckTree(BufferPoolManager *bpm, TreeType *tree, const std::vector<int64_t> &expected, bool b_link = false) {
+  std::vector<int64_t> keys;
+  std::vector<std::vector<std::pair<page_id_t, page_id_t>>> levels;
+  if (tree->GetRootPageId() != INVALID_PAGE_ID) {
+    CheckSubtree(bpm, tree->GetRootPageId(), INVALID_PAGE_ID, INT64_MIN, INT64_MAX, &keys, 0, &levels, b_link);
+  }
+  ASSERT_EQ(expected, keys);
+  // Every page links to the next one of its level.
+  for (const auto &level : levels) {
+    for (size_t i = 0; i < level.size(); i++) {
+      ASSERT_EQ(i + 1 == level.size() ? INVALID_PAGE_ID : level[i + 1].first, level[i].second);
+    }
+  }
+  keys.clear();
+  for (auto it = tree->Begin(); !it.IsEnd(); ++it) {
+    keys.push_back((*it).first.ToString());
+    ASSERT_EQ(keys.back(), (*it).second.GetSlotNum());
+  }
+  ASSERT_EQ(expected, keys);
+  // Empty leaves stay in the chain of a B-link tree, a reverse iterator has to look past them.
+  keys.clear();
+  for (auto it = tree->RBegin(); !it.IsEnd(); ++it) {
+    keys.push_back((*it).first.ToString());
+  }
+  ASSERT_EQ(std::vector<int64_t>(expected.rbegin(), expected.rend()), keys);
+  GenericKey<8> index_key;
+  for (auto key : expected) {
+    index_key.SetFromInteger(key);
+    std::vector<RID> result;
+    ASSERT_TRUE(tree->GetValue(index_key, &result));
+    ASSERT_EQ(key, result[0].GetSlotNum());
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,327 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_b_link_test.cpp
+//
+// Identification: test/storage/b_plus_tree_b_link_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+void InsertKeys(TreeType *tree, const std::vector<int64_t> &keys) {
+  GenericKey<8> index_key;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree->Insert(index_key, RID(0, static_cast<uint32_t>(key))));
+  }
+}
+
+TEST(BPlusTreeBLinkTest, StructureTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  for (auto [leaf_max_size, internal_max_size] : {std::pair{2, 3}, {3, 3}, {5, 4}, {16, 9}}) {
+    for (bool shuffle : {false, true}) {
+      SCOPED_TRACE(fmt::format("leaf_max_size={} internal_max_size={} shuffle={}", leaf_max_size,
+                               internal_max_size, shuffle));
+      auto *disk_manager = new DiskManager("test.db");
+      BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+      page_id_t page_id;
+      bpm->NewPage(&page_id);
+      TreeType tree("foo_pk", bpm, comparator, leaf_max_size, internal_max_size, true);
+
+      std::vector<int64_t> keys;
+      for (int64_t key = 0; key < 1000; key++) {
+        keys.push_back(key);
+      }
+      if (shuffle) {
+        std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+      }
+      InsertKeys(&tree, keys);
+      GenericKey<8> index_key;
+      index_key.SetFromInteger(keys[0]);
+      ASSERT_FALSE(tree.Insert(index_key, RID()));
+      std::sort(keys.begin(), keys.end());
+      CheckTree(bpm, &tree, keys, true);
+
+      // Removing leaves pages underfull, or empty, and inserting fills them again.
+      for (int64_t key = 0; key < 1000; key++) {
+        if (key % 3 != 0 || key < 500) {
+          index_key.SetFromInteger(key);
+          tree.Remove(index_key);
+        }
+      }
+      std::vector<int64_t> expected;
+      for (int64_t key = 501; key < 1000; key += 3) {
+        expected.push_back(key);
+      }
+      CheckTree(bpm, &tree, expected, true);
+      InsertKeys(&tree, {0, 1, 2});
+      expected.insert(expected.begin(), {0, 1, 2});
+      CheckTree(bpm, &tree, expected, true);
+
+      bpm->UnpinPage(HEADER_PAGE_ID, true);
+      delete bpm;
+      delete disk_manager;
+      remove("test.db");
+      remove("test.log");
+    }
+  }
+}
+
+using WideTreeType = BPlusTree<GenericKey<64>, RID, GenericComparator<64>>;
+using WideLeafType = BPlusTreeLeafPage<GenericKey<64>, RID, GenericComparator<64>>;
+using WideInternalType = BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
+
+/** @return the depth of the tree and the sizes of its leaves, left to right */
+auto LeafSizes(BufferPoolManager *bpm, WideTreeType *tree, int *depth) -> std::vector<int> {
+  *depth = 1;
+  auto page_id = tree->GetRootPageId();
+  auto *page = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(page_id)->GetData());
+  while (!page->IsLeafPage()) {
+    auto child_page_id = reinterpret_cast<WideInternalType *>(page)->ValueAt(0);
+    bpm->UnpinPage(page_id, false);
+    page_id = child_page_id;
+    page = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(page_id)->GetData());
+    (*depth)++;
+  }
+  std::vector<int> sizes;
+  while (true) {
+    auto *leaf = reinterpret_cast<WideLeafType *>(page);
+    sizes.push_back(leaf->GetSize());
+    auto next_page_id = leaf->GetNextPageId();
+    bpm->UnpinPage(page_id, false);
+    if (next_page_id == INVALID_PAGE_ID) {
+      return sizes;
+    }
+    page_id = next_page_id;
+    page = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(page_id)->GetData());
+  }
+}
+
+TEST(BPlusTreeBLinkTest, CompressedTest) {
+  // Keys with a long common prefix, as in a varchar index, take a few bytes each on a compressed page.
+  Schema schema({Column("name", TypeId::VARCHAR, 32)});
+  GenericComparator<64> comparator(&schema);
+  auto make_key = [&schema](int64_t key) {
+    GenericKey<64> index_key;
+    index_key.SetFromKey(Tuple({ValueFactory::GetVarcharValue(fmt::format("customer_{:06}", key))}, &schema));
+    return index_key;
+  };
+  const int64_t num_keys = 10000;
+  std::vector<int64_t> keys;
+  for (int64_t key = 0; key < num_keys; key++) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(100, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  WideTreeType plain_tree("foo_plain", bpm, comparator);
+  WideTreeType tree("foo_compressed", bpm, comparator, WideLeafType::COMPRESSED_MAX_SIZE,
+                    WideInternalType::COMPRESSED_MAX_SIZE, true, IndexKeyFormat::COMPRESSED);
+  for (auto key : keys) {
+    ASSERT_TRUE(plain_tree.Insert(make_key(key), RID(0, static_cast<uint32_t>(key))));
+    ASSERT_TRUE(tree.Insert(make_key(key), RID(0, static_cast<uint32_t>(key))));
+  }
+  ASSERT_FALSE(tree.Insert(make_key(keys[0]), RID()));
+
+  auto check = [&](const std::vector<int64_t> &expected) {
+    int64_t i = 0;
+    for (auto it = tree.Begin(); !it.IsEnd(); ++it, ++i) {
+      ASSERT_LT(i, expected.size());
+      ASSERT_EQ(0, comparator(make_key(expected[i]), (*it).first));
+      ASSERT_EQ(expected[i], (*it).second.GetSlotNum());
+    }
+    ASSERT_EQ(expected.size(), i);
+    for (auto key : expected) {
+      std::vector<RID> result;
+      ASSERT_TRUE(tree.GetValue(make_key(key), &result));
+      ASSERT_EQ(key, result[0].GetSlotNum());
+    }
+  };
+  std::sort(keys.begin(), keys.end());
+  check(keys);
+
+  // Pages hold more entries than plain ones can, so there are fewer of them.
+  int plain_depth;
+  int depth;
+  auto plain_sizes = LeafSizes(bpm, &plain_tree, &plain_depth);
+  auto sizes = LeafSizes(bpm, &tree, &depth);
+  ASSERT_LE(depth, plain_depth);
+  ASSERT_GT(*std::max_element(sizes.begin(), sizes.end()), *std::max_element(plain_sizes.begin(), plain_sizes.end()));
+  ASSERT_LT(sizes.size() * 3 / 2, plain_sizes.size());
+
+  // Removing and inserting again, keys outside of the common prefix included.
+  std::vector<int64_t> expected;
+  for (int64_t key = 0; key < num_keys; key++) {
+    if (key % 3 == 0) {
+      expected.push_back(key);
+    } else {
+      tree.Remove(make_key(key));
+    }
+  }
+  check(expected);
+  for (int64_t key = 100 * num_keys; key < 100 * num_keys + 500; key++) {
+    ASSERT_TRUE(tree.Insert(make_key(key), RID(0, static_cast<uint32_t>(key))));
+    expected.push_back(key);
+  }
+  check(expected);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeBLinkTest, ConcurrentTest) {
+  // Every thread inserts increasing keys, so they all meet at the rightmost pages, while readers look up the
+  // keys inserted up front.
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(64, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  TreeType tree("foo_pk", bpm, comparator, 4, 4, true);
+
+  const int64_t num_initial_keys = 200;
+  std::vector<int64_t> initial_keys;
+  for (int64_t key = 0; key < num_initial_keys; key++) {
+    initial_keys.push_back(key);
+  }
+  InsertKeys(&tree, initial_keys);
+
+  const int num_writers = 4;
+  const int64_t num_keys_per_writer = 2000;
+  std::atomic<bool> done{false};
+  std::vector<std::thread> writers;
+  for (int i = 0; i < num_writers; i++) {
+    writers.emplace_back([&, i] {
+      GenericKey<8> index_key;
+      for (int64_t j = 0; j < num_keys_per_writer; j++) {
+        auto key = num_initial_keys + j * num_writers + i;
+        index_key.SetFromInteger(key);
+        tree.Insert(index_key, RID(0, static_cast<uint32_t>(key)));
+        // Remove every other initial key on the way, the readers only look for the rest.
+        if (j < num_initial_keys / 2 && j % num_writers == i) {
+          index_key.SetFromInteger(2 * j + 1);
+          tree.Remove(index_key);
+        }
+      }
+    });
+  }
+  std::thread reader([&] {
+    GenericKey<8> index_key;
+    std::vector<GenericKey<8>> index_keys;
+    for (int64_t key = num_initial_keys - 2; key >= 0; key -= 2) {
+      index_key.SetFromInteger(key);
+      index_keys.push_back(index_key);
+    }
+    while (!done) {
+      for (int64_t key = 0; key < num_initial_keys; key += 2) {
+        index_key.SetFromInteger(key);
+        std::vector<RID> result;
+        ASSERT_TRUE(tree.GetValue(index_key, &result));
+        ASSERT_EQ(key, result[0].GetSlotNum());
+      }
+      // The same keys at once, along the leaf chain.
+      std::vector<std::vector<RID>> results;
+      tree.GetValues(index_keys, &results);
+      for (size_t i = 0; i < index_keys.size(); i++) {
+        ASSERT_EQ(1, results[i].size());
+        ASSERT_EQ(index_keys[i].ToString(), results[i][0].GetSlotNum());
+      }
+    }
+  });
+  for (auto &writer : writers) {
+    writer.join();
+  }
+  done = true;
+  reader.join();
+
+  std::vector<int64_t> expected;
+  for (int64_t key = 0; key < num_initial_keys; key += 2) {
+    expected.push_back(key);
+  }
+  for (int64_t key = num_initial_keys; key < num_initial_keys + num_writers * num_keys_per_writer; key++) {
+    expected.push_back(key);
+  }
+  CheckTree(bpm, &tree, expected, true);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeBLinkTest, ConcurrentRootSplitTest) {
+  // Threads start on an empty tree with tiny pages, so the root keeps splitting while the others insert, and a
+  // split often reaches a root that another split is about to replace.
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(4096, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+
+  const int num_rounds = 100;
+  const int num_writers = 8;
+  const int64_t num_keys_per_writer = 40;
+  for (int round = 0; round < num_rounds; round++) {
+    TreeType tree("foo_pk", bpm, comparator, 3, 3, true);
+    std::vector<std::thread> writers;
+    for (int i = 0; i < num_writers; i++) {
+      writers.emplace_back([&, i] {
+        std::vector<int64_t> keys;
+        for (int64_t j = 0; j < num_keys_per_writer; j++) {
+          keys.push_back(j * num_writers + i);
+        }
+        std::shuffle(keys.begin(), keys.end(), std::mt19937(round * num_writers + i));
+        GenericKey<8> index_key;
+        for (auto key : keys) {
+          index_key.SetFromInteger(key);
+          ASSERT_TRUE(tree.Insert(index_key, RID(0, static_cast<uint32_t>(key))));
+        }
+      });
+    }
+    for (auto &writer : writers) {
+      writer.join();
+    }
+
+    std::vector<int64_t> expected(num_writers * num_keys_per_writer);
+    std::iota(expected.begin(), expected.end(), 0);
+    CheckTree(bpm, &tree, expected, true);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
@@ -0,0 +1,296 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_bulk_load_test.cpp
+//
+// Identification: test/storage/b_plus_tree_bulk_load_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+void BulkLoadEvenKeys(TreeType *tree, int64_t num_keys, double fill_factor) {
+  int64_t i = 0;
+  ASSERT_TRUE(tree->BulkLoad(
+      [&i, num_keys](std::pair<GenericKey<8>, RID> *pair) {
+        if (i == num_keys) {
+          return false;
+        }
+        pair->first.SetFromInteger(2 * i);
+        pair->second.Set(static_cast<int32_t>(i >> 32), static_cast<int32_t>(2 * i));
+        i++;
+        return true;
+      },
+      fill_factor));
+}
+
+TEST(BPlusTreeBulkLoadTest, StructureTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  for (auto [leaf_max_size, internal_max_size] : {std::pair{2, 3}, {3, 4}, {5, 5}, {16, 9}}) {
+    for (auto fill_factor : {0.0, 0.7, 1.0}) {
+      for (int64_t num_keys : {0, 1, 2, 3, 7, 8, 9, 31, 100, 257, 1000}) {
+        SCOPED_TRACE(fmt::format("leaf_max_size={} internal_max_size={} fill_factor={} num_keys={}", leaf_max_size,
+                                 internal_max_size, fill_factor, num_keys));
+        auto *disk_manager = new DiskManager("test.db");
+        BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+        page_id_t page_id;
+        bpm->NewPage(&page_id);
+        TreeType tree("foo_pk", bpm, comparator, leaf_max_size, internal_max_size);
+
+        BulkLoadEvenKeys(&tree, num_keys, fill_factor);
+        std::vector<int64_t> expected;
+        for (int64_t i = 0; i < num_keys; i++) {
+          expected.push_back(2 * i);
+        }
+        CheckTree(bpm, &tree, expected);
+        ASSERT_EQ(num_keys == 0, tree.BulkLoad([](auto *pair) { return false; }));
+
+        // The tree keeps working as usual: insert the odd keys, then remove the multiples of 3.
+        for (int64_t key = 1; key < 2 * num_keys; key += 2) {
+          GenericKey<8> index_key;
+          index_key.SetFromInteger(key);
+          ASSERT_TRUE(tree.Insert(index_key, RID(0, static_cast<uint32_t>(key))));
+        }
+        for (int64_t key = 0; key < 2 * num_keys; key += 3) {
+          GenericKey<8> index_key;
+          index_key.SetFromInteger(key);
+          tree.Remove(index_key);
+        }
+        expected.clear();
+        for (int64_t key = 0; key < 2 * num_keys; key++) {
+          if (key % 3 != 0) {
+            expected.push_back(key);
+          }
+        }
+        CheckTree(bpm, &tree, expected);
+
+        bpm->UnpinPage(HEADER_PAGE_ID, true);
+        delete bpm;
+        delete disk_manager;
+        remove("test.db");
+        remove("test.log");
+      }
+    }
+  }
+}
+
+TEST(BPlusTreeBulkLoadTest, CompressedTest) {
+  // Compressed nodes take as many entries as fit, which depends on the keys.
+  Schema schema({Column("name", TypeId::VARCHAR, 32)});
+  GenericComparator<64> comparator(&schema);
+  using WideTreeType = BPlusTree<GenericKey<64>, RID, GenericComparator<64>>;
+  using WideLeafType = BPlusTreeLeafPage<GenericKey<64>, RID, GenericComparator<64>>;
+  using WideInternalType = BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
+  auto make_key = [&schema](int64_t key) {
+    GenericKey<64> index_key;
+    // Some keys are longer than the rest, which widens the entries of their node.
+    auto name = fmt::format("customer_{:06}{}", key, key % 1000 == 998 ? "_suffix" : "");
+    index_key.SetFromKey(Tuple({ValueFactory::GetVarcharValue(name)}, &schema));
+    return index_key;
+  };
+
+  for (auto fill_factor : {0.0, 0.7, 1.0}) {
+    for (int64_t num_keys : {0, 1, 100, 5000}) {
+      SCOPED_TRACE(fmt::format("fill_factor={} num_keys={}", fill_factor, num_keys));
+      auto *disk_manager = new DiskManager("test.db");
+      BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+      page_id_t page_id;
+      bpm->NewPage(&page_id);
+      WideTreeType tree("foo_pk", bpm, comparator, WideLeafType::COMPRESSED_MAX_SIZE,
+                        WideInternalType::COMPRESSED_MAX_SIZE, true, IndexKeyFormat::COMPRESSED);
+      int64_t i = 0;
+      ASSERT_TRUE(tree.BulkLoad(
+          [&](std::pair<GenericKey<64>, RID> *pair) {
+            if (i == num_keys) {
+              return false;
+            }
+            pair->first = make_key(2 * i);
+            pair->second.Set(0, static_cast<uint32_t>(i));
+            i++;
+            return true;
+          },
+          fill_factor));
+
+      auto check = [&](const std::vector<int64_t> &expected) {
+        size_t j = 0;
+        for (auto it = tree.Begin(); !it.IsEnd(); ++it, ++j) {
+          ASSERT_LT(j, expected.size());
+          ASSERT_EQ(0, comparator(make_key(expected[j]), (*it).first));
+        }
+        ASSERT_EQ(expected.size(), j);
+        for (auto key : expected) {
+          std::vector<RID> result;
+          ASSERT_TRUE(tree.GetValue(make_key(key), &result));
+        }
+      };
+      std::vector<int64_t> expected;
+      for (int64_t key = 0; key < num_keys; key++) {
+        expected.push_back(2 * key);
+      }
+      check(expected);
+
+      // The tree keeps working as usual.
+      expected.clear();
+      for (int64_t key = 0; key < 2 * num_keys; key++) {
+        if (key % 2 == 1) {
+          ASSERT_TRUE(tree.Insert(make_key(key), RID(0, static_cast<uint32_t>(key))));
+        }
+        expected.push_back(key);
+      }
+      check(expected);
+
+      bpm->UnpinPage(HEADER_PAGE_ID, true);
+      delete bpm;
+      delete disk_manager;
+      remove("test.db");
+      remove("test.log");
+    }
+  }
+}
+
+TEST(BPlusTreeBulkLoadTest, IndexTest) {
+  // Entries come in any order and with duplicate keys, the first RID of a key is kept.
+  auto schema = ParseCreateStatement("a bigint,b integer");
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  auto metadata = std::make_unique<IndexMetadata>("foo_pk", "foo", schema.get(), std::vector<uint32_t>{0});
+  BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>> index(std::move(metadata), bpm);
+
+  const int num_tuples = 5000;
+  int i = 0;
+  index.BulkLoad(
+      [&](Tuple *key, RID *rid) {
+        if (i == num_tuples) {
+          return false;
+        }
+        // Keys 0..999 five times over, in a scrambled order.
+        auto value = (static_cast<int64_t>(i) * 7919) % 1000;
+        *key = Tuple({ValueFactory::GetBigIntValue(value)}, index.GetKeySchema());
+        rid->Set(num_tuples - i, 0);
+        i++;
+        return true;
+      },
+      nullptr, 0.8);
+
+  for (int64_t value = 0; value < 1000; value++) {
+    std::vector<RID> result;
+    index.ScanKey(Tuple({ValueFactory::GetBigIntValue(value)}, index.GetKeySchema()), &result, nullptr);
+    ASSERT_EQ(1, result.size());
+    // The last of the five tuples with this key has the smallest RID.
+    int last = 0;
+    for (int j = 0; j < num_tuples; j++) {
+      if ((static_cast<int64_t>(j) * 7919) % 1000 == value) {
+        last = j;
+      }
+    }
+    ASSERT_EQ(num_tuples - last, result[0].GetPageId());
+  }
+  std::vector<RID> result;
+  index.ScanKey(Tuple({ValueFactory::GetBigIntValue(1000)}, index.GetKeySchema()), &result, nullptr);
+  ASSERT_TRUE(result.empty());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeBulkLoadTest, NonUniqueIndexTest) {
+  // A non-unique index keeps every entry of a key, and finds them all.
+  auto schema = ParseCreateStatement("a bigint,b integer");
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  auto metadata = std::make_unique<IndexMetadata>("foo_idx", "foo", schema.get(), std::vector<uint32_t>{0}, false);
+  BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>> index(std::move(metadata), bpm);
+  const auto key_of = [&](int64_t value) { return Tuple({ValueFactory::GetBigIntValue(value)}, index.GetKeySchema()); };
+
+  const int num_tuples = 5000;
+  int i = 0;
+  index.BulkLoad(
+      [&](Tuple *key, RID *rid) {
+        if (i == num_tuples) {
+          return false;
+        }
+        // Keys 0..999 five times over, in a scrambled order.
+        *key = key_of((static_cast<int64_t>(i) * 7919) % 1000);
+        rid->Set(num_tuples - i, 0);
+        i++;
+        return true;
+      },
+      nullptr, 0.8);
+
+  for (int64_t value = 0; value < 1000; value++) {
+    std::vector<RID> result;
+    index.ScanKey(key_of(value), &result, nullptr);
+    std::vector<RID> expected;
+    for (int j = num_tuples - 1; j >= 0; j--) {
+      if ((static_cast<int64_t>(j) * 7919) % 1000 == value) {
+        expected.emplace_back(num_tuples - j, 0);
+      }
+    }
+    ASSERT_EQ(expected, result);
+  }
+
+  // Entries are removed and inserted by key and RID.
+  std::vector<RID> result;
+  index.ScanKey(key_of(7), &result, nullptr);
+  ASSERT_EQ(5, result.size());
+  index.DeleteEntry(key_of(7), result[2], nullptr);
+  index.InsertEntry(key_of(7), RID(0, 1), nullptr);
+  index.InsertEntry(key_of(7), RID(0, 1), nullptr);
+  std::vector<RID> after;
+  index.ScanKey(key_of(7), &after, nullptr);
+  ASSERT_EQ((std::vector<RID>{RID(0, 1), result[0], result[1], result[3], result[4]}), after);
+
+  // Range scans take in every entry of their keys.
+  IndexRange range;
+  range.lower_ = ValueFactory::GetIntegerValue(10);
+  range.upper_ = ValueFactory::GetIntegerValue(12);
+  range.upper_inclusive_ = false;
+  for (bool reverse : {false, true}) {
+    range.reverse_ = reverse;
+    std::vector<RID> scanned;
+    for (auto cursor = index.Scan(range, nullptr); !cursor->IsEnd(); cursor->Next()) {
+      scanned.push_back(cursor->GetRID());
+    }
+    std::vector<RID> expected;
+    index.ScanKey(key_of(10), &expected, nullptr);
+    index.ScanKey(key_of(11), &expected, nullptr);
+    if (reverse) {
+      std::reverse(expected.begin(), expected.end());
+    }
+    ASSERT_EQ(expected, scanned);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <atomic>
 #include <chrono>  // NOLINT
 #include <cstdio>
 #include <functional>
@@ -610,6 +611,75 @@ TEST(BPlusTreeConcurrentTest, DISABLED_MixTest) {
   remove("test.log");
 }
 
+TEST(BPlusTreeConcurrentTest, OptimisticReadTest) {
+  // Readers look up the even keys, which stay in the tree, while writers keep inserting and removing the odd keys
+  // around them, splitting and merging the small nodes all the time.
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 3);
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  const int64_t num_keys = 400;
+  std::vector<int64_t> even_keys;
+  std::vector<int64_t> odd_keys;
+  for (int64_t key = 0; key < num_keys; key++) {
+    (key % 2 == 0 ? even_keys : odd_keys).push_back(key);
+  }
+  InsertHelper(&tree, even_keys);
+
+  const int num_writers = 2;
+  const int num_readers = 2;
+  std::atomic<bool> done{false};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_writers; i++) {
+    threads.emplace_back([&, i] {
+      for (int round = 0; round < 20; round++) {
+        InsertHelperSplit(&tree, odd_keys, num_writers, i);
+        DeleteHelperSplit(&tree, odd_keys, num_writers, i);
+      }
+    });
+  }
+  for (int i = 0; i < num_readers; i++) {
+    threads.emplace_back([&] {
+      GenericKey<8> index_key;
+      while (!done) {
+        for (auto key : even_keys) {
+          index_key.SetFromInteger(key);
+          std::vector<RID> result;
+          ASSERT_TRUE(tree.GetValue(index_key, &result));
+          ASSERT_EQ(1, result.size());
+          ASSERT_EQ(key, result[0].GetSlotNum());
+          auto iterator = tree.Begin(index_key);
+          ASSERT_FALSE(iterator.IsEnd());
+        }
+      }
+    });
+  }
+  for (int i = 0; i < num_writers; i++) {
+    threads[i].join();
+  }
+  done = true;
+  for (int i = num_writers; i < num_writers + num_readers; i++) {
+    threads[i].join();
+  }
+
+  std::vector<int64_t> keys;
+  for (auto iterator = tree.Begin(); !iterator.IsEnd(); ++iterator) {
+    keys.push_back((*iterator).first.ToString());
+  }
+  EXPECT_EQ(even_keys, keys);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
 TEST(BPlusTreeConcurrentTest, BenchTest) {
   std::vector<std::chrono::milliseconds> times;
   int64_t total_time = 0;
@@ -12,6 +12,8 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <random>
+#include <vector>
 
 #include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
@@ -270,4 +272,163 @@ TEST(BPlusTreeTests, InsertTest3) {
   remove("test.db");
   remove("test.log");
 }
+
+TEST(BPlusTreeTests, RangeIteratorTest) {
+  // Iterators start from keys that may not be in the tree, and run both ways.
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  for (bool b_link : {false, true}) {
+    SCOPED_TRACE(fmt::format("b_link={}", b_link));
+    auto *disk_manager = new DiskManager("test.db");
+    BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+    page_id_t page_id;
+    bpm->NewPage(&page_id);
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4, b_link);
+    GenericKey<8> index_key;
+
+    index_key.SetFromInteger(0);
+    ASSERT_TRUE(tree.Begin(index_key).IsEnd());
+    ASSERT_TRUE(tree.RBegin().IsEnd());
+    ASSERT_TRUE(tree.RBegin(index_key).IsEnd());
+
+    std::vector<int64_t> keys;
+    for (int64_t key = 0; key < 300; key += 3) {
+      keys.push_back(key);
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+    for (auto key : keys) {
+      index_key.SetFromInteger(key);
+      tree.Insert(index_key, RID(0, static_cast<uint32_t>(key)));
+    }
+
+    for (int64_t start = -2; start < 302; start++) {
+      index_key.SetFromInteger(start);
+      // Forward from the first key not less than start.
+      auto expected = std::clamp<int64_t>((start + 2) / 3 * 3, 0, 300);
+      auto count = 0;
+      for (auto iterator = tree.Begin(index_key); !iterator.IsEnd(); ++iterator, expected += 3, count++) {
+        ASSERT_EQ(expected, (*iterator).first.ToString());
+        ASSERT_EQ(expected, (*iterator).second.GetSlotNum());
+      }
+      ASSERT_EQ(300, expected);
+      // Backward from the last key not greater than start.
+      expected = start < 0 ? -3 : std::min<int64_t>(start / 3 * 3, 297);
+      for (auto iterator = tree.RBegin(index_key); !iterator.IsEnd(); ++iterator, expected -= 3, count++) {
+        ASSERT_EQ(expected, (*iterator).first.ToString());
+      }
+      ASSERT_EQ(-3, expected);
+      ASSERT_EQ(keys.size() + (start % 3 == 0 && start >= 0 && start < 300 ? 1 : 0), count);
+    }
+
+    bpm->UnpinPage(HEADER_PAGE_ID, true);
+    delete bpm;
+    delete disk_manager;
+    remove("test.db");
+    remove("test.log");
+  }
+}
+
+TEST(BPlusTreeTests, GetValuesTest) {
+  // A batch of keys, present or not, repeated and in any order, gets the same answers as one lookup per key.
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  for (bool b_link : {false, true}) {
+    SCOPED_TRACE(fmt::format("b_link={}", b_link));
+    auto *disk_manager = new DiskManager("test.db");
+    BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+    page_id_t page_id;
+    bpm->NewPage(&page_id);
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4, b_link);
+    GenericKey<8> index_key;
+
+    std::vector<std::vector<RID>> results;
+    tree.GetValues({index_key}, &results);
+    ASSERT_EQ(1, results.size());
+    ASSERT_TRUE(results[0].empty());
+
+    for (int64_t key = 0; key < 1000; key += 2) {
+      index_key.SetFromInteger(key);
+      tree.Insert(index_key, RID(0, static_cast<uint32_t>(key)));
+    }
+    std::mt19937 rng(15445);
+    for (size_t batch_size : {1, 2, 7, 100, 2000}) {
+      std::vector<int64_t> keys;
+      std::vector<GenericKey<8>> index_keys;
+      for (size_t i = 0; i < batch_size; i++) {
+        // Mostly close keys, which share leaves, and some far apart.
+        auto key = i % 5 == 0 ? static_cast<int64_t>(rng() % 1200) - 100 : static_cast<int64_t>(rng() % 40) + 300;
+        keys.push_back(key);
+        index_key.SetFromInteger(key);
+        index_keys.push_back(index_key);
+      }
+      tree.GetValues(index_keys, &results);
+      ASSERT_EQ(batch_size, results.size());
+      for (size_t i = 0; i < batch_size; i++) {
+        std::vector<RID> expected;
+        tree.GetValue(index_keys[i], &expected);
+        ASSERT_EQ(expected, results[i]);
+        ASSERT_EQ(keys[i] >= 0 && keys[i] < 1000 && keys[i] % 2 == 0, !results[i].empty());
+      }
+    }
+
+    bpm->UnpinPage(HEADER_PAGE_ID, true);
+    delete bpm;
+    delete disk_manager;
+    remove("test.db");
+    remove("test.log");
+  }
+}
+
+TEST(BPlusTreeTests, GetValueRangesTest) {
+  // A batch of ranges, each over several leaves, gets the same answers as a scan per range.
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  // The range of a key are the keys from it on with the same tens digit.
+  auto in_range = [](const GenericKey<8> &entry_key, const GenericKey<8> &key) {
+    return entry_key.ToString() / 10 == key.ToString() / 10;
+  };
+
+  for (bool b_link : {false, true}) {
+    SCOPED_TRACE(fmt::format("b_link={}", b_link));
+    auto *disk_manager = new DiskManager("test.db");
+    BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+    page_id_t page_id;
+    bpm->NewPage(&page_id);
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4, b_link);
+    GenericKey<8> index_key;
+
+    for (int64_t key = 0; key < 1000; key += 2) {
+      index_key.SetFromInteger(key);
+      tree.Insert(index_key, RID(0, static_cast<uint32_t>(key)));
+    }
+    std::mt19937 rng(15445);
+    for (size_t batch_size : {1, 2, 7, 100, 2000}) {
+      std::vector<GenericKey<8>> index_keys;
+      for (size_t i = 0; i < batch_size; i++) {
+        // Mostly neighbouring ranges, which share leaves, and some far apart.
+        auto key = i % 5 == 0 ? static_cast<int64_t>(rng() % 1200) - 100 : static_cast<int64_t>(rng() % 40) + 300;
+        index_key.SetFromInteger(key);
+        index_keys.push_back(index_key);
+      }
+      std::vector<std::vector<RID>> results;
+      tree.GetValues(index_keys, &results, nullptr, in_range);
+      ASSERT_EQ(batch_size, results.size());
+      for (size_t i = 0; i < batch_size; i++) {
+        std::vector<RID> expected;
+        for (auto it = tree.Begin(index_keys[i]); !it.IsEnd() && in_range((*it).first, index_keys[i]); ++it) {
+          expected.push_back((*it).second);
+        }
+        ASSERT_EQ(expected, results[i]);
+      }
+    }
+
+    bpm->UnpinPage(HEADER_PAGE_ID, true);
+    delete bpm;
+    delete disk_manager;
+    remove("test.db");
+    remove("test.log");
+  }
+}
 }  // namespace bustub
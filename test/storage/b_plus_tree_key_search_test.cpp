@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_key_search_test.cpp
+//
+// Identification: test/storage/b_plus_tree_key_search_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/b_plus_tree_key_search.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "common/rid.h"
+#include "gtest/gtest.h"
+#include "storage/index/generic_key.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+/**
+ * Search sorted arrays of every size up to 200 for keys in and between their
+ * entries, and check against std::lower_bound / std::upper_bound.
+ */
+template <typename IntType, size_t KeySize, typename ValueType>
+void CheckKeySearch(const char *schema, TypeId expected_type) {
+  auto key_schema = ParseCreateStatement(schema);
+  GenericComparator<KeySize> comparator(key_schema.get());
+  ASSERT_EQ(expected_type, comparator.GetIntegerKeyType());
+
+  auto to_key = [](IntType i) {
+    GenericKey<KeySize> key;
+    memset(key.data_, 0, KeySize);
+    memcpy(key.data_, &i, sizeof(i));
+    return key;
+  };
+
+  std::mt19937_64 rng(15445);
+  for (int size = 0; size <= 200; ++size) {
+    std::set<IntType> ints;
+    while (static_cast<int>(ints.size()) < size) {
+      ints.insert(static_cast<IntType>(rng() % 1000) - 500);
+    }
+    if (size > 0) {
+      ints.erase(ints.begin());
+      ints.insert(std::numeric_limits<IntType>::min() + 1);
+    }
+    std::vector<IntType> sorted(ints.begin(), ints.end());
+    std::vector<std::pair<GenericKey<KeySize>, ValueType>> array;
+    for (auto i : sorted) {
+      array.emplace_back(to_key(i), ValueType{});
+    }
+    for (IntType probe : {static_cast<IntType>(-501), static_cast<IntType>(0), static_cast<IntType>(499),
+                          static_cast<IntType>(500), std::numeric_limits<IntType>::max(),
+                          static_cast<IntType>(std::numeric_limits<IntType>::min() + 1)}) {
+      auto lower = std::lower_bound(sorted.begin(), sorted.end(), probe) - sorted.begin();
+      auto upper = std::upper_bound(sorted.begin(), sorted.end(), probe) - sorted.begin();
+      ASSERT_EQ(lower, KeySearch(array.data(), 0, size, to_key(probe), comparator));
+      ASSERT_EQ(upper, KeySearch(array.data(), 0, size, to_key(probe), comparator, true));
+    }
+    for (int i = 0; i < size; ++i) {
+      ASSERT_EQ(i, KeySearch(array.data(), 0, size, to_key(sorted[i]), comparator));
+      ASSERT_EQ(i + 1, KeySearch(array.data(), 0, size, to_key(sorted[i]), comparator, true));
+      // Internal pages search from index 1.
+      if (i > 0) {
+        ASSERT_EQ(i, KeySearch(array.data(), 1, size, to_key(sorted[i]), comparator));
+      }
+    }
+  }
+}
+
+TEST(BPlusTreeKeySearchTest, IntegerKeyTest) {
+  // Leaf pairs (12 bytes) and internal pairs (8 bytes).
+  CheckKeySearch<int32_t, 8, RID>("a integer", TypeId::INTEGER);
+  CheckKeySearch<int32_t, 4, page_id_t>("a integer", TypeId::INTEGER);
+}
+
+TEST(BPlusTreeKeySearchTest, BigintKeyTest) {
+  CheckKeySearch<int64_t, 8, RID>("a bigint", TypeId::BIGINT);
+  CheckKeySearch<int64_t, 8, page_id_t>("a bigint", TypeId::BIGINT);
+}
+
+TEST(BPlusTreeKeySearchTest, GenericKeyTest) {
+  // Two columns go through the comparator, the second one is always 0.
+  CheckKeySearch<int64_t, 16, RID>("a bigint,b bigint", TypeId::INVALID);
+}
+
+}  // namespace bustub
@@ -15,6 +15,7 @@
 #include "common/exception.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/page/page.h"
 
 namespace bustub {
 
@@ -55,6 +56,32 @@ TEST_F(DiskManagerTest, ReadWritePageTest) {
   dm.ShutDown();
 }
 
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, DirectIOReadWritePageTest) {
+  Page page;
+  char buf[BUSTUB_PAGE_SIZE + 1] = {0};
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file, true);
+  std::strncpy(page.GetData(), "A test string.", BUSTUB_PAGE_SIZE);
+
+  dm.ReadPage(3, page.GetData());  // pages past the end of the file read back as zeros
+  EXPECT_EQ(page.GetData()[0], 0);
+
+  std::strncpy(page.GetData(), "A test string.", BUSTUB_PAGE_SIZE);
+  dm.WritePage(3, page.GetData());
+  // unaligned buffers are accepted as well
+  dm.ReadPage(3, buf + 1);
+  EXPECT_EQ(std::memcmp(buf + 1, page.GetData(), BUSTUB_PAGE_SIZE), 0);
+
+  buf[1] = 'B';
+  dm.WritePage(4, buf + 1);
+  dm.ReadPage(4, page.GetData());
+  EXPECT_EQ(std::memcmp(buf + 1, page.GetData(), BUSTUB_PAGE_SIZE), 0);
+  EXPECT_EQ(dm.GetNumWrites(), 2);
+
+  dm.ShutDown();
+}
+
 // NOLINTNEXTLINE
 TEST_F(DiskManagerTest, ReadWriteLogTest) {
   char buf[16] = {0};
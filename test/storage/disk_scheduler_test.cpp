@@ -0,0 +1,101 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler_test.cpp
+//
+// Identification: test/storage/disk_scheduler_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <cstring>
+#include <future>  // NOLINT
+#include <memory>
+#include <vector>
+
+#include "common/exception.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_scheduler.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(DiskSchedulerTest, ScheduleWriteReadPageTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+
+  auto dm = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto disk_scheduler = std::make_unique<DiskScheduler>(dm.get());
+
+  std::strncpy(data, "A test string.", sizeof(data));
+
+  auto promise1 = disk_scheduler->CreatePromise();
+  auto future1 = promise1.get_future();
+  auto promise2 = disk_scheduler->CreatePromise();
+  auto future2 = promise2.get_future();
+
+  disk_scheduler->Schedule({/*is_write=*/true, data, /*page_id=*/0, std::move(promise1)});
+  ASSERT_TRUE(future1.get());
+  disk_scheduler->Schedule({/*is_write=*/false, buf, /*page_id=*/0, std::move(promise2)});
+  ASSERT_TRUE(future2.get());
+
+  ASSERT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+
+  disk_scheduler = nullptr;  // Call the DiskScheduler destructor to finish all scheduled jobs.
+  dm->ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST(DiskSchedulerTest, BatchKeepsRequestsInFlightTest) {
+  const size_t num_workers = 4;
+
+  /** A disk whose reads only return once `num_workers` of them are in flight at the same time. */
+  class RendezvousDiskManager : public DiskManagerUnlimitedMemory {
+   public:
+    void ReadPage(page_id_t page_id, char *page_data) override {
+      std::unique_lock lock(mutex_);
+      ++in_flight_;
+      cv_.notify_all();
+      cv_.wait(lock, [this] { return in_flight_ >= num_workers; });
+      lock.unlock();
+      DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+    }
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    size_t in_flight_{0};
+  };
+
+  auto dm = std::make_unique<RendezvousDiskManager>();
+  auto disk_scheduler = std::make_unique<DiskScheduler>(dm.get(), num_workers);
+  ASSERT_EQ(num_workers, disk_scheduler->GetNumWorkers());
+
+  std::vector<std::array<char, BUSTUB_PAGE_SIZE>> pages(num_workers);
+  for (size_t i = 0; i < num_workers; ++i) {
+    snprintf(pages[i].data(), BUSTUB_PAGE_SIZE, "page %zu", i);
+    dm->WritePage(static_cast<page_id_t>(i), pages[i].data());
+  }
+
+  // Scenario: every read of the batch has to be outstanding at once, otherwise none of them completes.
+  std::vector<std::array<char, BUSTUB_PAGE_SIZE>> bufs(num_workers);
+  std::vector<DiskRequest> requests;
+  std::vector<std::future<bool>> futures;
+  for (size_t i = 0; i < num_workers; ++i) {
+    auto promise = disk_scheduler->CreatePromise();
+    futures.emplace_back(promise.get_future());
+    requests.push_back({false, bufs[i].data(), static_cast<page_id_t>(i), std::move(promise)});
+  }
+  disk_scheduler->Schedule(std::move(requests));
+  for (size_t i = 0; i < num_workers; ++i) {
+    ASSERT_TRUE(futures[i].get());
+    ASSERT_EQ(0, std::memcmp(pages[i].data(), bufs[i].data(), BUSTUB_PAGE_SIZE));
+  }
+
+  disk_scheduler = nullptr;
+  dm->ShutDown();
+}
+
+}  // namespace bustub
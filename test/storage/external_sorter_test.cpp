@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// external_sorter_test.cpp
+//
+// Identification: test/storage/external_sorter_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/external_sorter.h"
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+/** Sort num_items random numbers with the given memory, and check against std::sort. */
+void CheckSort(size_t num_items, size_t memory_limit, size_t expected_runs) {
+  ExternalSorter<int64_t, std::less<>> sorter(std::less<>{}, memory_limit);
+  std::mt19937_64 rng(15445);
+  std::vector<int64_t> expected;
+  for (size_t i = 0; i < num_items; i++) {
+    // Few distinct values, so that equal items meet in the merge.
+    auto item = static_cast<int64_t>(rng() % 1000) - 500;
+    sorter.Add(item);
+    expected.push_back(item);
+  }
+  sorter.Sort();
+  ASSERT_EQ(expected_runs, sorter.GetNumRuns());
+  std::sort(expected.begin(), expected.end());
+
+  std::vector<int64_t> result;
+  int64_t item;
+  while (sorter.Next(&item)) {
+    result.push_back(item);
+  }
+  ASSERT_EQ(expected, result);
+  ASSERT_FALSE(sorter.Next(&item));
+}
+
+TEST(ExternalSorterTest, InMemoryTest) {
+  CheckSort(0, 1024, 0);
+  CheckSort(100, 1024, 0);
+}
+
+TEST(ExternalSorterTest, SpillTest) {
+  // 128 items per run; the last run is full too, or stays in memory.
+  CheckSort(128 * 10, 1024, 10);
+  CheckSort(128 * 10 + 1, 1024, 10);
+  CheckSort(100000, 1024, 781);
+  // One item per run.
+  CheckSort(50, 1, 50);
+}
+
+}  // namespace bustub
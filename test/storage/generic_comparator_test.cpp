@@ -0,0 +1,142 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// generic_comparator_test.cpp
+//
+// Identification: test/storage/generic_comparator_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "gtest/gtest.h"
+#include "storage/index/generic_key.h"
+#include "storage/table/tuple.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/** Compare the keys the way the comparator did before, one Value at a time. */
+template <size_t KeySize>
+auto CompareByValue(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs, Schema *schema) -> int {
+  for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+    auto lhs_value = lhs.ToValue(schema, i);
+    auto rhs_value = rhs.ToValue(schema, i);
+    if (lhs_value.CompareLessThan(rhs_value) == CmpBool::CmpTrue) {
+      return -1;
+    }
+    if (lhs_value.CompareGreaterThan(rhs_value) == CmpBool::CmpTrue) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/** Compare random pairs of non-NULL keys with the comparator and with Values. */
+template <size_t KeySize>
+void CheckAgainstValues(Schema *schema, const std::function<std::vector<Value>(std::mt19937 *)> &make_values) {
+  GenericComparator<KeySize> comparator(schema);
+  std::mt19937 rng(15445);
+  std::vector<GenericKey<KeySize>> keys(64);
+  for (auto &key : keys) {
+    key.SetFromKey(Tuple(make_values(&rng), schema));
+  }
+  for (const auto &lhs : keys) {
+    for (const auto &rhs : keys) {
+      ASSERT_EQ(CompareByValue(lhs, rhs, schema), comparator(lhs, rhs));
+    }
+  }
+}
+
+TEST(GenericComparatorTest, FixedWidthTest) {
+  Schema int_schema({Column("a", TypeId::INTEGER)});
+  CheckAgainstValues<8>(&int_schema, [](std::mt19937 *rng) {
+    return std::vector<Value>{ValueFactory::GetIntegerValue(static_cast<int32_t>((*rng)() % 64) - 32)};
+  });
+  ASSERT_EQ(TypeId::INTEGER, GenericComparator<8>(&int_schema).GetIntegerKeyType());
+
+  Schema bigint_schema({Column("a", TypeId::BIGINT)});
+  CheckAgainstValues<8>(&bigint_schema, [](std::mt19937 *rng) {
+    return std::vector<Value>{ValueFactory::GetBigIntValue(static_cast<int64_t>((*rng)() % 64) - (1LL << 40))};
+  });
+  ASSERT_EQ(TypeId::BIGINT, GenericComparator<8>(&bigint_schema).GetIntegerKeyType());
+
+  // Few distinct values per column, so that later columns decide often.
+  Schema mixed_schema({Column("a", TypeId::SMALLINT), Column("b", TypeId::BOOLEAN), Column("c", TypeId::DECIMAL),
+                       Column("d", TypeId::TINYINT), Column("e", TypeId::INTEGER)});
+  CheckAgainstValues<32>(&mixed_schema, [](std::mt19937 *rng) {
+    return std::vector<Value>{ValueFactory::GetSmallIntValue(static_cast<int16_t>((*rng)() % 3) - 1),
+                              ValueFactory::GetBooleanValue((*rng)() % 2 == 0),
+                              ValueFactory::GetDecimalValue(static_cast<double>((*rng)() % 3) / 2 - 0.5),
+                              ValueFactory::GetTinyIntValue(static_cast<int8_t>((*rng)() % 3)),
+                              ValueFactory::GetIntegerValue(static_cast<int32_t>((*rng)() % 3))};
+  });
+  ASSERT_EQ(TypeId::INVALID, GenericComparator<32>(&mixed_schema).GetIntegerKeyType());
+}
+
+TEST(GenericComparatorTest, VarcharTest) {
+  // (tenant_id, name): the varchar data follows the fixed-size part of the key.
+  Schema schema({Column("tenant_id", TypeId::INTEGER), Column("name", TypeId::VARCHAR, 16)});
+  const std::vector<std::string> names = {"", "a", "ab", "abc", "b", "ba", "zz"};
+  CheckAgainstValues<64>(&schema, [&names](std::mt19937 *rng) {
+    return std::vector<Value>{ValueFactory::GetIntegerValue(static_cast<int32_t>((*rng)() % 2)),
+                              ValueFactory::GetVarcharValue(names[(*rng)() % names.size()])};
+  });
+}
+
+TEST(GenericComparatorTest, SeparatorTest) {
+  // A separator sorts after lhs and not after rhs, and cuts the first varchar the keys differ in short.
+  Schema schema({Column("tenant_id", TypeId::INTEGER), Column("name", TypeId::VARCHAR, 16)});
+  GenericComparator<64> comparator(&schema);
+  auto make_key = [&schema](int32_t tenant_id, const std::string &name) {
+    GenericKey<64> key;
+    key.SetFromKey(Tuple({ValueFactory::GetIntegerValue(tenant_id), ValueFactory::GetVarcharValue(name)}, &schema));
+    return key;
+  };
+  auto check = [&](const GenericKey<64> &lhs, const GenericKey<64> &rhs, const std::string &name) {
+    auto separator = comparator.Separator(lhs, rhs);
+    ASSERT_LT(comparator(lhs, separator), 0);
+    ASSERT_LE(comparator(separator, rhs), 0);
+    ASSERT_EQ(name, separator.ToValue(&schema, 1).GetAs<char *>());
+  };
+  check(make_key(0, "customer_0041"), make_key(0, "customer_0052"), "customer_005");
+  check(make_key(0, "customer_0041"), make_key(0, "customer_0042"), "customer_0042");
+  check(make_key(0, "ab"), make_key(0, "abc"), "abc");
+  check(make_key(0, "ab"), make_key(0, "abcdef"), "abc");
+  check(make_key(0, ""), make_key(0, "xyz"), "x");
+  // The keys differ in the integer first, the name is kept.
+  check(make_key(0, "zz"), make_key(1, "abc"), "abc");
+  // Separators of keys that share a prefix are the same up to their last character.
+  auto separator = comparator.Separator(make_key(0, "customer_0041"), make_key(0, "customer_0052"));
+  ASSERT_EQ(0, comparator(separator, make_key(0, "customer_005")));
+  ASSERT_EQ(0, memcmp(separator.data_, make_key(0, "customer_005").data_, 64));
+}
+
+TEST(GenericComparatorTest, NullTest) {
+  // NULLs sort before every other value, and equal to each other.
+  Schema schema({Column("a", TypeId::VARCHAR, 8), Column("b", TypeId::INTEGER)});
+  GenericComparator<32> comparator(&schema);
+  auto make_key = [&schema](const Value &a, const Value &b) {
+    GenericKey<32> key;
+    key.SetFromKey(Tuple({a, b}, &schema));
+    return key;
+  };
+  auto null_varchar = ValueFactory::GetNullValueByType(TypeId::VARCHAR);
+  auto null_integer = ValueFactory::GetNullValueByType(TypeId::INTEGER);
+  auto empty = ValueFactory::GetVarcharValue("");
+  auto one = ValueFactory::GetIntegerValue(1);
+  ASSERT_EQ(-1, comparator(make_key(null_varchar, one), make_key(empty, one)));
+  ASSERT_EQ(1, comparator(make_key(empty, one), make_key(null_varchar, one)));
+  ASSERT_EQ(0, comparator(make_key(null_varchar, one), make_key(null_varchar, one)));
+  ASSERT_EQ(-1, comparator(make_key(empty, null_integer), make_key(empty, ValueFactory::GetIntegerValue(-1000))));
+}
+
+}  // namespace bustub
@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/frame_replacer.h"
+#include "common/exception.h"
+#include "fmt/core.h"
+
+using bustub::frame_id_t;
+using bustub::page_id_t;
+using bustub::ReplacerPolicy;
+
+static const std::vector<ReplacerPolicy> ALL_POLICIES = {ReplacerPolicy::LRU_K, ReplacerPolicy::TWO_Q,
+                                                         ReplacerPolicy::ARC, ReplacerPolicy::CLOCK_PRO};
+
+/** Page ids drawn from a Zipf distribution over [0, num_pages), page 0 being the hottest. */
+class ZipfGenerator {
+ public:
+  ZipfGenerator(size_t num_pages, double theta, uint64_t seed) : cdf_(num_pages), rng_(seed) {
+    double sum = 0;
+    for (size_t i = 0; i < num_pages; ++i) {
+      sum += 1.0 / std::pow(static_cast<double>(i + 1), theta);
+      cdf_[i] = sum;
+    }
+    for (auto &p : cdf_) {
+      p /= sum;
+    }
+  }
+
+  auto Next() -> page_id_t {
+    auto u = std::uniform_real_distribution<double>(0, 1)(rng_);
+    return static_cast<page_id_t>(std::lower_bound(cdf_.begin(), cdf_.end(), u) - cdf_.begin());
+  }
+
+ private:
+  std::vector<double> cdf_;
+  std::mt19937_64 rng_;
+};
+
+/** Skewed point lookups over ten times as many pages as frames. */
+auto ZipfTrace(size_t num_frames, size_t num_accesses) -> std::vector<page_id_t> {
+  ZipfGenerator zipf(num_frames * 10, 0.9, 15445);
+  std::vector<page_id_t> trace(num_accesses);
+  for (auto &page_id : trace) {
+    page_id = zipf.Next();
+  }
+  return trace;
+}
+
+/** Lookups on a hot set half the pool's size, interrupted by sequential scans of four times the pool. */
+auto ScanTrace(size_t num_frames, size_t num_accesses) -> std::vector<page_id_t> {
+  ZipfGenerator zipf(num_frames / 2, 0.5, 15445);
+  auto scan_length = static_cast<page_id_t>(num_frames * 4);
+  auto next_scan_page = static_cast<page_id_t>(num_frames);
+  std::vector<page_id_t> trace;
+  trace.reserve(num_accesses);
+  while (trace.size() < num_accesses) {
+    for (size_t i = 0; i < num_frames * 2 && trace.size() < num_accesses; ++i) {
+      trace.push_back(zipf.Next());
+    }
+    // Every scan reads pages nobody has seen before, like a table scan over a growing heap.
+    for (page_id_t i = 0; i < scan_length && trace.size() < num_accesses; ++i) {
+      trace.push_back(next_scan_page++);
+    }
+  }
+  return trace;
+}
+
+/** A loop over 1.5 times as many pages as frames, the worst case of LRU. */
+auto LoopTrace(size_t num_frames, size_t num_accesses) -> std::vector<page_id_t> {
+  auto loop_length = num_frames * 3 / 2;
+  std::vector<page_id_t> trace(num_accesses);
+  for (size_t i = 0; i < num_accesses; ++i) {
+    trace[i] = static_cast<page_id_t>(i % loop_length);
+  }
+  return trace;
+}
+
+/** One page id per line, or whitespace separated. */
+auto ReadTrace(const std::string &file_name) -> std::vector<page_id_t> {
+  std::ifstream in(file_name);
+  if (!in.is_open()) {
+    throw bustub::Exception(fmt::format("cannot open trace file {}", file_name));
+  }
+  std::vector<page_id_t> trace;
+  page_id_t page_id;
+  while (in >> page_id) {
+    trace.push_back(page_id);
+  }
+  return trace;
+}
+
+struct ReplayResult {
+  size_t hits_{0};
+  double ns_per_op_{0};
+};
+
+/**
+ * Replay a trace the way BufferPoolManagerInstance drives its replacer: every
+ * access pins and unpins the page, a miss takes a free frame or evicts one.
+ */
+auto Replay(ReplacerPolicy policy, size_t num_frames, size_t k, const std::vector<page_id_t> &trace) -> ReplayResult {
+  auto replacer = bustub::MakeFrameReplacer(policy, num_frames, k);
+  std::unordered_map<page_id_t, frame_id_t> page_table;
+  std::vector<page_id_t> frame_pages(num_frames, bustub::INVALID_PAGE_ID);
+  std::list<frame_id_t> free_list;
+  for (size_t i = 0; i < num_frames; ++i) {
+    free_list.push_back(static_cast<frame_id_t>(i));
+  }
+  ReplayResult result;
+  auto start = std::chrono::steady_clock::now();
+  for (auto page_id : trace) {
+    frame_id_t frame_id;
+    auto it = page_table.find(page_id);
+    if (it != page_table.end()) {
+      frame_id = it->second;
+      result.hits_++;
+    } else {
+      if (!free_list.empty()) {
+        frame_id = free_list.front();
+        free_list.pop_front();
+      } else {
+        if (!replacer->Evict(&frame_id)) {
+          throw bustub::Exception("replacer found no victim although every frame is unpinned");
+        }
+        page_table.erase(frame_pages[frame_id]);
+      }
+      page_table[page_id] = frame_id;
+      frame_pages[frame_id] = page_id;
+    }
+    replacer->RecordAccess(frame_id, page_id);
+    replacer->SetEvictable(frame_id, false);
+    replacer->SetEvictable(frame_id, true);
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  result.ns_per_op_ =
+      static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / trace.size();
+  return result;
+}
+
+auto ParsePolicies(const std::string &name) -> std::vector<ReplacerPolicy> {
+  if (name == "all") {
+    return ALL_POLICIES;
+  }
+  for (auto policy : ALL_POLICIES) {
+    if (bustub::ReplacerPolicyToString(policy) == name) {
+      return {policy};
+    }
+  }
+  throw bustub::Exception(fmt::format("unknown policy: {}", name));
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-replacer-bench");
+  program.add_argument("--trace").help("file of page ids to replay, one access per line");
+  program.add_argument("--workload").help("synthetic trace when no --trace is given: zipf, scan, loop or all");
+  program.add_argument("--frames").help("number of buffer pool frames");
+  program.add_argument("--accesses").help("length of the synthetic traces");
+  program.add_argument("--policy").help("lru-k, 2q, arc, clock-pro or all");
+  program.add_argument("--k").help("lookback constant of lru-k");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t num_frames = 1024;
+  size_t num_accesses = 1000000;
+  size_t k = bustub::LRUK_REPLACER_K;
+  std::string workload = "all";
+  std::string policy_name = "all";
+  if (program.present("--frames")) {
+    num_frames = std::stoul(program.get("--frames"));
+  }
+  if (program.present("--accesses")) {
+    num_accesses = std::stoul(program.get("--accesses"));
+  }
+  if (program.present("--k")) {
+    k = std::stoul(program.get("--k"));
+  }
+  if (program.present("--workload")) {
+    workload = program.get("--workload");
+  }
+  if (program.present("--policy")) {
+    policy_name = program.get("--policy");
+  }
+
+  std::vector<std::pair<std::string, std::vector<page_id_t>>> traces;
+  if (program.present("--trace")) {
+    traces.emplace_back(program.get("--trace"), ReadTrace(program.get("--trace")));
+  } else {
+    if (workload == "all" || workload == "zipf") {
+      traces.emplace_back("zipf", ZipfTrace(num_frames, num_accesses));
+    }
+    if (workload == "all" || workload == "scan") {
+      traces.emplace_back("scan", ScanTrace(num_frames, num_accesses));
+    }
+    if (workload == "all" || workload == "loop") {
+      traces.emplace_back("loop", LoopTrace(num_frames, num_accesses));
+    }
+    if (traces.empty()) {
+      std::cerr << "unknown workload: " << workload << std::endl;
+      return 1;
+    }
+  }
+  auto policies = ParsePolicies(policy_name);
+
+  fmt::print("{:<12} {:<10} {:>10} {:>10} {:>10}\n", "trace", "policy", "accesses", "hit ratio", "ns/op");
+  for (const auto &[trace_name, trace] : traces) {
+    if (trace.empty()) {
+      continue;
+    }
+    for (auto policy : policies) {
+      auto result = Replay(policy, num_frames, k, trace);
+      fmt::print("{:<12} {:<10} {:>10} {:>10.4f} {:>10.1f}\n", trace_name, bustub::ReplacerPolicyToString(policy),
+                 trace.size(), static_cast<double>(result.hits_) / trace.size(), result.ns_per_op_);
+    }
+  }
+  return 0;
+}
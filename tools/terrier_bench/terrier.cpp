@@ -120,6 +120,7 @@ auto main(int argc, char **argv) -> int {
   program.add_argument("--duration").help("run terrier bench for n milliseconds");
   program.add_argument("--force-create-index").help("create index in terrier bench");
   program.add_argument("--force-enable-update").help("use update statement in terrier bench");
+  program.add_argument("--bpm-instances").help("number of buffer pool shards in terrier bench");
 
   try {
     program.parse_args(argc, argv);
@@ -129,7 +130,15 @@ auto main(int argc, char **argv) -> int {
     return 1;
   }
 
-  auto bustub = std::make_unique<bustub::BustubInstance>();
+  size_t bpm_instances = BUSTUB_TERRIER_THREAD;
+
+  if (program.present("--bpm-instances")) {
+    bpm_instances = std::stoi(program.get("--bpm-instances"));
+  }
+
+  std::cerr << "x: buffer pool with " << bpm_instances << " instances" << std::endl;
+
+  auto bustub = std::make_unique<bustub::BustubInstance>(bpm_instances);
   auto writer = bustub::SimpleStreamWriter(std::cerr);
 
   // create schema
@@ -150,9 +159,11 @@ auto main(int argc, char **argv) -> int {
   }
 
   if (enable_index) {
-    auto schema = "CREATE INDEX nftid on nft(id);";
+    auto schema = "CREATE UNIQUE INDEX nftid on nft(id);";
     std::cerr << "x: create index" << std::endl;
     bustub->ExecuteSql(schema, writer);
+    // Many nfts share a terrier, the count queries scan its range of the index.
+    bustub->ExecuteSql("CREATE INDEX nftterrier on nft(terrier);", writer);
   } else {
     std::cerr << "x: create index disabled" << std::endl;
   }